@@ -0,0 +1,380 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-daemon/DaemonProtocol.cc
+//---------------------------------------------------------------------------//
+#include "DaemonProtocol.hh"
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace app
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Largest frame accepted, to reject garbage lengths early
+constexpr std::uint32_t max_frame_size = std::uint32_t{1} << 30;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Build a socket address for a path.
+ */
+sockaddr_un make_address(std::string const& path)
+{
+    sockaddr_un addr{};
+    addr.sun_family = AF_UNIX;
+    QIREE_VALIDATE(path.size() < sizeof(addr.sun_path),
+                   << "socket path '" << path << "' is too long");
+    std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+    return addr;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read exactly the given number of bytes, returning false at end of stream.
+ */
+bool read_all(int fd, char* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    while (offset != size)
+    {
+        ssize_t n = ::read(fd, data + offset, size - offset);
+        if (n < 0 && errno == EINTR)
+            continue;
+        QIREE_VALIDATE(n >= 0,
+                       << "failed to read from socket: "
+                       << std::strerror(errno));
+        if (n == 0)
+        {
+            QIREE_VALIDATE(offset == 0, << "socket closed mid-frame");
+            return false;
+        }
+        offset += static_cast<std::size_t>(n);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write all bytes, without raising SIGPIPE if the peer has gone away.
+ */
+void write_all(int fd, char const* data, std::size_t size)
+{
+    std::size_t offset = 0;
+    while (offset != size)
+    {
+        ssize_t n = ::send(fd, data + offset, size - offset, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR)
+            continue;
+        QIREE_VALIDATE(n >= 0,
+                       << "failed to write to socket: "
+                       << std::strerror(errno));
+        offset += static_cast<std::size_t>(n);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Interpret a boolean option value.
+ */
+bool to_bool(std::string_view key, std::string_view value)
+{
+    if (value == "1" || value == "true")
+        return true;
+    QIREE_VALIDATE(value == "0" || value == "false",
+                   << "invalid value '" << value << "' for option '" << key
+                   << "'");
+    return false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Interpret an unsigned integer option value.
+ */
+std::uint64_t to_uint(std::string_view key, std::string_view value)
+{
+    std::uint64_t result = 0;
+    auto const [end, ec]
+        = std::from_chars(value.data(), value.data() + value.size(), result);
+    QIREE_VALIDATE(ec == std::errc{} && end == value.data() + value.size()
+                       && !value.empty(),
+                   << "invalid value '" << value << "' for option '" << key
+                   << "'");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply one "key=value" option line to a request.
+ */
+void parse_option(std::string const& line, DaemonRequest* request)
+{
+    auto eq = line.find('=');
+    QIREE_VALIDATE(eq != std::string::npos,
+                   << "invalid request option '" << line << "'");
+    std::string_view key{line.data(), eq};
+    std::string value = line.substr(eq + 1);
+    if (key == "backend")
+    {
+        request->backend = value;
+    }
+    else if (key == "shots")
+    {
+        request->shots = to_uint(key, value);
+    }
+    else if (key == "seed")
+    {
+        request->seed = to_uint(key, value);
+    }
+    else if (key == "format")
+    {
+        request->output_format = to_result_format(value);
+    }
+    else if (key == "peephole")
+    {
+        request->peephole = to_bool(key, value);
+    }
+    else if (key == "virtual_swap")
+    {
+        request->virtual_swap = to_bool(key, value);
+    }
+    else if (key == "json")
+    {
+        request->json = to_bool(key, value);
+    }
+    else
+    {
+        QIREE_VALIDATE(false, << "unknown request option '" << key << "'");
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a listening Unix domain socket, replacing a stale socket file.
+ */
+int listen_unix(std::string const& path)
+{
+    auto addr = make_address(path);
+
+    // Remove a socket left behind by a previous daemon, but no other file
+    struct stat st;
+    if (::lstat(path.c_str(), &st) == 0)
+    {
+        QIREE_VALIDATE(S_ISSOCK(st.st_mode),
+                       << "'" << path << "' exists and is not a socket");
+        ::unlink(path.c_str());
+    }
+
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    QIREE_VALIDATE(fd >= 0,
+                   << "failed to create socket: " << std::strerror(errno));
+    if (::bind(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0
+        || ::listen(fd, SOMAXCONN) != 0)
+    {
+        int err = errno;
+        ::close(fd);
+        QIREE_VALIDATE(false,
+                       << "failed to listen on '" << path
+                       << "': " << std::strerror(err));
+    }
+    return fd;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Connect to a Unix domain socket.
+ */
+int connect_unix(std::string const& path)
+{
+    auto addr = make_address(path);
+    int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    QIREE_VALIDATE(fd >= 0,
+                   << "failed to create socket: " << std::strerror(errno));
+    if (::connect(fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0)
+    {
+        int err = errno;
+        ::close(fd);
+        QIREE_VALIDATE(false,
+                       << "failed to connect to '" << path
+                       << "': " << std::strerror(err));
+    }
+    return fd;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read one length-prefixed frame, returning false at end of stream.
+ */
+bool read_frame(int fd, std::string* frame)
+{
+    QIREE_EXPECT(frame);
+    std::uint32_t size{0};
+    if (!read_all(fd, reinterpret_cast<char*>(&size), sizeof(size)))
+        return false;
+    QIREE_VALIDATE(size <= max_frame_size,
+                   << "frame of " << size << " bytes is too large");
+    frame->resize(size);
+    QIREE_VALIDATE(read_all(fd, frame->data(), size),
+                   << "socket closed mid-frame");
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write one length-prefixed frame.
+ */
+void write_frame(int fd, std::string_view frame)
+{
+    QIREE_VALIDATE(frame.size() <= max_frame_size,
+                   << "frame of " << frame.size() << " bytes is too large");
+    auto size = static_cast<std::uint32_t>(frame.size());
+    write_all(fd, reinterpret_cast<char const*>(&size), sizeof(size));
+    write_all(fd, frame.data(), frame.size());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Send a request.
+ */
+void write_request(int fd, DaemonRequest const& request)
+{
+    std::ostringstream os;
+    os << "backend=" << request.backend << '\n'
+       << "shots=" << request.shots << '\n'
+       << "seed=" << request.seed << '\n'
+       << "format=" << to_cstring(request.output_format) << '\n'
+       << "peephole=" << request.peephole << '\n'
+       << "virtual_swap=" << request.virtual_swap << '\n'
+       << "json=" << request.json << '\n';
+    write_frame(fd, os.str());
+    write_frame(fd, request.module);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Receive a request, returning false at end of stream.
+ *
+ * Options that are not given keep their default values. An invalid option is
+ * recorded in the request's \c error and the remaining options are still
+ * read, so that the reply uses the requested framing. Only a truncated
+ * stream raises an exception.
+ */
+bool read_request(int fd, DaemonRequest* request)
+{
+    QIREE_EXPECT(request);
+    std::string options;
+    if (!read_frame(fd, &options))
+        return false;
+
+    DaemonRequest result;
+    QIREE_VALIDATE(read_frame(fd, &result.module),
+                   << "request is missing its module");
+
+    std::istringstream is(options);
+    std::string line;
+    while (std::getline(is, line))
+    {
+        if (line.empty())
+            continue;
+        try
+        {
+            parse_option(line, &result);
+        }
+        catch (std::exception const& e)
+        {
+            if (result.error.empty())
+            {
+                result.error = e.what();
+            }
+        }
+    }
+    *request = std::move(result);
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Send a reply in binary or JSON framing.
+ */
+void write_reply(int fd, DaemonReply const& reply, bool json)
+{
+    if (!json)
+    {
+        write_frame(fd, reply.ok ? "ok" : "error");
+        write_frame(fd, reply.output);
+        return;
+    }
+
+    std::string line = "{\"status\":";
+    line += reply.ok ? "\"ok\"" : "\"error\"";
+    line += ",\"output\":";
+    append_json_string(reply.output, &line);
+    line += "}\n";
+    write_all(fd, line.data(), line.size());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Receive a binary reply.
+ */
+DaemonReply read_reply(int fd)
+{
+    DaemonReply result;
+    std::string status;
+    QIREE_VALIDATE(read_frame(fd, &status) && read_frame(fd, &result.output),
+                   << "daemon closed the connection");
+    QIREE_VALIDATE(status == "ok" || status == "error",
+                   << "invalid reply status '" << status << "'");
+    result.ok = (status == "ok");
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Receive a JSON reply line without decoding it.
+ */
+std::string read_json_reply(int fd)
+{
+    std::string result;
+    char c = '\0';
+    while (c != '\n')
+    {
+        QIREE_VALIDATE(read_all(fd, &c, 1), << "daemon closed the connection");
+        result += c;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read a whole file.
+ */
+std::string read_file(std::string const& filename)
+{
+    std::ifstream infile(filename, std::ios::binary);
+    QIREE_VALIDATE(infile, << "failed to open '" << filename << "'");
+    std::ostringstream os;
+    os << infile.rdbuf();
+    return os.str();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
@@ -0,0 +1,98 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-daemon/DaemonProtocol.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+#include "qiree/ResultSink.hh"
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+/*!
+ * A program and its run options sent to \c qir-daemon .
+ *
+ * On the socket a request is two frames, each a 32-bit length (host byte
+ * order, since the socket is local) followed by that many bytes:
+ * - the options as "key=value" lines, with the keys \c backend , \c shots ,
+ *   \c seed , \c format , \c peephole , \c virtual_swap , and \c json ;
+ * - the QIR module, as bitcode or text IR.
+ *
+ * A connection may send any number of requests, each answered in order.
+ * Invalid options do not end the connection: \c read_request stores the
+ * first problem in \c error so that it can be answered with an error reply.
+ */
+struct DaemonRequest
+{
+    std::string backend{"sim"};  //!< "sim", "mps", or an XACC accelerator
+    size_type shots{1};
+    std::uint64_t seed{0};
+    ResultFormat output_format{ResultFormat::text};  //!< XACC result format
+    bool peephole{false};
+    bool virtual_swap{false};
+    bool json{false};  //!< Reply with a JSON line instead of frames
+    std::string module;
+    std::string error;  //!< Invalid options, if any
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reply from \c qir-daemon .
+ *
+ * The binary reply is two frames: \c "ok" or \c "error" , then the program
+ * output or error message. The JSON reply is a single line
+ * <code>{"status":"ok","output":"..."}</code> terminated by a newline.
+ */
+struct DaemonReply
+{
+    bool ok{false};
+    std::string output;
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Create a listening Unix domain socket, replacing a stale socket file
+int listen_unix(std::string const& path);
+
+// Connect to a Unix domain socket
+int connect_unix(std::string const& path);
+
+// Read one length-prefixed frame, returning false at end of stream
+bool read_frame(int fd, std::string* frame);
+
+// Write one length-prefixed frame
+void write_frame(int fd, std::string_view frame);
+
+// Send a request
+void write_request(int fd, DaemonRequest const& request);
+
+// Receive a request, returning false at end of stream
+bool read_request(int fd, DaemonRequest* request);
+
+// Send a reply in binary or JSON framing
+void write_reply(int fd, DaemonReply const& reply, bool json);
+
+// Receive a binary reply
+DaemonReply read_reply(int fd);
+
+// Receive a JSON reply line without decoding it
+std::string read_json_reply(int fd);
+
+// Read a whole file
+std::string read_file(std::string const& filename);
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
@@ -0,0 +1,170 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-daemon/qir-client.cc
+//---------------------------------------------------------------------------//
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unistd.h>
+
+#include "qiree_version.h"
+
+#include "DaemonProtocol.hh"
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Send one program to the daemon and print its output.
+ *
+ * Returns whether the daemon ran the program successfully.
+ */
+bool run(std::string const& socket_path, DaemonRequest const& request)
+{
+    int fd = connect_unix(socket_path);
+    write_request(fd, request);
+    if (request.json)
+    {
+        std::string line = read_json_reply(fd);
+        ::close(fd);
+        std::cout << line << std::flush;
+        return line.rfind("{\"status\":\"ok\"", 0) == 0;
+    }
+
+    DaemonReply reply = read_reply(fd);
+    ::close(fd);
+    if (!reply.ok)
+    {
+        std::cerr << "error: " << reply.output << std::endl;
+        return false;
+    }
+    std::cout.write(reply.output.data(), reply.output.size());
+    std::cout.flush();
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+void print_usage(std::string_view exec_name)
+{
+    // clang-format off
+    std::cerr << "usage: " << exec_name << " [options] socket input.ll backend num_shots\n"
+                 "       " << exec_name << " [--help|-h]\n"
+                 "       " << exec_name << " --version\n"
+                 "backend is 'sim', 'mps', or an XACC accelerator name\n"
+                 "options:\n"
+                 "  --output-format F   XACC result format: text, jsonl, or\n"
+                 "                      binary (default text)\n"
+                 "  --peephole          remove redundant gates before execution\n"
+                 "  --virtual-swap      relabel qubits instead of applying swaps\n"
+                 "  --seed S            random number seed\n"
+                 "  --json              print the daemon's JSON reply line\n";
+    // clang-format on
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Send a program to the daemon.
+ */
+int main(int argc, char* argv[])
+{
+    int return_code = EXIT_SUCCESS;
+
+    if (argc == 2)
+    {
+        std::string_view flag{argv[1]};
+        if (flag == "--help"sv || flag == "-h"sv)
+        {
+            qiree::app::print_usage(argv[0]);
+            return return_code;
+        }
+        else if (flag == "--version"sv || flag == "-v"sv)
+        {
+            std::cout << qiree_version << std::endl;
+            return return_code;
+        }
+    }
+
+    qiree::app::DaemonRequest request;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "--output-format"sv && i + 1 < argc)
+        {
+            try
+            {
+                request.output_format = qiree::to_result_format(argv[++i]);
+            }
+            catch (std::exception const& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--peephole"sv)
+        {
+            request.peephole = true;
+        }
+        else if (arg == "--virtual-swap"sv)
+        {
+            request.virtual_swap = true;
+        }
+        else if (arg == "--seed"sv && i + 1 < argc)
+        {
+            request.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--json"sv)
+        {
+            request.json = true;
+        }
+        else if (arg.substr(0, 2) == "--"sv)
+        {
+            std::cerr << "unknown option '" << arg << "'\n";
+            qiree::app::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.size() == 4)
+    {
+        try
+        {
+            request.module = qiree::app::read_file(positional[1]);
+            request.backend = positional[2];
+            request.shots = std::strtoull(positional[3].c_str(), nullptr, 10);
+            if (!qiree::app::run(positional[0], request))
+            {
+                return_code = EXIT_FAILURE;
+            }
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "fatal: " << e.what() << std::endl;
+            return_code = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        qiree::app::print_usage(argv[0]);
+        return_code = EXIT_FAILURE;
+    }
+
+    return return_code;
+}
@@ -0,0 +1,613 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-daemon/qir-daemon.cc
+//---------------------------------------------------------------------------//
+#include <csignal>
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "qiree_config.h"
+#include "qiree_version.h"
+
+#include "qiree/Assert.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/PeepholeOptimizer.hh"
+#include "qiree/PhiloxMath.hh"
+#include "qiree/VirtualSwap.hh"
+#include "qirsim/MpsQuantum.hh"
+#include "qirsim/SimQuantum.hh"
+
+#include "DaemonProtocol.hh"
+#if QIREE_USE_XACC
+#    include "qirxacc/XaccQuantum.hh"
+#    include "qirxacc/XaccSession.hh"
+#endif
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+//! Daemon options from the command line
+struct ServeOptions
+{
+    size_type cache_size{16};
+    std::vector<std::string> accelerators;
+    std::vector<std::string> ir_providers;
+};
+
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Set by the signal handler to stop accepting connections
+volatile std::sig_atomic_t stop_requested = 0;
+
+void request_stop(int)
+{
+    stop_requested = 1;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run QIR programs sent by clients while keeping compiled state warm.
+ *
+ * Compiled programs are kept in a least-recently-used cache keyed by the
+ * module contents, so a repeated request skips parsing and JIT compilation.
+ * XACC accelerators are created once per accelerator, shot count, output
+ * format, and seed, and reused. Modules are parsed concurrently on the
+ * connection threads, but since the executor binds the running program to
+ * global state, compilation and execution are serialized.
+ */
+class Daemon
+{
+  public:
+    //! Counters reported at shutdown
+    struct Counters
+    {
+        size_type requests{0};
+        size_type failures{0};
+        size_type cache_hits{0};
+    };
+
+  public:
+    // Construct with the number of compiled programs to keep
+    explicit Daemon(size_type cache_size) : cache_size_{cache_size} {}
+
+    // Run one request
+    DaemonReply operator()(DaemonRequest const& request);
+
+    //! Access counters
+    Counters counters() const
+    {
+        std::lock_guard<std::mutex> lock(engine_mutex_);
+        return counters_;
+    }
+
+  private:
+    using SPExecutor = std::shared_ptr<Executor>;
+    using CacheEntry = std::pair<std::string, SPExecutor>;
+
+    size_type cache_size_;
+    mutable std::mutex engine_mutex_;
+    std::list<CacheEntry> lru_;
+    std::unordered_map<std::string_view, std::list<CacheEntry>::iterator>
+        cache_;
+    Counters counters_;
+#if QIREE_USE_XACC
+    using XaccKey
+        = std::tuple<std::string, size_type, ResultFormat, std::uint64_t>;
+    std::map<XaccKey, std::unique_ptr<XaccQuantum>> accelerators_;
+#endif
+
+    SPExecutor find(std::string const& module);
+    SPExecutor insert(std::string const& module, Module&& parsed);
+    void run(Executor const& execute,
+             DaemonRequest const& request,
+             std::ostream& os);
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run one request.
+ *
+ * Failures are reported to the client rather than thrown.
+ */
+DaemonReply Daemon::operator()(DaemonRequest const& request)
+{
+    DaemonReply reply;
+    try
+    {
+        QIREE_VALIDATE(request.shots > 0,
+                       << "invalid number of shots " << request.shots);
+
+        // Parse outside the lock unless the program is already compiled
+        std::optional<Module> parsed;
+        {
+            std::lock_guard<std::mutex> lock(engine_mutex_);
+            if (!this->find(request.module))
+            {
+                parsed.emplace();
+            }
+        }
+        if (parsed)
+        {
+            *parsed = Module::from_buffer(request.module, "request");
+        }
+
+        std::ostringstream os;
+        std::lock_guard<std::mutex> lock(engine_mutex_);
+        ++counters_.requests;
+        SPExecutor executor = parsed
+                                  ? this->insert(request.module,
+                                                 std::move(*parsed))
+                                  : this->find(request.module);
+        if (!parsed)
+        {
+            ++counters_.cache_hits;
+        }
+        try
+        {
+            this->run(*executor, request, os);
+        }
+        catch (...)
+        {
+            ++counters_.failures;
+            throw;
+        }
+        reply.ok = true;
+        reply.output = os.str();
+    }
+    catch (std::exception const& e)
+    {
+        reply.ok = false;
+        reply.output = e.what();
+    }
+    return reply;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Find a compiled program and mark it as recently used.
+ */
+auto Daemon::find(std::string const& module) -> SPExecutor
+{
+    auto iter = cache_.find(module);
+    if (iter == cache_.end())
+        return nullptr;
+    lru_.splice(lru_.begin(), lru_, iter->second);
+    return iter->second->second;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compile a parsed program and cache it, evicting the least recently used.
+ *
+ * Another connection may have compiled the same program in the meantime, in
+ * which case the cached one is used.
+ */
+auto Daemon::insert(std::string const& module, Module&& parsed) -> SPExecutor
+{
+    if (auto existing = this->find(module))
+        return existing;
+
+    auto executor = std::make_shared<Executor>(std::move(parsed));
+    if (cache_size_ == 0)
+        return executor;
+
+    lru_.emplace_front(module, executor);
+    cache_.emplace(lru_.front().first, lru_.begin());
+    if (lru_.size() > cache_size_)
+    {
+        cache_.erase(lru_.back().first);
+        lru_.pop_back();
+    }
+    return executor;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute a compiled program on the requested backend.
+ */
+void Daemon::run(Executor const& execute,
+                 DaemonRequest const& request,
+                 std::ostream& os)
+{
+    // Decorate the backend and run until it has no shots remaining
+    auto run_shots = [&](QuantumInterface& sim,
+                         RuntimeInterface& rt,
+                         auto&& remaining_shots) {
+        QuantumInterface* quantum = &sim;
+        std::optional<PeepholeOptimizer> peephole;
+        if (request.peephole)
+        {
+            peephole.emplace(*quantum);
+            quantum = &*peephole;
+        }
+        std::optional<VirtualSwap> vswap;
+        if (request.virtual_swap)
+        {
+            vswap.emplace(*quantum);
+            quantum = &*vswap;
+        }
+
+        // Key random draws by the index of the first shot in each execution
+        PhiloxMath math(request.seed);
+        size_type const num_shots = remaining_shots();
+        do
+        {
+            math.start_shot(num_shots - remaining_shots());
+            execute(*quantum, rt, math);
+        } while (remaining_shots() > 0);
+    };
+
+    // Shots that share an execution would share its random draws
+    bool const share_shots = !execute.draws_random_numbers();
+
+    if (request.backend == "sim"sv)
+    {
+        SimQuantum::Options opts;
+        opts.shots = request.shots;
+        opts.seed = request.seed;
+        opts.sample_final_state = share_shots;
+        opts.branch_shots = share_shots;
+        SimQuantum sim(os, opts);
+        run_shots(sim, sim, [&sim] { return sim.remaining_shots(); });
+        return;
+    }
+    if (request.backend == "mps"sv)
+    {
+        MpsQuantum::Options opts;
+        opts.shots = request.shots;
+        opts.seed = request.seed;
+        opts.sample_final_state = share_shots;
+        MpsQuantum sim(os, opts);
+        run_shots(sim, sim, [&sim] { return sim.remaining_shots(); });
+        return;
+    }
+#if QIREE_USE_XACC
+    // The instance keeps the options it was created with
+    auto& xacc = accelerators_[{request.backend,
+                                request.shots,
+                                request.output_format,
+                                request.seed}];
+    if (!xacc)
+    {
+        XaccQuantum::Options opts;
+        opts.shots = request.shots;
+        opts.output_format = request.output_format;
+        opts.seed = request.seed;
+        xacc = std::make_unique<XaccQuantum>(os, request.backend, opts);
+    }
+    xacc->set_output(os);
+    try
+    {
+        // Every shot runs on the accelerator from a single execution
+        run_shots(*xacc, *xacc, [] { return size_type{0}; });
+    }
+    catch (...)
+    {
+        xacc->set_output(std::cout);
+        throw;
+    }
+    xacc->set_output(std::cout);
+#else
+    QIREE_VALIDATE(false,
+                   << "unknown backend '" << request.backend
+                   << "' (expected sim or mps; XACC is disabled)");
+#endif
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Accept connections and serve each on its own thread.
+ */
+class Server
+{
+  public:
+    // Construct with the number of compiled programs to keep
+    explicit Server(size_type cache_size) : daemon_{cache_size} {}
+
+    // Accept connections until a stop is requested
+    void operator()(int listen_fd);
+
+    //!@{
+    //! \name Accessors
+    Daemon const& daemon() const { return daemon_; }
+    size_type num_connections() const { return num_connections_; }
+    //!@}
+
+  private:
+    Daemon daemon_;
+    size_type num_connections_{0};
+    std::mutex fd_mutex_;
+    std::set<int> open_fds_;
+    std::map<std::thread::id, std::thread> threads_;
+    std::vector<std::thread::id> finished_;
+
+    void serve_connection(int fd);
+    void join_finished();
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Accept connections until a stop is requested.
+ *
+ * Connection threads do not receive SIGINT or SIGTERM, so the signal always
+ * interrupts \c accept here. Threads of closed connections are joined as new
+ * connections arrive; at shutdown, open connections are shut down and all
+ * remaining threads joined.
+ */
+void Server::operator()(int listen_fd)
+{
+    sigset_t stop_signals;
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+
+    while (!stop_requested)
+    {
+        int fd = ::accept(listen_fd, nullptr, nullptr);
+        if (fd < 0)
+            continue;
+
+        this->join_finished();
+
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        open_fds_.insert(fd);
+        sigset_t old_mask;
+        pthread_sigmask(SIG_BLOCK, &stop_signals, &old_mask);
+        std::thread t(&Server::serve_connection, this, fd);
+        pthread_sigmask(SIG_SETMASK, &old_mask, nullptr);
+        auto id = t.get_id();
+        threads_.emplace(id, std::move(t));
+        ++num_connections_;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        for (int fd : open_fds_)
+        {
+            ::shutdown(fd, SHUT_RDWR);
+        }
+    }
+    for (auto& id_thread : threads_)
+    {
+        id_thread.second.join();
+    }
+    threads_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Join the threads of connections that have closed.
+ *
+ * A finished thread has released the lock and is only returning, so the
+ * joins are immediate.
+ */
+void Server::join_finished()
+{
+    std::vector<std::thread> finished;
+    {
+        std::lock_guard<std::mutex> lock(fd_mutex_);
+        for (auto id : finished_)
+        {
+            auto iter = threads_.find(id);
+            QIREE_ASSERT(iter != threads_.end());
+            finished.push_back(std::move(iter->second));
+            threads_.erase(iter);
+        }
+        finished_.clear();
+    }
+    for (auto& t : finished)
+    {
+        t.join();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Answer requests on one connection until the client closes it.
+ */
+void Server::serve_connection(int fd)
+{
+    try
+    {
+        DaemonRequest request;
+        while (read_request(fd, &request))
+        {
+            if (!request.error.empty())
+            {
+                // Invalid options: the frames were read, so keep going
+                write_reply(fd, {false, request.error}, request.json);
+                continue;
+            }
+            write_reply(fd, daemon_(request), request.json);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        // A broken frame leaves the stream unusable: report and close
+        std::cerr << "qir-daemon: dropping connection: " << e.what()
+                  << std::endl;
+    }
+
+    std::lock_guard<std::mutex> lock(fd_mutex_);
+    open_fds_.erase(fd);
+    ::close(fd);
+    finished_.push_back(std::this_thread::get_id());
+}
+
+//---------------------------------------------------------------------------//
+void serve(std::string const& path, ServeOptions const& opts)
+{
+#if QIREE_USE_XACC
+    if (!opts.accelerators.empty() || !opts.ir_providers.empty())
+    {
+        // Load only the named plugins, in the background while listening
+        XaccSession::instance().start(
+            {}, XaccSession::Plugins{opts.accelerators, opts.ir_providers});
+    }
+#else
+    QIREE_VALIDATE(opts.accelerators.empty() && opts.ir_providers.empty(),
+                   << "XACC plugins were requested but XACC is disabled");
+#endif
+
+    int listen_fd = listen_unix(path);
+    std::cerr << "qir-daemon: listening on " << path << std::endl;
+
+    // Stop on SIGINT/SIGTERM: interrupt accept rather than restarting it
+    struct sigaction action{};
+    action.sa_handler = request_stop;
+    sigemptyset(&action.sa_mask);
+    action.sa_flags = 0;
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+
+    Server server(opts.cache_size);
+    server(listen_fd);
+
+    ::close(listen_fd);
+    ::unlink(path.c_str());
+
+    auto const counters = server.daemon().counters();
+    std::cerr << "qir-daemon: served " << counters.requests
+              << " requests on " << server.num_connections()
+              << " connections (" << counters.cache_hits << " cache hits, "
+              << counters.failures << " failures)" << std::endl;
+}
+
+//---------------------------------------------------------------------------//
+//! Split a comma-separated list of names
+std::vector<std::string> split_names(std::string_view list)
+{
+    std::vector<std::string> result;
+    while (!list.empty())
+    {
+        auto comma = list.find(',');
+        auto name = list.substr(0, comma);
+        if (!name.empty())
+        {
+            result.emplace_back(name);
+        }
+        list.remove_prefix(comma == list.npos ? list.size() : comma + 1);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+void print_usage(std::string_view exec_name)
+{
+    // clang-format off
+    std::cerr << "usage: " << exec_name << " [options] socket\n"
+                 "       " << exec_name << " [--help|-h]\n"
+                 "       " << exec_name << " --version\n"
+                 "options:\n"
+                 "  --cache N           compiled programs kept warm (default 16)\n"
+                 "  --accelerators A,B  load XACC at startup with only these\n"
+                 "                      accelerators; others are rejected\n"
+                 "  --ir-providers P,Q  likewise for XACC IR providers\n";
+    // clang-format on
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Serve requests until interrupted.
+ */
+int main(int argc, char* argv[])
+{
+    int return_code = EXIT_SUCCESS;
+
+    if (argc == 2)
+    {
+        std::string_view flag{argv[1]};
+        if (flag == "--help"sv || flag == "-h"sv)
+        {
+            qiree::app::print_usage(argv[0]);
+            return return_code;
+        }
+        else if (flag == "--version"sv || flag == "-v"sv)
+        {
+            std::cout << qiree_version << std::endl;
+            return return_code;
+        }
+    }
+
+    qiree::app::ServeOptions opts;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "--cache"sv && i + 1 < argc)
+        {
+            opts.cache_size = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--accelerators"sv && i + 1 < argc)
+        {
+            opts.accelerators = qiree::app::split_names(argv[++i]);
+        }
+        else if (arg == "--ir-providers"sv && i + 1 < argc)
+        {
+            opts.ir_providers = qiree::app::split_names(argv[++i]);
+        }
+        else if (arg.substr(0, 2) == "--"sv)
+        {
+            std::cerr << "unknown option '" << arg << "'\n";
+            qiree::app::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.size() == 1)
+    {
+        try
+        {
+            qiree::app::serve(positional[0], opts);
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "fatal: " << e.what() << std::endl;
+            return_code = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        qiree::app::print_usage(argv[0]);
+        return_code = EXIT_FAILURE;
+    }
+
+    return return_code;
+}
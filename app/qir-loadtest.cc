@@ -0,0 +1,249 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-daemon/qir-loadtest.cc
+//---------------------------------------------------------------------------//
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+#include "qiree_version.h"
+
+#include "DaemonProtocol.hh"
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+//! Load options from the command line
+struct LoadOptions
+{
+    size_type num_requests{100};
+    size_type num_connections{4};
+};
+
+//---------------------------------------------------------------------------//
+//! Latencies and failures seen by one connection
+struct ConnectionResult
+{
+    std::vector<double> latencies;  //!< [ms]
+    size_type failures{0};
+    std::string error;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Send requests back to back on one connection, timing each.
+ */
+ConnectionResult run_connection(std::string const& socket_path,
+                                 DaemonRequest const& request,
+                                 size_type num_requests)
+{
+    using Clock = std::chrono::steady_clock;
+
+    ConnectionResult result;
+    result.latencies.reserve(num_requests);
+    try
+    {
+        int fd = connect_unix(socket_path);
+        for (size_type i = 0; i != num_requests; ++i)
+        {
+            auto start = Clock::now();
+            write_request(fd, request);
+            DaemonReply reply = read_reply(fd);
+            std::chrono::duration<double, std::milli> elapsed = Clock::now()
+                                                                - start;
+            result.latencies.push_back(elapsed.count());
+            if (!reply.ok)
+            {
+                ++result.failures;
+                result.error = reply.output;
+            }
+        }
+        ::close(fd);
+    }
+    catch (std::exception const& e)
+    {
+        result.error = e.what();
+        result.failures += num_requests - result.latencies.size();
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Send the same program over several concurrent connections and report
+ * throughput and latency percentiles.
+ *
+ * Each connection sends its share of the requests one after another, so the
+ * number of requests in flight equals the number of connections.
+ */
+bool run(std::string const& socket_path,
+         DaemonRequest const& request,
+         LoadOptions const& load)
+{
+    using Clock = std::chrono::steady_clock;
+
+    size_type const num_connections
+        = std::max<size_type>(1, std::min(load.num_connections,
+                                          load.num_requests));
+    std::vector<ConnectionResult> results(num_connections);
+    std::vector<std::thread> threads;
+    threads.reserve(num_connections);
+
+    auto start = Clock::now();
+    for (size_type c = 0; c != num_connections; ++c)
+    {
+        size_type n = load.num_requests / num_connections
+                      + (c < load.num_requests % num_connections ? 1 : 0);
+        threads.emplace_back([&, c, n] {
+            results[c] = run_connection(socket_path, request, n);
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    std::chrono::duration<double> wall = Clock::now() - start;
+
+    std::vector<double> latencies;
+    size_type failures = 0;
+    for (auto const& r : results)
+    {
+        latencies.insert(
+            latencies.end(), r.latencies.begin(), r.latencies.end());
+        failures += r.failures;
+        if (!r.error.empty())
+        {
+            std::cerr << "error: " << r.error << std::endl;
+        }
+    }
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](double p) {
+        if (latencies.empty())
+            return 0.0;
+        auto i = static_cast<size_type>(p * (latencies.size() - 1) + 0.5);
+        return latencies[i];
+    };
+
+    std::cout << std::fixed << std::setprecision(3)
+              << "requests:    " << latencies.size() << " (" << failures
+              << " failed) on " << num_connections << " connections\n"
+              << "wall time:   " << wall.count() << " s\n"
+              << "throughput:  " << latencies.size() / wall.count()
+              << " requests/s\n"
+              << "latency ms:  min " << percentile(0) << ", p50 "
+              << percentile(0.5) << ", p90 " << percentile(0.9) << ", p99 "
+              << percentile(0.99) << ", max " << percentile(1) << std::endl;
+    return failures == 0;
+}
+
+//---------------------------------------------------------------------------//
+void print_usage(std::string_view exec_name)
+{
+    // clang-format off
+    std::cerr << "usage: " << exec_name << " [options] socket input.ll backend num_shots\n"
+                 "       " << exec_name << " [--help|-h]\n"
+                 "       " << exec_name << " --version\n"
+                 "options:\n"
+                 "  --requests N        total requests to send (default 100)\n"
+                 "  --connections K     concurrent connections (default 4)\n"
+                 "  --seed S            random number seed\n";
+    // clang-format on
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Load-test a running daemon.
+ */
+int main(int argc, char* argv[])
+{
+    int return_code = EXIT_SUCCESS;
+
+    if (argc == 2)
+    {
+        std::string_view flag{argv[1]};
+        if (flag == "--help"sv || flag == "-h"sv)
+        {
+            qiree::app::print_usage(argv[0]);
+            return return_code;
+        }
+        else if (flag == "--version"sv || flag == "-v"sv)
+        {
+            std::cout << qiree_version << std::endl;
+            return return_code;
+        }
+    }
+
+    qiree::app::DaemonRequest request;
+    qiree::app::LoadOptions load;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "--requests"sv && i + 1 < argc)
+        {
+            load.num_requests = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--connections"sv && i + 1 < argc)
+        {
+            load.num_connections = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--seed"sv && i + 1 < argc)
+        {
+            request.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg.substr(0, 2) == "--"sv)
+        {
+            std::cerr << "unknown option '" << arg << "'\n";
+            qiree::app::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.size() == 4)
+    {
+        try
+        {
+            request.module = qiree::app::read_file(positional[1]);
+            request.backend = positional[2];
+            request.shots = std::strtoull(positional[3].c_str(), nullptr, 10);
+            if (!qiree::app::run(positional[0], request, load))
+            {
+                return_code = EXIT_FAILURE;
+            }
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "fatal: " << e.what() << std::endl;
+            return_code = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        qiree::app::print_usage(argv[0]);
+        return_code = EXIT_FAILURE;
+    }
+
+    return return_code;
+}
@@ -0,0 +1,235 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qir-sim/qir-sim.cc
+//---------------------------------------------------------------------------//
+#include <cstdlib>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "qiree_version.h"
+
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/PeepholeOptimizer.hh"
+#include "qiree/PhiloxMath.hh"
+#include "qiree/VirtualSwap.hh"
+#include "qirsim/MpsQuantum.hh"
+#include "qirsim/SimQuantum.hh"
+
+using namespace std::string_view_literals;
+
+namespace qiree
+{
+namespace app
+{
+//---------------------------------------------------------------------------//
+//! Backend selection and options from the command line
+struct RunOptions
+{
+    bool mps{false};
+    size_type max_bond{64};
+    double truncation{1e-12};
+    bool peephole{false};
+    bool virtual_swap{false};
+};
+
+//---------------------------------------------------------------------------//
+template<class S>
+void run_shots(Executor const& execute,
+               S& sim,
+               size_type seed,
+               RunOptions const& run_opts)
+{
+    // Insert optional decorators between the executor and the simulator
+    QuantumInterface* quantum = &sim;
+    std::optional<PeepholeOptimizer> peephole;
+    if (run_opts.peephole)
+    {
+        peephole.emplace(*quantum);
+        quantum = &*peephole;
+    }
+    std::optional<VirtualSwap> vswap;
+    if (run_opts.virtual_swap)
+    {
+        vswap.emplace(*quantum);
+        quantum = &*vswap;
+    }
+
+    // Key random draws by the index of the first shot in each execution
+    PhiloxMath math(seed);
+    size_type const num_shots = sim.remaining_shots();
+    while (sim.remaining_shots() > 0)
+    {
+        math.start_shot(num_shots - sim.remaining_shots());
+        execute(*quantum, sim, math);
+    }
+
+    if (peephole)
+    {
+        std::cerr << "Peephole optimizer removed "
+                  << peephole->counters().removed << " of "
+                  << peephole->counters().gates << " gates" << std::endl;
+    }
+    if (vswap)
+    {
+        std::cerr << "Relabeled " << vswap->counters().relabeled
+                  << " swaps" << std::endl;
+    }
+}
+
+//---------------------------------------------------------------------------//
+void run(std::string const& filename,
+         int num_shots,
+         int seed,
+         RunOptions const& run_opts)
+{
+    // Load the input
+    Executor execute{Module{filename}};
+
+    // Shots that share an execution would share its random draws, so a
+    // program that draws random numbers is run one shot at a time
+    bool const share_shots = !execute.draws_random_numbers();
+
+    if (!run_opts.mps)
+    {
+        // Set up the state vector simulator and run every shot
+        SimQuantum::Options opts;
+        opts.shots = num_shots;
+        opts.seed = seed;
+        opts.sample_final_state = share_shots;
+        opts.branch_shots = share_shots;
+        SimQuantum sim(std::cout, opts);
+        run_shots(execute, sim, seed, run_opts);
+        return;
+    }
+
+    // Set up the matrix product state simulator and run every shot
+    MpsQuantum::Options opts;
+    opts.shots = num_shots;
+    opts.seed = seed;
+    opts.max_bond = run_opts.max_bond;
+    opts.truncation_threshold = run_opts.truncation;
+    opts.sample_final_state = share_shots;
+    MpsQuantum sim(std::cout, opts);
+    run_shots(execute, sim, seed, run_opts);
+
+    std::cerr << "MPS max bond dimension " << sim.max_bond_dimension()
+              << ", truncation error " << sim.truncation_error() << std::endl;
+}
+
+//---------------------------------------------------------------------------//
+void print_usage(std::string_view exec_name)
+{
+    // clang-format off
+    std::cerr << "usage: " << exec_name << " [options] input.ll num_shots [seed]\n"
+                 "       " << exec_name << " [--help|-h]\n"
+                 "       " << exec_name << " --version\n"
+                 "options:\n"
+                 "  --mps               use the matrix product state backend\n"
+                 "  --max-bond N        maximum MPS bond dimension (default 64)\n"
+                 "  --truncation X      discarded weight per MPS truncation\n"
+                 "                      (default 1e-12)\n"
+                 "  --peephole          remove redundant gates before simulating\n"
+                 "  --virtual-swap      relabel qubits instead of applying swaps\n";
+    // clang-format on
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace app
+}  // namespace qiree
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute and run.
+ */
+int main(int argc, char* argv[])
+{
+    // Process input arguments
+    int return_code = EXIT_SUCCESS;
+
+    if (argc == 2)
+    {
+        std::string_view flag{argv[1]};
+        if (flag == "--help"sv || flag == "-h"sv)
+        {
+            qiree::app::print_usage(argv[0]);
+            return return_code;
+        }
+        else if (flag == "--version"sv || flag == "-v"sv)
+        {
+            std::cout << qiree_version << std::endl;
+            return return_code;
+        }
+    }
+
+    qiree::app::RunOptions run_opts;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "--mps"sv)
+        {
+            run_opts.mps = true;
+        }
+        else if (arg == "--max-bond"sv && i + 1 < argc)
+        {
+            run_opts.mps = true;
+            run_opts.max_bond = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--truncation"sv && i + 1 < argc)
+        {
+            run_opts.mps = true;
+            run_opts.truncation = std::strtod(argv[++i], nullptr);
+        }
+        else if (arg == "--peephole"sv)
+        {
+            run_opts.peephole = true;
+        }
+        else if (arg == "--virtual-swap"sv)
+        {
+            run_opts.virtual_swap = true;
+        }
+        else if (arg.substr(0, 2) == "--"sv)
+        {
+            std::cerr << "unknown option '" << arg << "'\n";
+            qiree::app::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (positional.size() == 2 || positional.size() == 3)
+    {
+        std::string const& filename = positional[0];
+        try
+        {
+            qiree::app::run(
+                filename,
+                std::atoi(positional[1].c_str()),
+                positional.size() == 3 ? std::atoi(positional[2].c_str()) : 0,
+                run_opts);
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "fatal: while running input at " << filename << ":\n"
+                      << e.what() << std::endl;
+            return_code = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        qiree::app::print_usage(argv[0]);
+        return_code = EXIT_FAILURE;
+    }
+
+    return return_code;
+}
@@ -5,17 +5,34 @@
 //---------------------------------------------------------------------------//
 //! \file qir-xacc/qir-xacc.cc
 //---------------------------------------------------------------------------//
+#include <chrono>
+#include <cstdint>
 #include <cstdlib>
+#include <fstream>
+#include <future>
 #include <iostream>
+#include <map>
+#include <memory>
+#include <optional>
+#include <sstream>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <set>
+#include <vector>
 
 #include "qiree_version.h"
 
+#include "qiree/Assert.hh"
 #include "qiree/Executor.hh"
 #include "qiree/Module.hh"
+#include "qiree/PeepholeOptimizer.hh"
+#include "qiree/PhiloxMath.hh"
 #include "qiree/QuantumNotImpl.hh"
+#include "qiree/ResultSink.hh"
+#include "qiree/VirtualSwap.hh"
 #include "qirxacc/XaccQuantum.hh"
+#include "qirxacc/XaccSession.hh"
 
 using namespace std::string_view_literals;
 
@@ -23,28 +40,316 @@ namespace qiree
 {
 namespace app
 {
+//---------------------------------------------------------------------------//
+//! Output options from the command line
+struct RunOptions
+{
+    ResultFormat output_format{ResultFormat::text};
+    bool per_shot{false};
+    bool peephole{false};
+    bool virtual_swap{false};
+    size_type num_workers{1};
+    size_type batch_size{1};
+    std::uint64_t seed{0};
+    bool serial_startup{false};
+    bool startup_timing{false};
+};
+
+//---------------------------------------------------------------------------//
+//! Print the elapsed time at each startup stage if requested
+class StartupTimer
+{
+  public:
+    explicit StartupTimer(bool enabled)
+        : enabled_{enabled}, start_{Clock::now()}
+    {
+    }
+
+    void operator()(char const* stage) const
+    {
+        if (!enabled_)
+            return;
+        std::chrono::duration<double, std::milli> elapsed = Clock::now()
+                                                            - start_;
+        std::cerr << "startup: " << stage << " after " << elapsed.count()
+                  << " ms" << std::endl;
+    }
+
+  private:
+    using Clock = std::chrono::steady_clock;
+
+    bool enabled_;
+    Clock::time_point start_;
+};
+
+//---------------------------------------------------------------------------//
+//! One line of a batch job list
+struct BatchJob
+{
+    std::string input;
+    std::string accelerator;
+    size_type shots{0};
+    std::string output;
+};
+
+//---------------------------------------------------------------------------//
+XaccQuantum::Options make_options(size_type num_shots,
+                                  RunOptions const& run_opts)
+{
+    XaccQuantum::Options opts;
+    opts.shots = num_shots;
+    opts.output_format = run_opts.output_format;
+    opts.per_shot = run_opts.per_shot;
+    opts.num_workers = run_opts.num_workers;
+    opts.batch_size = run_opts.batch_size;
+    opts.seed = run_opts.seed;
+    return opts;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Start XACC with only the plugins this run needs.
+ *
+ * By default XACC loads its plugins on a background thread while the input
+ * is parsed and compiled; with \c serial_startup it is initialized first.
+ */
+void start_xacc(std::vector<std::string> accelerators,
+                RunOptions const& run_opts)
+{
+    XaccSession::Plugins plugins;
+    plugins.accelerators = std::move(accelerators);
+    plugins.ir_providers = {"quantum"};
+    if (run_opts.serial_startup)
+    {
+        XaccQuantum::xacc_init({}, std::move(plugins));
+    }
+    else
+    {
+        XaccSession::instance().start({}, std::move(plugins));
+    }
+}
+
+//---------------------------------------------------------------------------//
+void execute_with(Executor const& execute,
+                  XaccQuantum& xacc,
+                  RunOptions const& run_opts)
+{
+    // Insert optional decorators between the executor and XACC
+    QuantumInterface* quantum = &xacc;
+    std::optional<PeepholeOptimizer> peephole;
+    if (run_opts.peephole)
+    {
+        peephole.emplace(*quantum);
+        quantum = &*peephole;
+    }
+    std::optional<VirtualSwap> vswap;
+    if (run_opts.virtual_swap)
+    {
+        vswap.emplace(*quantum);
+        quantum = &*vswap;
+    }
+
+    // Run: the circuit is built once for every shot, so any random numbers
+    // it draws are shared by all shots
+    PhiloxMath math(run_opts.seed);
+    execute(*quantum, xacc, math);
+
+    if (peephole)
+    {
+        std::cerr << "Peephole optimizer removed "
+                  << peephole->counters().removed << " of "
+                  << peephole->counters().gates << " gates" << std::endl;
+    }
+    if (vswap)
+    {
+        std::cerr << "Relabeled " << vswap->counters().relabeled
+                  << " swaps" << std::endl;
+    }
+}
+
 //---------------------------------------------------------------------------//
 void run(std::string const& filename,
          std::string const& accel_name,
-         int num_shots)
+         int num_shots,
+         RunOptions const& run_opts)
 {
+    StartupTimer timer{run_opts.startup_timing};
+    start_xacc({accel_name}, run_opts);
+    timer("XACC started");
+
     // Load the input
     Executor execute{Module{filename}};
+    timer("input compiled");
 
     // Set up XACC
-    XaccQuantum xacc(std::cout, accel_name, num_shots);
+    XaccSession::instance().wait();
+    timer("XACC initialized");
+    XaccQuantum xacc(std::cout, accel_name, make_options(num_shots, run_opts));
+
+    execute_with(execute, xacc, run_opts);
+    xacc.flush();
+    timer("executed");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read a job list: one "input accelerator shots output" job per line.
+ *
+ * Blank lines and lines starting with '#' are ignored. An output of "-"
+ * writes to standard output.
+ */
+std::vector<BatchJob> read_jobs(std::string const& filename)
+{
+    std::ifstream infile(filename);
+    QIREE_VALIDATE(infile, << "failed to open job list at '" << filename
+                           << "'");
+
+    std::vector<BatchJob> result;
+    std::string line;
+    for (size_type lineno = 1; std::getline(infile, line); ++lineno)
+    {
+        std::istringstream is(line);
+        BatchJob job;
+        if (!(is >> job.input) || job.input.front() == '#')
+            continue;
+        is >> job.accelerator >> job.shots >> job.output;
+        QIREE_VALIDATE(is && job.shots > 0,
+                       << "invalid job at " << filename << ":" << lineno
+                       << ": expected 'input accelerator shots output'");
+        result.push_back(std::move(job));
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run every job in a list, returning the number that failed.
+ *
+ * XACC is initialized once, with the accelerators named in the job list, and
+ * one \c XaccQuantum (with its accelerators
+ * and circuit cache) is kept for each accelerator and shot count, so only
+ * the first job that uses them pays for their creation. The next job's
+ * module is parsed on a separate thread while the current one executes.
+ * With a batch size, consecutive jobs that write to standard output share
+ * accelerator calls; jobs with their own output file are flushed on
+ * completion. A failed job is reported and the remaining jobs still run.
+ */
+size_type run_batch(std::string const& filename, RunOptions const& run_opts)
+{
+    auto jobs = read_jobs(filename);
+    std::set<std::string> accelerators;
+    for (auto const& job : jobs)
+    {
+        accelerators.insert(job.accelerator);
+    }
+    start_xacc({accelerators.begin(), accelerators.end()}, run_opts);
+
+    auto load = [](std::string const& input) {
+        return std::async(std::launch::async,
+                          [input] { return Module{input}; });
+    };
+
+    std::map<std::pair<std::string, size_type>, std::unique_ptr<XaccQuantum>>
+        backends;
+    std::future<Module> next;
+    if (!jobs.empty())
+    {
+        next = load(jobs.front().input);
+    }
+
+    size_type num_failed = 0;
+    for (size_type i = 0; i != jobs.size(); ++i)
+    {
+        BatchJob const& job = jobs[i];
+        auto current = std::move(next);
+        if (i + 1 != jobs.size())
+        {
+            next = load(jobs[i + 1].input);
+        }
+
+        XaccQuantum* xacc = nullptr;
+        std::ofstream outfile;
+        try
+        {
+            Executor execute{current.get()};
+
+            if (job.output != "-"sv)
+            {
+                outfile.open(job.output);
+                QIREE_VALIDATE(outfile,
+                               << "failed to open output at '" << job.output
+                               << "'");
+            }
+
+            auto& backend = backends[{job.accelerator, job.shots}];
+            if (!backend)
+            {
+                backend = std::make_unique<XaccQuantum>(
+                    std::cout,
+                    job.accelerator,
+                    make_options(job.shots, run_opts));
+            }
+            xacc = backend.get();
+            if (outfile.is_open())
+            {
+                // Executions queued for standard output are written first
+                xacc->flush();
+                xacc->set_output(outfile);
+            }
+
+            execute_with(execute, *xacc, run_opts);
+            if (outfile.is_open())
+            {
+                xacc->flush();
+                xacc->set_output(std::cout);
+            }
+        }
+        catch (std::exception const& e)
+        {
+            if (xacc && outfile.is_open())
+            {
+                xacc->flush();
+                xacc->set_output(std::cout);
+            }
+            std::cerr << "error: while running job " << i + 1 << " ("
+                      << job.input << "):\n"
+                      << e.what() << std::endl;
+            ++num_failed;
+        }
+    }
 
-    // Run
-    execute(xacc, xacc);
+    // Run executions still queued for standard output
+    for (auto& [key, backend] : backends)
+    {
+        backend->flush();
+    }
+    return num_failed;
 }
 
 //---------------------------------------------------------------------------//
 void print_usage(std::string_view exec_name)
 {
     // clang-format off
-    std::cerr << "usage: " << exec_name << " input.ll accelerator num_shots\n"
+    std::cerr << "usage: " << exec_name << " [options] input.ll accelerator num_shots\n"
+                 "       " << exec_name << " [options] --batch jobs.txt\n"
                  "       " << exec_name << " [--help|-h]\n"
-                 "       " << exec_name << " --version\n";
+                 "       " << exec_name << " --version\n"
+                 "options:\n"
+                 "  --output-format F   result format: text, jsonl, or binary\n"
+                 "                      (default text)\n"
+                 "  --per-shot          also write bit-packed per-shot records\n"
+                 "  --peephole          remove redundant gates before execution\n"
+                 "  --virtual-swap      relabel qubits instead of applying swaps\n"
+                 "  --workers K         split shots across K accelerator threads\n"
+                 "  --seed S            seed for the worker accelerators\n"
+                 "  --batch-size N      submit up to N executions per accelerator\n"
+                 "                      call (default 1)\n"
+                 "  --batch FILE        run every job listed in FILE, one\n"
+                 "                      'input accelerator shots output' per line\n"
+                 "                      (output '-' is stdout), in one process\n"
+                 "  --serial-startup    initialize XACC before loading the input\n"
+                 "                      rather than in the background\n"
+                 "  --startup-timing    print the time to reach each startup stage\n";
     // clang-format on
 }
 
@@ -58,10 +363,6 @@ void print_usage(std::string_view exec_name)
  */
 int main(int argc, char* argv[])
 {
-    using std::cerr;
-    using std::cout;
-    using std::endl;
-
     // Process input arguments
     int return_code = EXIT_SUCCESS;
 
@@ -71,18 +372,107 @@ int main(int argc, char* argv[])
         if (flag == "--help"sv || flag == "-h"sv)
         {
             qiree::app::print_usage(argv[0]);
+            return return_code;
         }
         else if (flag == "--version"sv || flag == "-v"sv)
         {
             std::cout << qiree_version << std::endl;
+            return return_code;
+        }
+    }
+
+    qiree::app::RunOptions run_opts;
+    std::string batch_filename;
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string_view arg{argv[i]};
+        if (arg == "--output-format"sv && i + 1 < argc)
+        {
+            try
+            {
+                run_opts.output_format = qiree::to_result_format(argv[++i]);
+            }
+            catch (std::exception const& e)
+            {
+                std::cerr << e.what() << std::endl;
+                return EXIT_FAILURE;
+            }
+        }
+        else if (arg == "--per-shot"sv)
+        {
+            run_opts.per_shot = true;
+        }
+        else if (arg == "--peephole"sv)
+        {
+            run_opts.peephole = true;
+        }
+        else if (arg == "--virtual-swap"sv)
+        {
+            run_opts.virtual_swap = true;
+        }
+        else if (arg == "--workers"sv && i + 1 < argc)
+        {
+            run_opts.num_workers = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--batch-size"sv && i + 1 < argc)
+        {
+            run_opts.batch_size = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--seed"sv && i + 1 < argc)
+        {
+            run_opts.seed = std::strtoull(argv[++i], nullptr, 10);
+        }
+        else if (arg == "--serial-startup"sv)
+        {
+            run_opts.serial_startup = true;
+        }
+        else if (arg == "--startup-timing"sv)
+        {
+            run_opts.startup_timing = true;
+        }
+        else if (arg == "--batch"sv && i + 1 < argc)
+        {
+            batch_filename = argv[++i];
+        }
+        else if (arg.substr(0, 2) == "--"sv)
+        {
+            std::cerr << "unknown option '" << arg << "'\n";
+            qiree::app::print_usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+        else
+        {
+            positional.emplace_back(arg);
+        }
+    }
+
+    if (!batch_filename.empty() && positional.empty())
+    {
+        try
+        {
+            if (qiree::app::run_batch(batch_filename, run_opts) > 0)
+            {
+                return_code = EXIT_FAILURE;
+            }
+        }
+        catch (std::exception const& e)
+        {
+            std::cerr << "fatal: while running batch at " << batch_filename
+                      << ":\n"
+                      << e.what() << std::endl;
+            return_code = EXIT_FAILURE;
         }
     }
-    else if (argc == 4)
+    else if (batch_filename.empty() && positional.size() == 3)
     {
-        std::string filename{argv[1]};
+        std::string const& filename = positional[0];
         try
         {
-            qiree::app::run(filename, argv[2], std::atoi(argv[3]));
+            qiree::app::run(filename,
+                            positional[1],
+                            std::atoi(positional[2].c_str()),
+                            run_opts);
         }
         catch (std::exception const& e)
         {
@@ -0,0 +1,96 @@
+#!/usr/bin/env python3
+# Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+# See the top-level COPYRIGHT file for details.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""\
+Benchmark the startup time of qir-xacc.
+
+Each configuration runs the same program several times with
+``--startup-timing`` and reports the median time to reach each startup stage
+and the median wall time of the whole process. By default the serial startup
+(XACC initialized before the input is loaded) is compared with the background
+startup::
+
+    bench-startup.py build/bin/qir-xacc examples/bell.ll qpp 100
+
+Extra qir-xacc options can be compared with ``--config``, e.g.
+``--config "--peephole"``.
+"""
+
+import argparse
+import re
+import shlex
+import statistics
+import subprocess
+import sys
+import time
+
+###############################################################################
+
+STAGE_RE = re.compile(r"^startup: (.+) after ([0-9.eE+-]+) ms$")
+
+
+def run_once(command):
+    """Run qir-xacc once and return its stage times and wall time in ms."""
+    start = time.perf_counter()
+    result = subprocess.run(command, stdout=subprocess.DEVNULL,
+                            stderr=subprocess.PIPE, text=True)
+    wall = (time.perf_counter() - start) * 1000
+    if result.returncode != 0:
+        sys.stderr.write(result.stderr)
+        raise RuntimeError("command failed: " + shlex.join(command))
+
+    stages = {}
+    for line in result.stderr.splitlines():
+        match = STAGE_RE.match(line)
+        if match:
+            stages[match.group(1)] = float(match.group(2))
+    stages["process exit"] = wall
+    return stages
+
+
+def benchmark(command, repeat):
+    """Return the median time of each stage over several runs."""
+    samples = {}
+    for _ in range(repeat):
+        for stage, ms in run_once(command).items():
+            samples.setdefault(stage, []).append(ms)
+    return {stage: statistics.median(ms) for stage, ms in samples.items()}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("exe", help="path to qir-xacc")
+    parser.add_argument("input", help="LLVM IR input file")
+    parser.add_argument("accelerator", help="XACC accelerator name")
+    parser.add_argument("shots", help="number of shots")
+    parser.add_argument("-n", "--repeat", type=int, default=5,
+                        help="runs per configuration (default 5)")
+    parser.add_argument("--config", action="append",
+                        help="extra qir-xacc options for one configuration "
+                             "(default: serial and background startup)")
+    args = parser.parse_args()
+
+    configs = args.config or ["--serial-startup", ""]
+    results = []
+    for config in configs:
+        command = ([args.exe, "--startup-timing"] + shlex.split(config)
+                   + [args.input, args.accelerator, args.shots])
+        results.append((config or "(default)", benchmark(command, args.repeat)))
+
+    stages = []
+    for _, medians in results:
+        stages.extend(s for s in medians if s not in stages)
+
+    width = max(len(s) for s in stages)
+    print(f"Median over {args.repeat} runs [ms]")
+    print(" " * width + "".join(f"  {name:>18s}" for name, _ in results))
+    for stage in stages:
+        row = "".join(
+            f"  {medians[stage]:18.1f}" if stage in medians else " " * 20
+            for _, medians in results)
+        print(f"{stage:<{width}s}{row}")
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,133 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Arena.cc
+//---------------------------------------------------------------------------//
+#include "Arena.hh"
+
+#include "Assert.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with defaults.
+ */
+Arena::Arena() : Arena{Options{}} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+Arena::Arena(Options opts) : opts_{opts}
+{
+    QIREE_VALIDATE(opts_.chunk_size >= 4 * min_block
+                       && opts_.chunk_size % min_block == 0,
+                   << "invalid arena chunk size " << opts_.chunk_size);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a block of at least the given size.
+ */
+void* Arena::allocate(size_type bytes)
+{
+    size_type const cls = size_class(bytes);
+    ++num_live_;
+    if (FreeBlock* block = free_[cls])
+    {
+        // Reuse a released block of the same class
+        free_[cls] = block->next;
+        return block;
+    }
+
+    size_type const block_size = size_type(1) << cls;
+    if (block_size > opts_.chunk_size / 4)
+    {
+        dedicated_.push_back({std::make_unique<char[]>(block_size),
+                              block_size});
+        bytes_reserved_ += block_size;
+        return dedicated_.back().data.get();
+    }
+    return this->carve(block_size);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Return a block obtained with the same size.
+ *
+ * The block is kept on a free list for reuse until the arena is cleared.
+ */
+void Arena::deallocate(void* ptr, size_type bytes)
+{
+    QIREE_EXPECT(ptr);
+    QIREE_EXPECT(num_live_ > 0);
+    size_type const cls = size_class(bytes);
+    auto* block = static_cast<FreeBlock*>(ptr);
+    block->next = free_[cls];
+    free_[cls] = block;
+    --num_live_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Release all blocks at once.
+ */
+void Arena::clear()
+{
+    for (auto const& c : dedicated_)
+    {
+        bytes_reserved_ -= c.size;
+    }
+    dedicated_.clear();
+    free_.fill(nullptr);
+    chunk_index_ = 0;
+    offset_ = 0;
+    num_live_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the power-of-two size class of a request.
+ */
+size_type Arena::size_class(size_type bytes)
+{
+    size_type cls = 0;
+    while ((size_type(1) << cls) < bytes || (size_type(1) << cls) < min_block)
+    {
+        ++cls;
+    }
+    QIREE_ASSERT(cls < 64);
+    return cls;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Bump-allocate a block from the standard chunks.
+ */
+char* Arena::carve(size_type block_size)
+{
+    if (chunk_index_ < chunks_.size()
+        && offset_ + block_size > chunks_[chunk_index_].size)
+    {
+        // Abandon the tail of the current chunk
+        ++chunk_index_;
+        offset_ = 0;
+    }
+    if (chunk_index_ == chunks_.size())
+    {
+        chunks_.push_back({std::make_unique<char[]>(opts_.chunk_size),
+                           opts_.chunk_size});
+        bytes_reserved_ += opts_.chunk_size;
+        offset_ = 0;
+    }
+
+    char* result = chunks_[chunk_index_].data.get() + offset_;
+    offset_ += block_size;
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
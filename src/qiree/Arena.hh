@@ -0,0 +1,104 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Arena.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Macros.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Allocate short-lived blocks from large chunks with size-class free lists.
+ *
+ * Requests are rounded up to a power of two (at least \c min_block bytes) and
+ * carved from the current chunk with a bump pointer. A deallocated block is
+ * pushed onto the free list of its size class and handed out again by the
+ * next request of that class, so a program that repeatedly creates and
+ * releases objects of similar sizes stops allocating once it has reached its
+ * peak usage. Blocks larger than a quarter of a chunk get a dedicated chunk.
+ *
+ * \c clear releases every block in one step: the standard chunks are kept for
+ * reuse and only the dedicated ones are freed. Blocks are aligned to 16
+ * bytes. The arena is not thread safe.
+ */
+class Arena
+{
+  public:
+    //! Arena construction options
+    struct Options
+    {
+        size_type chunk_size{64 * 1024};  //!< Bytes per standard chunk
+    };
+
+    //! Smallest block size
+    static constexpr size_type min_block{32};
+
+  public:
+    // Construct with defaults
+    Arena();
+
+    // Construct with options
+    explicit Arena(Options opts);
+
+    QIREE_DELETE_COPY_MOVE(Arena);
+
+    // Get a block of at least the given size
+    void* allocate(size_type bytes);
+
+    // Return a block obtained with the same size
+    void deallocate(void* ptr, size_type bytes);
+
+    // Release all blocks at once
+    void clear();
+
+    //!@{
+    //! \name Accessors
+    //! Number of blocks currently handed out
+    size_type num_live() const { return num_live_; }
+    //! Bytes held in chunks, including unused space
+    size_type bytes_reserved() const { return bytes_reserved_; }
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    struct FreeBlock
+    {
+        FreeBlock* next;
+    };
+
+    struct Chunk
+    {
+        std::unique_ptr<char[]> data;
+        size_type size;
+    };
+
+    //// DATA ////
+
+    Options opts_;
+    std::vector<Chunk> chunks_;
+    std::vector<Chunk> dedicated_;
+    std::array<FreeBlock*, 64> free_{};
+    size_type chunk_index_{0};
+    size_type offset_{0};
+    size_type num_live_{0};
+    size_type bytes_reserved_{0};
+
+    //// HELPER FUNCTIONS ////
+
+    static size_type size_class(size_type bytes);
+    char* carve(size_type block_size);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,185 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/CircuitCache.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <iterator>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "GateTape.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+//! Which cached circuit to discard when the cache is full
+enum class CacheEviction
+{
+    lru,  //!< Least recently used
+    fifo,  //!< Oldest inserted
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Cache backend circuits by the gate sequence that produced them.
+ *
+ * Entries are looked up by \c GateTape::hash and confirmed by comparing the
+ * full instruction sequence, so hash collisions never return the wrong
+ * circuit. A capacity of zero disables caching.
+ *
+ * \tparam T Backend circuit handle (e.g. a shared pointer)
+ */
+template<class T>
+class CircuitCache
+{
+  public:
+    //! Cache options
+    struct Options
+    {
+        size_type capacity{16};  //!< Maximum number of cached circuits
+        CacheEviction eviction{CacheEviction::lru};  //!< Eviction policy
+    };
+
+    //! Cache statistics
+    struct Counters
+    {
+        size_type hits{0};
+        size_type misses{0};
+        size_type evictions{0};
+    };
+
+  public:
+    // Construct with options
+    explicit CircuitCache(Options const& opts) : opts_{opts} {}
+
+    // Construct with default options
+    CircuitCache() : CircuitCache{Options{}} {}
+
+    // Find the circuit for a recorded gate sequence
+    inline T const* find(GateTape const& tape);
+
+    // Add the circuit for a recorded gate sequence
+    inline void insert(GateTape const& tape, T value);
+
+    // Remove all cached circuits
+    void clear()
+    {
+        entries_.clear();
+        index_.clear();
+    }
+
+    //!@{
+    //! \name Accessors
+    Options const& options() const { return opts_; }
+    size_type size() const { return entries_.size(); }
+    Counters const& counters() const { return counters_; }
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    struct Entry
+    {
+        std::uint64_t hash;
+        GateTape tape;
+        T value;
+    };
+    using ListEntry = std::list<Entry>;
+    using Iter = typename ListEntry::iterator;
+
+    //// DATA ////
+
+    Options opts_;
+    ListEntry entries_;  // Front is the next to be evicted
+    std::unordered_multimap<std::uint64_t, Iter> index_;
+    Counters counters_;
+
+    //// HELPER FUNCTIONS ////
+
+    inline void evict();
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Find the circuit for a recorded gate sequence.
+ *
+ * Returns null if the sequence is not cached. With LRU eviction, a hit marks
+ * the entry as most recently used.
+ */
+template<class T>
+T const* CircuitCache<T>::find(GateTape const& tape)
+{
+    if (opts_.capacity == 0)
+        return nullptr;
+
+    auto [first, last] = index_.equal_range(tape.hash());
+    for (; first != last; ++first)
+    {
+        Iter entry = first->second;
+        if (entry->tape.same_instructions(tape))
+        {
+            ++counters_.hits;
+            if (opts_.eviction == CacheEviction::lru)
+            {
+                entries_.splice(entries_.end(), entries_, entry);
+            }
+            return &entry->value;
+        }
+    }
+    ++counters_.misses;
+    return nullptr;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add the circuit for a recorded gate sequence.
+ *
+ * If the cache is full, an entry is evicted according to the policy.
+ */
+template<class T>
+void CircuitCache<T>::insert(GateTape const& tape, T value)
+{
+    if (opts_.capacity == 0)
+        return;
+
+    while (entries_.size() >= opts_.capacity)
+    {
+        this->evict();
+    }
+    std::uint64_t const hash = tape.hash();
+    entries_.push_back({hash, tape, std::move(value)});
+    index_.emplace(hash, std::prev(entries_.end()));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove the entry at the front of the eviction order.
+ */
+template<class T>
+void CircuitCache<T>::evict()
+{
+    Iter entry = entries_.begin();
+    auto [first, last] = index_.equal_range(entry->hash);
+    for (; first != last; ++first)
+    {
+        if (first->second == entry)
+        {
+            index_.erase(first);
+            break;
+        }
+    }
+    entries_.erase(entry);
+    ++counters_.evictions;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
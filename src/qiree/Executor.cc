@@ -7,18 +7,26 @@
 //---------------------------------------------------------------------------//
 #include "Executor.hh"
 
+#include <cmath>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <sstream>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/GenericValue.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetSelect.h>
 
 #include "Assert.hh"
+#include "MathInterface.hh"
 #include "Module.hh"
 #include "QuantumInterface.hh"
+#include "QubitAllocator.hh"
 #include "RuntimeInterface.hh"
+#include "RuntimeObjects.hh"
 #include "detail/EndGuard.hh"
 #include "detail/GlobalMapper.hh"
 
@@ -35,6 +43,35 @@ namespace
  */
 static QuantumInterface* q_interface_{nullptr};
 static RuntimeInterface* r_interface_{nullptr};
+static MathInterface* m_interface_{nullptr};
+static RuntimeObjects* rt_objects_{nullptr};
+static QubitAllocator* rt_qubits_{nullptr};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tell the backend if allocating raised the qubit high-water mark.
+ */
+void reserve_allocated_qubits(size_type prev_high_water)
+{
+    size_type const num_qubits = rt_qubits_->high_water();
+    if (num_qubits > prev_high_water)
+    {
+        q_interface_->reserve_qubits(num_qubits);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reset a qubit and return its index to the allocator.
+ *
+ * A qubit may be released right after it is measured, so it is reset to
+ * |0> before a later allocation can reuse it.
+ */
+void release_qubit(Qubit q)
+{
+    q_interface_->reset(q);
+    rt_qubits_->release(q);
+}
 
 //---------------------------------------------------------------------------//
 //! Generate a function name without a specialization suffix
@@ -269,6 +306,95 @@ void QIREE_QIS_FUNCTION(assertmeasurementprobability, ctl)(std::uintptr_t arg1,
     return q_interface_->assertmeasurementprobability(Array{arg1}, Tuple{arg2});
 }
 
+//---------------------------------------------------------------------------//
+// MATH
+//---------------------------------------------------------------------------//
+double QIREE_QIS_FUNCTION(arccos, body)(double x)
+{
+    return std::acos(x);
+}
+double QIREE_QIS_FUNCTION(arcsin, body)(double x)
+{
+    return std::asin(x);
+}
+double QIREE_QIS_FUNCTION(arctan, body)(double x)
+{
+    return std::atan(x);
+}
+double QIREE_QIS_FUNCTION(arctan2, body)(double y, double x)
+{
+    return std::atan2(y, x);
+}
+double QIREE_QIS_FUNCTION(cos, body)(double x)
+{
+    return std::cos(x);
+}
+double QIREE_QIS_FUNCTION(cosh, body)(double x)
+{
+    return std::cosh(x);
+}
+double QIREE_QIS_FUNCTION(ieeeremainder, body)(double x, double y)
+{
+    return std::remainder(x, y);
+}
+double QIREE_QIS_FUNCTION(infinity, body)()
+{
+    return std::numeric_limits<double>::infinity();
+}
+double QIREE_QIS_FUNCTION(log, body)(double x)
+{
+    return std::log(x);
+}
+double QIREE_QIS_FUNCTION(nan, body)()
+{
+    return std::numeric_limits<double>::quiet_NaN();
+}
+double QIREE_QIS_FUNCTION(sin, body)(double x)
+{
+    return std::sin(x);
+}
+double QIREE_QIS_FUNCTION(sinh, body)(double x)
+{
+    return std::sinh(x);
+}
+double QIREE_QIS_FUNCTION(sqrt, body)(double x)
+{
+    return std::sqrt(x);
+}
+double QIREE_QIS_FUNCTION(tan, body)(double x)
+{
+    return std::tan(x);
+}
+double QIREE_QIS_FUNCTION(tanh, body)(double x)
+{
+    return std::tanh(x);
+}
+bool QIREE_QIS_FUNCTION(isinf, body)(double x)
+{
+    return std::isinf(x);
+}
+bool QIREE_QIS_FUNCTION(isnan, body)(double x)
+{
+    return std::isnan(x);
+}
+bool QIREE_QIS_FUNCTION(isnegativeinfinity, body)(double x)
+{
+    return std::isinf(x) && x < 0;
+}
+std::int64_t
+QIREE_QIS_FUNCTION(drawrandomint, body)(std::int64_t lo, std::int64_t hi)
+{
+    QIREE_VALIDATE(m_interface_,
+                   << "cannot draw random numbers without a math interface");
+    return m_interface_->drawrandomint(lo, hi);
+}
+double QIREE_QIS_FUNCTION(drawrandomdouble, body)(double lo, double hi)
+{
+    QIREE_VALIDATE(m_interface_,
+                   << "cannot draw random numbers without a math interface");
+    return m_interface_->drawrandomdouble(lo, hi);
+}
+
 //---------------------------------------------------------------------------//
 // RUNTIME
 //---------------------------------------------------------------------------//
@@ -283,6 +409,183 @@ void QIREE_RT_FUNCTION(result_record_output)(std::uintptr_t r,
     return r_interface_->result_record_output(Result{r}, tag);
 }
 
+std::uintptr_t QIREE_RT_FUNCTION(result_get_zero)()
+{
+    return r_interface_->result_get_zero().value;
+}
+
+std::uintptr_t QIREE_RT_FUNCTION(result_get_one)()
+{
+    return r_interface_->result_get_one().value;
+}
+
+bool QIREE_RT_FUNCTION(result_equal)(std::uintptr_t r1, std::uintptr_t r2)
+{
+    return r_interface_->result_equal(Result{r1}, Result{r2});
+}
+
+void QIREE_RT_FUNCTION(result_update_reference_count)(std::uintptr_t r,
+                                                      std::int32_t delta)
+{
+    return r_interface_->result_update_reference_count(Result{r}, delta);
+}
+
+//---------------------------------------------------------------------------//
+// RUNTIME QUBITS
+//---------------------------------------------------------------------------//
+std::uintptr_t QIREE_RT_FUNCTION(qubit_allocate)()
+{
+    size_type const prev = rt_qubits_->high_water();
+    Qubit result = rt_qubits_->allocate();
+    reserve_allocated_qubits(prev);
+    return result.value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(qubit_allocate_array)(size_type size)
+{
+    size_type const prev = rt_qubits_->high_water();
+    Array result = rt_objects_->array_create(sizeof(Qubit), size);
+    for (size_type i = 0; i != size; ++i)
+    {
+        Qubit q = rt_qubits_->allocate();
+        std::memcpy(
+            RuntimeObjects::array_element(result, i), &q, sizeof(Qubit));
+    }
+    reserve_allocated_qubits(prev);
+    return result.value;
+}
+void QIREE_RT_FUNCTION(qubit_release)(std::uintptr_t q)
+{
+    return release_qubit(Qubit{q});
+}
+void QIREE_RT_FUNCTION(qubit_release_array)(std::uintptr_t arr)
+{
+    Array const qubits{arr};
+    for (size_type i = 0; i != RuntimeObjects::array_size(qubits); ++i)
+    {
+        release_qubit(RuntimeObjects::array_get<Qubit>(qubits, i));
+    }
+    return rt_objects_->update_reference_count(qubits, -1);
+}
+//---------------------------------------------------------------------------//
+// RUNTIME ARRAYS
+//---------------------------------------------------------------------------//
+std::uintptr_t
+QIREE_RT_FUNCTION(array_create_1d)(std::int32_t elem_size, size_type size)
+{
+    QIREE_VALIDATE(elem_size > 0,
+                   << "invalid QIR array element size " << elem_size);
+    return rt_objects_->array_create(elem_size, size).value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(array_copy)(std::uintptr_t arr, bool force)
+{
+    return rt_objects_->array_copy(Array{arr}, force).value;
+}
+std::uintptr_t
+QIREE_RT_FUNCTION(array_concatenate)(std::uintptr_t arr1, std::uintptr_t arr2)
+{
+    return rt_objects_->array_concatenate(Array{arr1}, Array{arr2}).value;
+}
+size_type QIREE_RT_FUNCTION(array_get_size_1d)(std::uintptr_t arr)
+{
+    return RuntimeObjects::array_size(Array{arr});
+}
+void* QIREE_RT_FUNCTION(array_get_element_ptr_1d)(std::uintptr_t arr,
+                                                  size_type index)
+{
+    return RuntimeObjects::array_element(Array{arr}, index);
+}
+void QIREE_RT_FUNCTION(array_update_reference_count)(std::uintptr_t arr,
+                                                     std::int32_t delta)
+{
+    return rt_objects_->update_reference_count(Array{arr}, delta);
+}
+void QIREE_RT_FUNCTION(array_update_alias_count)(std::uintptr_t arr,
+                                                 std::int32_t delta)
+{
+    return RuntimeObjects::update_alias_count(Array{arr}, delta);
+}
+//---------------------------------------------------------------------------//
+// RUNTIME TUPLES
+//---------------------------------------------------------------------------//
+std::uintptr_t QIREE_RT_FUNCTION(tuple_create)(size_type bytes)
+{
+    return rt_objects_->tuple_create(bytes).value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(tuple_copy)(std::uintptr_t tup, bool force)
+{
+    return rt_objects_->tuple_copy(Tuple{tup}, force).value;
+}
+void QIREE_RT_FUNCTION(tuple_update_reference_count)(std::uintptr_t tup,
+                                                     std::int32_t delta)
+{
+    return rt_objects_->update_reference_count(Tuple{tup}, delta);
+}
+void QIREE_RT_FUNCTION(tuple_update_alias_count)(std::uintptr_t tup,
+                                                 std::int32_t delta)
+{
+    return RuntimeObjects::update_alias_count(Tuple{tup}, delta);
+}
+//---------------------------------------------------------------------------//
+// RUNTIME STRINGS
+//---------------------------------------------------------------------------//
+std::uintptr_t QIREE_RT_FUNCTION(string_create)(OptionalCString s)
+{
+    return rt_objects_->string_create(s ? s : "").value;
+}
+char const* QIREE_RT_FUNCTION(string_get_data)(std::uintptr_t str)
+{
+    // Strings are stored null-terminated
+    return RuntimeObjects::string_view(String{str}).data();
+}
+std::int32_t QIREE_RT_FUNCTION(string_get_length)(std::uintptr_t str)
+{
+    return static_cast<std::int32_t>(
+        RuntimeObjects::string_view(String{str}).size());
+}
+void QIREE_RT_FUNCTION(string_update_reference_count)(std::uintptr_t str,
+                                                      std::int32_t delta)
+{
+    return rt_objects_->update_reference_count(String{str}, delta);
+}
+std::uintptr_t
+QIREE_RT_FUNCTION(string_concatenate)(std::uintptr_t str1, std::uintptr_t str2)
+{
+    return rt_objects_->string_concatenate(String{str1}, String{str2}).value;
+}
+bool QIREE_RT_FUNCTION(string_equal)(std::uintptr_t str1, std::uintptr_t str2)
+{
+    return RuntimeObjects::string_view(String{str1})
+           == RuntimeObjects::string_view(String{str2});
+}
+std::uintptr_t QIREE_RT_FUNCTION(int_to_string)(std::int64_t value)
+{
+    return rt_objects_->string_create(std::to_string(value)).value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(double_to_string)(double value)
+{
+    std::ostringstream os;
+    os << value;
+    return rt_objects_->string_create(os.str()).value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(bool_to_string)(bool value)
+{
+    return rt_objects_->string_create(value ? "true" : "false").value;
+}
+std::uintptr_t QIREE_RT_FUNCTION(pauli_to_string)(pauli_type value)
+{
+    static char const* const names[]
+        = {"PauliI", "PauliX", "PauliZ", "PauliY"};
+    QIREE_VALIDATE(value >= 0 && value < 4,
+                   << "invalid Pauli value " << static_cast<int>(value));
+    return rt_objects_->string_create(names[value]).value;
+}
+void QIREE_RT_FUNCTION(fail)(std::uintptr_t str)
+{
+    QIREE_VALIDATE(false,
+                   << "QIR program failed: "
+                   << RuntimeObjects::string_view(String{str}));
+}
+
 //!@}
 //---------------------------------------------------------------------------//
 }  // namespace
@@ -292,7 +595,10 @@ void QIREE_RT_FUNCTION(result_record_output)(std::uintptr_t r,
  * Construct with a QIR input filename.
  */
 Executor::Executor(Module&& module)
-    : entrypoint_{module.entrypoint_}, module_{module.module_.get()}
+    : entrypoint_{module.entrypoint_}
+    , module_{module.module_.get()}
+    , objects_{std::make_unique<RuntimeObjects>()}
+    , qubits_{std::make_unique<QubitAllocator>()}
 {
     QIREE_EXPECT(module);
     QIREE_EXPECT(entrypoint_ && module_);
@@ -300,6 +606,9 @@ Executor::Executor(Module&& module)
     // Save module and entry point attributes
     entry_point_attrs_ = module.load_entry_point_attrs();
     module_flags_ = module.load_module_flags();
+    draws_random_
+        = module_->getFunction("__quantum__qis__drawrandomint__body")
+          || module_->getFunction("__quantum__qis__drawrandomdouble__body");
 
     // Initialize LLVM
     llvm::InitializeNativeTarget();
@@ -324,6 +633,8 @@ Executor::Executor(Module&& module)
         QIREE_VALIDATE(ee, << "failed to create execution engine: " << err_str);
         return ee;
     }();
+    // The engine now owns the module, so take ownership of its context too
+    context_ = std::move(module.context_);
 
     // Suppress symbol lookup in system dynamic libraries
     ee_->DisableSymbolSearching(true);
@@ -390,9 +701,65 @@ Executor::Executor(Module&& module)
     // Assertions
     QIREE_BIND_QIS_FUNCTION(assertmeasurementprobability, body);
     QIREE_BIND_QIS_FUNCTION(assertmeasurementprobability, ctl);
+    // Math
+    QIREE_BIND_QIS_FUNCTION(arccos, body);
+    QIREE_BIND_QIS_FUNCTION(arcsin, body);
+    QIREE_BIND_QIS_FUNCTION(arctan, body);
+    QIREE_BIND_QIS_FUNCTION(arctan2, body);
+    QIREE_BIND_QIS_FUNCTION(cos, body);
+    QIREE_BIND_QIS_FUNCTION(cosh, body);
+    QIREE_BIND_QIS_FUNCTION(ieeeremainder, body);
+    QIREE_BIND_QIS_FUNCTION(infinity, body);
+    QIREE_BIND_QIS_FUNCTION(log, body);
+    QIREE_BIND_QIS_FUNCTION(nan, body);
+    QIREE_BIND_QIS_FUNCTION(sin, body);
+    QIREE_BIND_QIS_FUNCTION(sinh, body);
+    QIREE_BIND_QIS_FUNCTION(sqrt, body);
+    QIREE_BIND_QIS_FUNCTION(tan, body);
+    QIREE_BIND_QIS_FUNCTION(tanh, body);
+    QIREE_BIND_QIS_FUNCTION(isinf, body);
+    QIREE_BIND_QIS_FUNCTION(isnan, body);
+    QIREE_BIND_QIS_FUNCTION(isnegativeinfinity, body);
+    QIREE_BIND_QIS_FUNCTION(drawrandomint, body);
+    QIREE_BIND_QIS_FUNCTION(drawrandomdouble, body);
 
     QIREE_BIND_RT_FUNCTION(array_record_output);
     QIREE_BIND_RT_FUNCTION(result_record_output);
+    // Results
+    QIREE_BIND_RT_FUNCTION(result_get_zero);
+    QIREE_BIND_RT_FUNCTION(result_get_one);
+    QIREE_BIND_RT_FUNCTION(result_equal);
+    QIREE_BIND_RT_FUNCTION(result_update_reference_count);
+    // Qubits
+    QIREE_BIND_RT_FUNCTION(qubit_allocate);
+    QIREE_BIND_RT_FUNCTION(qubit_allocate_array);
+    QIREE_BIND_RT_FUNCTION(qubit_release);
+    QIREE_BIND_RT_FUNCTION(qubit_release_array);
+    // Arrays
+    QIREE_BIND_RT_FUNCTION(array_create_1d);
+    QIREE_BIND_RT_FUNCTION(array_copy);
+    QIREE_BIND_RT_FUNCTION(array_concatenate);
+    QIREE_BIND_RT_FUNCTION(array_get_size_1d);
+    QIREE_BIND_RT_FUNCTION(array_get_element_ptr_1d);
+    QIREE_BIND_RT_FUNCTION(array_update_reference_count);
+    QIREE_BIND_RT_FUNCTION(array_update_alias_count);
+    // Tuples
+    QIREE_BIND_RT_FUNCTION(tuple_create);
+    QIREE_BIND_RT_FUNCTION(tuple_copy);
+    QIREE_BIND_RT_FUNCTION(tuple_update_reference_count);
+    QIREE_BIND_RT_FUNCTION(tuple_update_alias_count);
+    // Strings
+    QIREE_BIND_RT_FUNCTION(string_create);
+    QIREE_BIND_RT_FUNCTION(string_get_data);
+    QIREE_BIND_RT_FUNCTION(string_get_length);
+    QIREE_BIND_RT_FUNCTION(string_update_reference_count);
+    QIREE_BIND_RT_FUNCTION(string_concatenate);
+    QIREE_BIND_RT_FUNCTION(string_equal);
+    QIREE_BIND_RT_FUNCTION(int_to_string);
+    QIREE_BIND_RT_FUNCTION(double_to_string);
+    QIREE_BIND_RT_FUNCTION(bool_to_string);
+    QIREE_BIND_RT_FUNCTION(pauli_to_string);
+    QIREE_BIND_RT_FUNCTION(fail);
 #undef QIREE_BIND_RT_FUNCTION
 #undef QIREE_BIND_QIS_FUNCTION
 
@@ -406,21 +773,58 @@ Executor::~Executor() = default;
 //---------------------------------------------------------------------------//
 /*!
  * Execute with the given interface functions.
+ *
+ * The program may not draw random numbers.
  */
 void Executor::operator()(QuantumInterface& qi, RuntimeInterface& ri) const
+{
+    return this->execute(qi, ri, nullptr);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute with the given interface functions and random number source.
+ */
+void Executor::operator()(QuantumInterface& qi,
+                          RuntimeInterface& ri,
+                          MathInterface& mi) const
+{
+    return this->execute(qi, ri, &mi);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute with the given interface functions.
+ *
+ * Arrays, tuples, and strings created by the program are all released when
+ * the execution ends. Dynamically allocated qubits are numbered after the
+ * entry point's required qubits, and the quantum interface is told whenever
+ * the number of qubits in use reaches a new maximum.
+ */
+void Executor::execute(QuantumInterface& qi,
+                       RuntimeInterface& ri,
+                       MathInterface* mi) const
 {
     QIREE_EXPECT(ee_);
 
     QIREE_VALIDATE(!q_interface_ && !r_interface_,
                    << "cannot call LLVM executor recursively or in MT "
                       "environment (for now)");
-    detail::EndGuard on_end_scope_([] {
+    detail::EndGuard on_end_scope_([this] {
         q_interface_->tear_down();
+        objects_->clear();
         q_interface_ = nullptr;
         r_interface_ = nullptr;
+        m_interface_ = nullptr;
+        rt_objects_ = nullptr;
+        rt_qubits_ = nullptr;
     });
     q_interface_ = &qi;
     r_interface_ = &ri;
+    m_interface_ = mi;
+    rt_objects_ = objects_.get();
+    rt_qubits_ = qubits_.get();
+    qubits_->reset(entry_point_attrs_.required_num_qubits);
 
     // Call setup on the interface
     qi.set_up(entry_point_attrs_);
@@ -15,17 +15,21 @@
 
 namespace llvm
 {
-class Module;
 class ExecutionEngine;
 class Function;
+class LLVMContext;
+class Module;
 }  // namespace llvm
 
 namespace qiree
 {
 //---------------------------------------------------------------------------//
+class MathInterface;
 class Module;
 class QuantumInterface;
+class QubitAllocator;
 class RuntimeInterface;
+class RuntimeObjects;
 
 //---------------------------------------------------------------------------//
 /*!
@@ -45,13 +49,29 @@ class Executor
     // Execute with the given interface functions
     void operator()(QuantumInterface& qi, RuntimeInterface& ri) const;
 
+    // Execute with the given interface functions and random number source
+    void operator()(QuantumInterface& qi,
+                    RuntimeInterface& ri,
+                    MathInterface& mi) const;
+
+    //! Whether the program draws random numbers
+    bool draws_random_numbers() const { return draws_random_; }
+
   private:
     llvm::Function* entrypoint_{nullptr};
     llvm::Module* module_{nullptr};
 
     EntryPointAttrs entry_point_attrs_;
     ModuleFlags module_flags_;
+    bool draws_random_{false};
+    std::unique_ptr<llvm::LLVMContext> context_;
     std::unique_ptr<llvm::ExecutionEngine> ee_;
+    std::unique_ptr<RuntimeObjects> objects_;
+    std::unique_ptr<QubitAllocator> qubits_;
+
+    void execute(QuantumInterface& qi,
+                 RuntimeInterface& ri,
+                 MathInterface* mi) const;
 };
 
 //---------------------------------------------------------------------------//
@@ -0,0 +1,367 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/GateTape.cc
+//---------------------------------------------------------------------------//
+#include "GateTape.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <limits>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Static properties of each instruction
+struct GateOpTraits
+{
+    char const* name;
+    int num_args;
+    int num_angles;
+};
+
+// clang-format off
+constexpr GateOpTraits gate_op_traits[] = {
+    {"ccx",   2, 0},
+    {"cnot",  2, 0},
+    {"cx",    2, 0},
+    {"cy",    2, 0},
+    {"cz",    2, 0},
+    {"h",     1, 0},
+    {"mz",    2, 0},
+    {"r",     2, 1},
+    {"r_adj", 2, 1},
+    {"reset", 1, 0},
+    {"rx",    1, 1},
+    {"rxx",   2, 1},
+    {"ry",    1, 1},
+    {"ryy",   2, 1},
+    {"rz",    1, 1},
+    {"rzz",   2, 1},
+    {"s",     1, 0},
+    {"s_adj", 1, 0},
+    {"swap",  2, 0},
+    {"t",     1, 0},
+    {"t_adj", 1, 0},
+    {"x",     1, 0},
+    {"y",     1, 0},
+    {"z",     1, 0},
+};
+// clang-format on
+
+static_assert(std::size(gate_op_traits)
+              == static_cast<std::size_t>(GateOp::size_));
+
+GateOpTraits const& traits(GateOp op)
+{
+    QIREE_EXPECT(op < GateOp::size_);
+    return gate_op_traits[static_cast<std::size_t>(op)];
+}
+
+//---------------------------------------------------------------------------//
+//! Mix raw bytes into an FNV-1a hash
+std::uint64_t fnv1a(void const* data, std::size_t size, std::uint64_t hash)
+{
+    constexpr std::uint64_t prime = 0x100000001b3ull;
+    auto const* bytes = static_cast<unsigned char const*>(data);
+    for (std::size_t i = 0; i != size; ++i)
+    {
+        hash = (hash ^ bytes[i]) * prime;
+    }
+    return hash;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all instructions, keeping storage.
+ */
+void GateTape::clear()
+{
+    ops_.clear();
+    args_.clear();
+    angles_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the recorded instructions to another interface.
+ *
+ * The target's \c set_up and \c tear_down are not called.
+ */
+void GateTape::replay(QuantumInterface& target) const
+{
+    this->for_each([&target](Instruction const& inst) {
+        auto q = [&inst](int i) { return Qubit{inst.args[i]}; };
+        double const* theta = inst.angles;
+        switch (inst.op)
+        {
+            // clang-format off
+            case GateOp::ccx: return target.ccx(q(0), q(1));
+            case GateOp::cnot: return target.cnot(q(0), q(1));
+            case GateOp::cx: return target.cx(q(0), q(1));
+            case GateOp::cy: return target.cy(q(0), q(1));
+            case GateOp::cz: return target.cz(q(0), q(1));
+            case GateOp::h: return target.h(q(0));
+            case GateOp::mz: return target.mz(q(0), Result{inst.args[1]});
+            case GateOp::r:
+                return target.r(
+                    static_cast<Pauli>(inst.args[0]), theta[0], q(1));
+            case GateOp::r_adj:
+                return target.r_adj(
+                    static_cast<Pauli>(inst.args[0]), theta[0], q(1));
+            case GateOp::reset: return target.reset(q(0));
+            case GateOp::rx: return target.rx(theta[0], q(0));
+            case GateOp::rxx: return target.rxx(theta[0], q(0), q(1));
+            case GateOp::ry: return target.ry(theta[0], q(0));
+            case GateOp::ryy: return target.ryy(theta[0], q(0), q(1));
+            case GateOp::rz: return target.rz(theta[0], q(0));
+            case GateOp::rzz: return target.rzz(theta[0], q(0), q(1));
+            case GateOp::s: return target.s(q(0));
+            case GateOp::s_adj: return target.s_adj(q(0));
+            case GateOp::swap: return target.swap(q(0), q(1));
+            case GateOp::t: return target.t(q(0));
+            case GateOp::t_adj: return target.t_adj(q(0));
+            case GateOp::x: return target.x(q(0));
+            case GateOp::y: return target.y(q(0));
+            case GateOp::z: return target.z(q(0));
+            case GateOp::size_: break;
+            // clang-format on
+        }
+        QIREE_ASSERT_UNREACHABLE();
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Hash the recorded instruction sequence.
+ *
+ * The hash covers the opcodes, arguments, and the exact bit patterns of the
+ * angles, so equal tapes always hash equally.
+ */
+std::uint64_t GateTape::hash() const
+{
+    std::uint64_t result = 0xcbf29ce484222325ull;
+    std::uint64_t const sizes[]
+        = {ops_.size(), args_.size(), angles_.size()};
+    result = fnv1a(sizes, sizeof(sizes), result);
+    result = fnv1a(ops_.data(), ops_.size() * sizeof(GateOp), result);
+    result = fnv1a(args_.data(), args_.size() * sizeof(index_type), result);
+    result = fnv1a(angles_.data(), angles_.size() * sizeof(double), result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two tapes record the same instruction sequence.
+ *
+ * Angles are compared bitwise so that the result is consistent with \c hash.
+ */
+bool GateTape::same_instructions(GateTape const& other) const
+{
+    return ops_ == other.ops_ && args_ == other.args_
+           && angles_.size() == other.angles_.size()
+           && (angles_.empty()
+               || std::memcmp(angles_.data(),
+                              other.angles_.data(),
+                              angles_.size() * sizeof(double))
+                      == 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Start a new recording.
+ */
+void GateTape::set_up(EntryPointAttrs const& attrs)
+{
+    attrs_ = attrs;
+    this->clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete the recording.
+ */
+void GateTape::tear_down() {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record that dynamically allocated qubits are used.
+ *
+ * The qubit count of the recorded attributes grows so that a target set up
+ * with \c attrs() has room for every qubit on the tape.
+ */
+void GateTape::reserve_qubits(size_type num_qubits)
+{
+    attrs_.required_num_qubits
+        = std::max(attrs_.required_num_qubits, num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a measurement.
+ */
+void GateTape::mz(Qubit q, Result r)
+{
+    this->push(GateOp::mz, {q.value, r.value});
+}
+
+//---------------------------------------------------------------------------//
+// QUANTUM INSTRUCTION RECORDING
+//---------------------------------------------------------------------------//
+void GateTape::ccx(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::ccx, {q1.value, q2.value});
+}
+void GateTape::cnot(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::cnot, {q1.value, q2.value});
+}
+void GateTape::cx(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::cx, {q1.value, q2.value});
+}
+void GateTape::cy(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::cy, {q1.value, q2.value});
+}
+void GateTape::cz(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::cz, {q1.value, q2.value});
+}
+void GateTape::h(Qubit q)
+{
+    this->push(GateOp::h, {q.value});
+}
+void GateTape::r_adj(Pauli p, double angle, Qubit q)
+{
+    this->push(GateOp::r_adj, {static_cast<size_type>(p), q.value}, {angle});
+}
+void GateTape::r(Pauli p, double angle, Qubit q)
+{
+    this->push(GateOp::r, {static_cast<size_type>(p), q.value}, {angle});
+}
+void GateTape::reset(Qubit q)
+{
+    this->push(GateOp::reset, {q.value});
+}
+void GateTape::rx(double angle, Qubit q)
+{
+    this->push(GateOp::rx, {q.value}, {angle});
+}
+void GateTape::rxx(double angle, Qubit q1, Qubit q2)
+{
+    this->push(GateOp::rxx, {q1.value, q2.value}, {angle});
+}
+void GateTape::ry(double angle, Qubit q)
+{
+    this->push(GateOp::ry, {q.value}, {angle});
+}
+void GateTape::ryy(double angle, Qubit q1, Qubit q2)
+{
+    this->push(GateOp::ryy, {q1.value, q2.value}, {angle});
+}
+void GateTape::rz(double angle, Qubit q)
+{
+    this->push(GateOp::rz, {q.value}, {angle});
+}
+void GateTape::rzz(double angle, Qubit q1, Qubit q2)
+{
+    this->push(GateOp::rzz, {q1.value, q2.value}, {angle});
+}
+void GateTape::s(Qubit q)
+{
+    this->push(GateOp::s, {q.value});
+}
+void GateTape::s_adj(Qubit q)
+{
+    this->push(GateOp::s_adj, {q.value});
+}
+void GateTape::swap(Qubit q1, Qubit q2)
+{
+    this->push(GateOp::swap, {q1.value, q2.value});
+}
+void GateTape::t(Qubit q)
+{
+    this->push(GateOp::t, {q.value});
+}
+void GateTape::t_adj(Qubit q)
+{
+    this->push(GateOp::t_adj, {q.value});
+}
+void GateTape::x(Qubit q)
+{
+    this->push(GateOp::x, {q.value});
+}
+void GateTape::y(Qubit q)
+{
+    this->push(GateOp::y, {q.value});
+}
+void GateTape::z(Qubit q)
+{
+    this->push(GateOp::z, {q.value});
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Append an instruction.
+ */
+void GateTape::push(GateOp op,
+                    std::initializer_list<size_type> args,
+                    std::initializer_list<double> angles)
+{
+    QIREE_EXPECT(static_cast<int>(args.size()) == num_args(op));
+    QIREE_EXPECT(static_cast<int>(angles.size()) == num_angles(op));
+
+    ops_.push_back(op);
+    for (size_type a : args)
+    {
+        QIREE_VALIDATE(a <= std::numeric_limits<index_type>::max(),
+                       << "index " << a << " is too large to record");
+        args_.push_back(static_cast<index_type>(a));
+    }
+    angles_.insert(angles_.end(), angles.begin(), angles.end());
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Number of integer arguments of an instruction.
+ */
+int num_args(GateOp op)
+{
+    return traits(op).num_args;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of angles of an instruction.
+ */
+int num_angles(GateOp op)
+{
+    return traits(op).num_angles;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the QIS name of an instruction.
+ */
+char const* to_cstring(GateOp op)
+{
+    return traits(op).name;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,206 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/GateTape.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <initializer_list>
+#include <vector>
+
+#include "QuantumNotImpl.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Instructions that can be recorded on a gate tape.
+ */
+enum class GateOp : std::uint8_t
+{
+    ccx,
+    cnot,
+    cx,
+    cy,
+    cz,
+    h,
+    mz,
+    r,
+    r_adj,
+    reset,
+    rx,
+    rxx,
+    ry,
+    ryy,
+    rz,
+    rzz,
+    s,
+    s_adj,
+    swap,
+    t,
+    t_adj,
+    x,
+    y,
+    z,
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Record a quantum circuit compactly for later replay.
+ *
+ * Instructions are stored as a structure of arrays: one opcode byte per
+ * instruction, a shared pool of integer arguments (qubits, results, and Pauli
+ * bases), and a shared pool of angles. The number of arguments and angles is
+ * implied by the opcode, so no per-instruction storage is needed beyond those
+ * pools. The pools behave as arenas: \c clear (and \c set_up) reset their
+ * sizes but keep their capacity, so re-recording a circuit of similar size
+ * does not allocate.
+ *
+ * The tape is a \c QuantumInterface so that it can stand in for a backend
+ * while a program executes. Results cannot be read while recording, so
+ * programs with feedback must be run directly on a backend.
+ *
+ * \code
+   GateTape tape;
+   execute(tape, runtime);
+   sim.set_up(tape.attrs());
+   tape.replay(sim);
+ * \endcode
+ */
+class GateTape final : virtual public QuantumNotImpl
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using index_type = std::uint32_t;
+    //!@}
+
+    //! View of a single recorded instruction
+    struct Instruction
+    {
+        GateOp op;
+        index_type const* args;  //!< Qubits, results, or Pauli bases
+        double const* angles;  //!< Rotation angles
+    };
+
+  public:
+    // Remove all instructions, keeping storage
+    void clear();
+
+    // Apply the recorded instructions to another interface
+    void replay(QuantumInterface& target) const;
+
+    // Visit each recorded instruction in order
+    template<class F>
+    inline void for_each(F&& visit) const;
+
+    // Hash the recorded instruction sequence
+    std::uint64_t hash() const;
+
+    // Whether two tapes record the same instruction sequence
+    bool same_instructions(GateTape const& other) const;
+
+    //!@{
+    //! \name Accessors
+    EntryPointAttrs const& attrs() const { return attrs_; }
+    size_type size() const { return ops_.size(); }
+    bool empty() const { return ops_.empty(); }
+    std::vector<GateOp> const& ops() const { return ops_; }
+    std::vector<index_type> const& args() const { return args_; }
+    std::vector<double> const& angles() const { return angles_; }
+    //!@}
+
+    //!@{
+    //! \name Quantum interface
+    // Start a new recording
+    void set_up(EntryPointAttrs const&) final;
+
+    // Complete the recording
+    void tear_down() final;
+
+    // Record that dynamically allocated qubits are used
+    void reserve_qubits(size_type num_qubits) final;
+
+    // Record a measurement
+    void mz(Qubit, Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void h(Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s(Qubit) final;
+    void s_adj(Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t(Qubit) final;
+    void t_adj(Qubit) final;
+    void x(Qubit) final;
+    void y(Qubit) final;
+    void z(Qubit) final;
+    //!@}
+
+  private:
+    EntryPointAttrs attrs_;
+    std::vector<GateOp> ops_;
+    std::vector<index_type> args_;
+    std::vector<double> angles_;
+
+    void push(GateOp op,
+              std::initializer_list<size_type> args,
+              std::initializer_list<double> angles = {});
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+// Number of integer arguments of an instruction
+int num_args(GateOp op);
+
+// Number of angles of an instruction
+int num_angles(GateOp op);
+
+// Get the QIS name of an instruction
+char const* to_cstring(GateOp op);
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Visit each recorded instruction in order.
+ *
+ * The visitor is called with an \c Instruction whose pointers are valid only
+ * until the tape is next modified.
+ */
+template<class F>
+void GateTape::for_each(F&& visit) const
+{
+    index_type const* args = args_.data();
+    double const* angles = angles_.data();
+    for (GateOp op : ops_)
+    {
+        visit(Instruction{op, args, angles});
+        args += num_args(op);
+        angles += num_angles(op);
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
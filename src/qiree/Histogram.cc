@@ -0,0 +1,189 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Histogram.cc
+//---------------------------------------------------------------------------//
+#include "Histogram.hh"
+
+#include <algorithm>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with room for a number of distinct outcomes.
+ */
+Histogram::Histogram(size_type num_keys)
+{
+    size_type capacity = 16;
+    while (capacity < 2 * num_keys)
+    {
+        capacity *= 2;
+    }
+    this->rehash(capacity);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the count of an outcome.
+ */
+auto Histogram::operator[](key_type key) const -> count_type
+{
+    if (keys_.empty())
+        return 0;
+
+    size_type const mask = keys_.size() - 1;
+    for (size_type i = hash(key) & mask;; i = (i + 1) & mask)
+    {
+        if (counts_[i] == 0)
+            return 0;
+        if (keys_[i] == key)
+            return counts_[i];
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Add all counts of another histogram.
+ */
+void Histogram::merge(Histogram const& other)
+{
+    if (this->empty() && keys_.size() < other.keys_.size())
+    {
+        // Adopt the other's layout to avoid rehashing while inserting
+        *this = other;
+        return;
+    }
+    other.for_each([this](key_type key, count_type count) {
+        this->add(key, count);
+    });
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Remove all outcomes, keeping storage.
+ */
+void Histogram::clear()
+{
+    std::fill(counts_.begin(), counts_.end(), count_type{0});
+    size_ = 0;
+    total_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tabulate the [zero, one] counts of each bit.
+ *
+ * This takes a single pass over the distinct outcomes, adding each count to
+ * the "one" tally of its set bits. Bits beyond the key width were never
+ * set, so they are always zero.
+ */
+auto Histogram::marginals(size_type num_bits) const -> VecMarginal
+{
+    VecMarginal result(num_bits, {0, 0});
+    this->for_each([&result, num_bits](key_type key, count_type count) {
+        for (size_type b = 0; key != 0 && b != num_bits; ++b, key >>= 1)
+        {
+            if (key & 1)
+            {
+                result[b][1] += count;
+            }
+        }
+    });
+    for (auto& m : result)
+    {
+        m[0] = total_ - m[1];
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the outcomes and counts sorted by key.
+ */
+auto Histogram::sorted() const -> VecKeyCount
+{
+    VecKeyCount result;
+    result.reserve(size_);
+    this->for_each([&result](key_type key, count_type count) {
+        result.emplace_back(key, count);
+    });
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two histograms have the same counts.
+ */
+bool Histogram::operator==(Histogram const& other) const
+{
+    if (size_ != other.size_ || total_ != other.total_)
+        return false;
+
+    bool same = true;
+    this->for_each([&](key_type key, count_type count) {
+        same = same && other[key] == count;
+    });
+    return same;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move the outcomes into a table with a new power-of-two capacity.
+ */
+void Histogram::rehash(size_type capacity)
+{
+    QIREE_EXPECT(capacity > 0 && (capacity & (capacity - 1)) == 0);
+    QIREE_EXPECT(2 * size_ <= capacity);
+
+    std::vector<key_type> old_keys(capacity);
+    std::vector<count_type> old_counts(capacity, 0);
+    // Swap so that the old entries are reinserted into the new storage
+    keys_.swap(old_keys);
+    counts_.swap(old_counts);
+
+    size_type const mask = capacity - 1;
+    for (size_type j = 0; j != old_keys.size(); ++j)
+    {
+        if (old_counts[j] == 0)
+            continue;
+        size_type i = hash(old_keys[j]) & mask;
+        while (counts_[i] != 0)
+        {
+            i = (i + 1) & mask;
+        }
+        keys_[i] = old_keys[j];
+        counts_[i] = old_counts[j];
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the number of shards.
+ */
+ShardedHistogram::ShardedHistogram(size_type num_shards) : shards_(num_shards)
+{
+    QIREE_EXPECT(num_shards > 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Merge all shards into one histogram.
+ *
+ * The shards are consumed: the first becomes the result.
+ */
+Histogram ShardedHistogram::merge() &&
+{
+    Histogram result = std::move(shards_.front().hist);
+    for (size_type i = 1; i != shards_.size(); ++i)
+    {
+        result.merge(shards_[i].hist);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
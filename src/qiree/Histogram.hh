@@ -0,0 +1,208 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Histogram.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Assert.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Count measurement outcomes keyed by packed bitstrings.
+ *
+ * Bit \em j of a key is the outcome of the \em j th measured bit, so up to
+ * \c max_bits bits can be counted; callers with wider registers must tally
+ * their outcomes another way. Keys and counts are stored in two flat arrays
+ * with open addressing and linear probing; a zero count marks an empty slot.
+ * The table doubles when it is half full, so lookups touch one or two cache
+ * lines and no node is allocated per outcome.
+ *
+ * A histogram is not safe for concurrent insertion: use one per thread (see
+ * \c ShardedHistogram ) and \c merge them afterward.
+ */
+class Histogram
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using key_type = std::uint64_t;
+    using count_type = size_type;
+    using VecMarginal = std::vector<std::array<count_type, 2>>;
+    using VecKeyCount = std::vector<std::pair<key_type, count_type>>;
+    //!@}
+
+    //! Number of bits in a key
+    static constexpr size_type max_bits = 64;
+
+  public:
+    // Construct empty
+    Histogram() = default;
+
+    // Construct with room for a number of distinct outcomes
+    explicit Histogram(size_type num_keys);
+
+    // Add to the count of an outcome
+    inline void add(key_type key, count_type count = 1);
+
+    // Get the count of an outcome
+    count_type operator[](key_type key) const;
+
+    // Add all counts of another histogram
+    void merge(Histogram const& other);
+
+    // Remove all outcomes, keeping storage
+    void clear();
+
+    // Visit each outcome and its count in unspecified order
+    template<class F>
+    inline void for_each(F&& visit) const;
+
+    // Tabulate the [zero, one] counts of each bit
+    VecMarginal marginals(size_type num_bits) const;
+
+    // Get the outcomes and counts sorted by key
+    VecKeyCount sorted() const;
+
+    // Whether two histograms have the same counts
+    bool operator==(Histogram const& other) const;
+    bool operator!=(Histogram const& other) const
+    {
+        return !(*this == other);
+    }
+
+    //!@{
+    //! \name Accessors
+    //! Number of distinct outcomes
+    size_type size() const { return size_; }
+    //! Whether no outcome has been counted
+    bool empty() const { return size_ == 0; }
+    //! Sum of all counts
+    count_type total() const { return total_; }
+    //!@}
+
+  private:
+    std::vector<key_type> keys_;
+    std::vector<count_type> counts_;
+    size_type size_{0};
+    count_type total_{0};
+
+    static inline size_type hash(key_type key);
+    void rehash(size_type capacity);
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Per-thread histograms that are merged once counting is done.
+ *
+ * Each thread adds only to its own shard, so insertion needs no locks or
+ * atomics, and shards are aligned so that they do not share cache lines.
+ */
+class ShardedHistogram
+{
+  public:
+    // Construct with the number of shards
+    explicit ShardedHistogram(size_type num_shards);
+
+    //! Histogram owned by a single thread
+    Histogram& shard(size_type i)
+    {
+        QIREE_EXPECT(i < shards_.size());
+        return shards_[i].hist;
+    }
+
+    //! Number of shards
+    size_type num_shards() const { return shards_.size(); }
+
+    // Merge all shards into one histogram
+    Histogram merge() &&;
+
+  private:
+    struct alignas(64) Shard
+    {
+        Histogram hist;
+    };
+
+    std::vector<Shard> shards_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Add to the count of an outcome.
+ */
+void Histogram::add(key_type key, count_type count)
+{
+    if (count == 0)
+        return;
+
+    if (2 * (size_ + 1) > keys_.size())
+    {
+        this->rehash(keys_.empty() ? 16 : 2 * keys_.size());
+    }
+
+    size_type const mask = keys_.size() - 1;
+    for (size_type i = hash(key) & mask;; i = (i + 1) & mask)
+    {
+        if (counts_[i] == 0)
+        {
+            keys_[i] = key;
+            counts_[i] = count;
+            ++size_;
+            break;
+        }
+        if (keys_[i] == key)
+        {
+            counts_[i] += count;
+            break;
+        }
+    }
+    total_ += count;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Visit each outcome and its count in unspecified order.
+ */
+template<class F>
+void Histogram::for_each(F&& visit) const
+{
+    for (size_type i = 0; i != keys_.size(); ++i)
+    {
+        if (counts_[i] != 0)
+        {
+            visit(keys_[i], counts_[i]);
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mix the bits of a key (the 64-bit MurmurHash3 finalizer).
+ *
+ * Packed outcomes differ mostly in their low bits, so they must be mixed
+ * before masking to a power-of-two table.
+ */
+size_type Histogram::hash(key_type key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53ull;
+    key ^= key >> 33;
+    return key;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
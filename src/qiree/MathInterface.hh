@@ -7,19 +7,21 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <cstdint>
+
 namespace qiree
 {
 //---------------------------------------------------------------------------//
 /*!
  * Interface class for math operations in the \c qis (quantum) namespace.
  *
- * TODO: this is not yet implemented.
- *
+ * The elementary functions are pure, so the executor binds them directly to
+ * the C++ standard library:
  * \verbatim
 double @__quantum__qis__arccos__body(double)
 double @__quantum__qis__arcsin__body(double)
 double @__quantum__qis__arctan__body(double)
-double @__quantum__qis__arctan2__body(double)
+double @__quantum__qis__arctan2__body(double, double)
 double @__quantum__qis__cos__body(double)
 double @__quantum__qis__cosh__body(double)
 double @__quantum__qis__ieeeremainder__body(double, double)
@@ -31,17 +33,28 @@ double @__quantum__qis__sinh__body(double)
 double @__quantum__qis__sqrt__body(double)
 double @__quantum__qis__tan__body(double)
 double @__quantum__qis__tanh__body(double)
-i1 @__quantum__qis__isinf__body()
-i1 @__quantum__qis__isnan__body()
-i1 @__quantum__qis__isnegativeinfinity__body()
-
-i64 @__quantum__qis__drawrandomint__body()
-double @__quantum__qis__drawrandomdouble__body()
+i1 @__quantum__qis__isinf__body(double)
+i1 @__quantum__qis__isnan__body(double)
+i1 @__quantum__qis__isnegativeinfinity__body(double)
+   \endverbatim
+ *
+ * Random draws depend on which shot is running, so they are provided by an
+ * implementation of this class:
+ * \verbatim
+i64 @__quantum__qis__drawrandomint__body(i64, i64)
+double @__quantum__qis__drawrandomdouble__body(double, double)
    \endverbatim
+ * Both bounds are inclusive.
  */
 class MathInterface
 {
   public:
+    //! Draw a uniformly distributed integer in [lo, hi]
+    virtual std::int64_t drawrandomint(std::int64_t lo, std::int64_t hi) = 0;
+
+    //! Draw a uniformly distributed real number in [lo, hi]
+    virtual double drawrandomdouble(double lo, double hi) = 0;
+
   protected:
     virtual ~MathInterface() = default;
 };
@@ -9,12 +9,16 @@
 
 #include <sstream>
 #include <string_view>
+#include <utility>
 #include <llvm/IR/Attributes.h>
 #include <llvm/IR/Constants.h>
 #include <llvm/IR/Function.h>
+#include <llvm/IR/LLVMContext.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IRReader/IRReader.h>
+#include <llvm/Support/MemoryBuffer.h>
 #include <llvm/Support/SourceMgr.h>
+#include <llvm/Support/raw_ostream.h>
 
 #include "Assert.hh"
 
@@ -24,26 +28,15 @@ namespace qiree
 {
 namespace
 {
-//---------------------------------------------------------------------------//
-/*!
- * Shared, thread-local LLVM context.
- *
- * This must exceed the lifetime of any IR, modules, etc.
- */
-llvm::LLVMContext& context()
-{
-    static llvm::LLVMContext ctx;
-    return ctx;
-}
-
 //---------------------------------------------------------------------------//
 /*!
  * Load an LLVM module from a file.
  */
-std::unique_ptr<llvm::Module> load_llvm_module(std::string const& filename)
+std::unique_ptr<llvm::Module>
+load_llvm_module(std::string const& filename, llvm::LLVMContext& context)
 {
     llvm::SMDiagnostic err;
-    auto module = llvm::parseIRFile(filename, err, context());
+    auto module = llvm::parseIRFile(filename, err, context);
     if (!module)
     {
         err.print("qiree", llvm::errs());
@@ -80,6 +73,20 @@ llvm::Function* find_entry_point(llvm::Module& m)
     return nullptr;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Find the QIR entry point or throw.
+ */
+llvm::Function* require_entry_point(llvm::Module& m)
+{
+    llvm::Function* result = find_entry_point(m);
+    QIREE_VALIDATE(result,
+                   << "no function with QIR 'entry_point' attribute "
+                      "exists in '"
+                   << m.getSourceFileName() << "'");
+    return result;
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Interpret a string attribute as a certain type.
@@ -104,13 +111,7 @@ void attr_get_to(llvm::Attribute const& attr, T& dest)
 Module::Module(UPModule&& module) : module_{std::move(module)}
 {
     QIREE_EXPECT(module_);
-
-    // Search for entry point
-    entrypoint_ = find_entry_point(*module_);
-    QIREE_VALIDATE(entrypoint_,
-                   << "no function with QIR 'entry_point' attribute "
-                      "exists in '"
-                   << module_->getSourceFileName() << "'");
+    entrypoint_ = require_entry_point(*module_);
 }
 
 //---------------------------------------------------------------------------//
@@ -118,8 +119,11 @@ Module::Module(UPModule&& module) : module_{std::move(module)}
  * Construct with an LLVM IR file (bitcode or disassembled).
  */
 Module::Module(std::string const& filename)
-    : Module{load_llvm_module(filename)}
+    : context_{std::make_unique<llvm::LLVMContext>()}
+    , module_{load_llvm_module(filename, *context_)}
 {
+    QIREE_EXPECT(module_);
+    entrypoint_ = require_entry_point(*module_);
 }
 
 //---------------------------------------------------------------------------//
@@ -127,7 +131,8 @@ Module::Module(std::string const& filename)
  * Construct with an LLVM IR file (bitcode or disassembled) and entry point.
  */
 Module::Module(std::string const& filename, std::string const& entrypoint)
-    : module_{load_llvm_module(filename)}
+    : context_{std::make_unique<llvm::LLVMContext>()}
+    , module_{load_llvm_module(filename, *context_)}
 {
     QIREE_EXPECT(module_);
 
@@ -137,11 +142,54 @@ Module::Module(std::string const& filename, std::string const& entrypoint)
                    << "no entrypoint function '" << entrypoint << "' exists");
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from LLVM IR (bitcode or disassembled) held in memory.
+ *
+ * The name identifies the module in diagnostics, which are included in the
+ * exception message if the contents cannot be parsed.
+ */
+Module Module::from_buffer(std::string_view contents, std::string const& name)
+{
+    Module result;
+    result.context_ = std::make_unique<llvm::LLVMContext>();
+
+    // The text IR parser requires a null-terminated buffer
+    auto buffer = llvm::MemoryBuffer::getMemBufferCopy(
+        llvm::StringRef{contents.data(), contents.size()}, name);
+    llvm::SMDiagnostic err;
+    result.module_
+        = llvm::parseIR(buffer->getMemBufferRef(), err, *result.context_);
+    if (!result.module_)
+    {
+        std::string msg;
+        llvm::raw_string_ostream os{msg};
+        err.print("qiree", os);
+        QIREE_VALIDATE(result.module_,
+                       << "failed to read QIR input '" << name
+                       << "': " << os.str());
+    }
+    result.entrypoint_ = require_entry_point(*result.module_);
+    return result;
+}
+
 //---------------------------------------------------------------------------//
 Module::Module() = default;
 Module::~Module() = default;
 Module::Module(Module&&) = default;
-Module& Module::operator=(Module&&) = default;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move-assign, destroying the previous module before its context.
+ */
+Module& Module::operator=(Module&& other)
+{
+    Module temp{std::move(other)};
+    std::swap(context_, temp.context_);
+    std::swap(module_, temp.module_);
+    std::swap(entrypoint_, temp.entrypoint_);
+    return *this;
+}
 
 //---------------------------------------------------------------------------//
 /*!
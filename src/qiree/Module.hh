@@ -8,13 +8,16 @@
 #pragma once
 
 #include <memory>
+#include <string>
+#include <string_view>
 
 #include "Types.hh"
 
 namespace llvm
 {
-class Module;
 class Function;
+class LLVMContext;
+class Module;
 }  // namespace llvm
 
 namespace qiree
@@ -22,6 +25,11 @@ namespace qiree
 //---------------------------------------------------------------------------//
 /*!
  * Load a QIR LLVM module.
+ *
+ * A module read from a file owns the LLVM context it is parsed into, and the
+ * context is handed to the \c Executor along with the module. Since no LLVM
+ * state is shared between modules, the next input can be loaded on a
+ * separate thread while the current one executes.
  */
 class Module
 {
@@ -29,6 +37,7 @@ class Module
     //!@{
     //! \name Type aliases
     using UPModule = std::unique_ptr<llvm::Module>;
+    using UPContext = std::unique_ptr<llvm::LLVMContext>;
     //!@}
 
   public:
@@ -51,6 +60,10 @@ class Module
     // Construct with an LLVM IR file (bitcode or disassembled) and entry point
     Module(std::string const& filename, std::string const& entrypoint);
 
+    // Construct from LLVM IR (bitcode or disassembled) held in memory
+    static Module
+    from_buffer(std::string_view contents, std::string const& name);
+
     // Process entry point attributes
     EntryPointAttrs load_entry_point_attrs() const;
 
@@ -61,7 +74,9 @@ class Module
     explicit operator bool() const { return static_cast<bool>(module_); }
 
   private:
-    std::unique_ptr<llvm::Module> module_;
+    // The context must outlive the module
+    UPContext context_;
+    UPModule module_;
     llvm::Function* entrypoint_{nullptr};
 
     // Make Executor a friend so it can take ownership of the pointer
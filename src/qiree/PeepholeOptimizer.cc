@@ -0,0 +1,586 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PeepholeOptimizer.cc
+//---------------------------------------------------------------------------//
+#include "PeepholeOptimizer.hh"
+
+#include <cmath>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Pauli algebra that a gate acts in on one of its qubits
+enum class Axis
+{
+    general,
+    x,
+    y,
+    z
+};
+
+//---------------------------------------------------------------------------//
+//! Whether a gate is unchanged when its two qubits are exchanged
+bool is_symmetric(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::cz:
+        case GateOp::swap:
+        case GateOp::rxx:
+        case GateOp::ryy:
+        case GateOp::rzz:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//---------------------------------------------------------------------------//
+//! Whether a gate is a rotation whose angles add
+bool is_rotation(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::r:
+        case GateOp::rx:
+        case GateOp::rxx:
+        case GateOp::ry:
+        case GateOp::ryy:
+        case GateOp::rz:
+        case GateOp::rzz:
+            return true;
+        default:
+            return false;
+    }
+}
+
+//---------------------------------------------------------------------------//
+//! Get the inverse of a fixed gate, or \c size_ if it has none here
+GateOp inverse(GateOp op)
+{
+    switch (op)
+    {
+        case GateOp::cnot:
+        case GateOp::cx:
+        case GateOp::cy:
+        case GateOp::cz:
+        case GateOp::h:
+        case GateOp::swap:
+        case GateOp::x:
+        case GateOp::y:
+        case GateOp::z:
+            return op;
+        case GateOp::s:
+            return GateOp::s_adj;
+        case GateOp::s_adj:
+            return GateOp::s;
+        case GateOp::t:
+            return GateOp::t_adj;
+        case GateOp::t_adj:
+            return GateOp::t;
+        default:
+            return GateOp::size_;
+    }
+}
+
+//---------------------------------------------------------------------------//
+//! Whether two gates are the same controlled-X
+bool is_cnot(GateOp op)
+{
+    return op == GateOp::cnot || op == GateOp::cx;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the backend and options.
+ */
+PeepholeOptimizer::PeepholeOptimizer(QuantumInterface& target,
+                                     Options const& opts)
+    : target_{target}, opts_{opts}
+{
+    QIREE_VALIDATE(opts_.angle_tolerance >= 0,
+                   << "invalid angle tolerance " << opts_.angle_tolerance);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the backend and default options.
+ */
+PeepholeOptimizer::PeepholeOptimizer(QuantumInterface& target)
+    : PeepholeOptimizer{target, Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply all pending gates to the backend.
+ */
+void PeepholeOptimizer::flush()
+{
+    for (Gate const& g : pending_)
+    {
+        this->emit(g);
+    }
+    pending_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare to build a quantum circuit for an entry point.
+ */
+void PeepholeOptimizer::set_up(EntryPointAttrs const& attrs)
+{
+    pending_.clear();
+    target_.set_up(attrs);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the remaining gates and complete an execution.
+ */
+void PeepholeOptimizer::tear_down()
+{
+    this->flush();
+    target_.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available.
+ *
+ * New qubits start in |0> and do not interact with the pending gates, so the
+ * request is forwarded without flushing.
+ */
+void PeepholeOptimizer::reserve_qubits(size_type num_qubits)
+{
+    target_.reserve_qubits(num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Pass a result's qubit label to the backend.
+ */
+void PeepholeOptimizer::label_result(Result r, Qubit q)
+{
+    target_.label_result(r, q);
+}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+Result PeepholeOptimizer::m(Qubit q)
+{
+    return this->flushed().m(q);
+}
+Result PeepholeOptimizer::measure(Array paulis, Array qubits)
+{
+    return this->flushed().measure(paulis, qubits);
+}
+Result PeepholeOptimizer::mresetz(Qubit q)
+{
+    return this->flushed().mresetz(q);
+}
+void PeepholeOptimizer::mz(Qubit q, Result r)
+{
+    return this->flushed().mz(q, r);
+}
+QState PeepholeOptimizer::read_result(Result r)
+{
+    return this->flushed().read_result(r);
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+void PeepholeOptimizer::ccx(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::ccx, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::cnot(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::cnot, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::cx(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::cx, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::cy(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::cy, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::cz(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::cz, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::exp_adj(Array paulis, double theta, Array qubits)
+{
+    return this->flushed().exp_adj(paulis, theta, qubits);
+}
+void PeepholeOptimizer::exp(Array paulis, double theta, Array qubits)
+{
+    return this->flushed().exp(paulis, theta, qubits);
+}
+void PeepholeOptimizer::exp(Array ctls, Tuple args)
+{
+    return this->flushed().exp(ctls, args);
+}
+void PeepholeOptimizer::exp_adj(Array ctls, Tuple args)
+{
+    return this->flushed().exp_adj(ctls, args);
+}
+void PeepholeOptimizer::h(Qubit q)
+{
+    this->push({GateOp::h, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::h(Array ctls, Qubit q)
+{
+    return this->flushed().h(ctls, q);
+}
+void PeepholeOptimizer::r_adj(Pauli p, double theta, Qubit q)
+{
+    // Store the adjoint as a rotation by the opposite angle so they merge
+    this->push({GateOp::r, {static_cast<size_type>(p), q.value}, -theta});
+}
+void PeepholeOptimizer::r(Pauli p, double theta, Qubit q)
+{
+    this->push({GateOp::r, {static_cast<size_type>(p), q.value}, theta});
+}
+void PeepholeOptimizer::r(Array ctls, Tuple args)
+{
+    return this->flushed().r(ctls, args);
+}
+void PeepholeOptimizer::r_adj(Array ctls, Tuple args)
+{
+    return this->flushed().r_adj(ctls, args);
+}
+void PeepholeOptimizer::reset(Qubit q)
+{
+    return this->flushed().reset(q);
+}
+void PeepholeOptimizer::rx(double theta, Qubit q)
+{
+    this->push({GateOp::rx, {q.value, 0}, theta});
+}
+void PeepholeOptimizer::rx(Array ctls, Tuple args)
+{
+    return this->flushed().rx(ctls, args);
+}
+void PeepholeOptimizer::rxx(double theta, Qubit q1, Qubit q2)
+{
+    this->push({GateOp::rxx, {q1.value, q2.value}, theta});
+}
+void PeepholeOptimizer::ry(double theta, Qubit q)
+{
+    this->push({GateOp::ry, {q.value, 0}, theta});
+}
+void PeepholeOptimizer::ry(Array ctls, Tuple args)
+{
+    return this->flushed().ry(ctls, args);
+}
+void PeepholeOptimizer::ryy(double theta, Qubit q1, Qubit q2)
+{
+    this->push({GateOp::ryy, {q1.value, q2.value}, theta});
+}
+void PeepholeOptimizer::rz(double theta, Qubit q)
+{
+    this->push({GateOp::rz, {q.value, 0}, theta});
+}
+void PeepholeOptimizer::rz(Array ctls, Tuple args)
+{
+    return this->flushed().rz(ctls, args);
+}
+void PeepholeOptimizer::rzz(double theta, Qubit q1, Qubit q2)
+{
+    this->push({GateOp::rzz, {q1.value, q2.value}, theta});
+}
+void PeepholeOptimizer::s_adj(Qubit q)
+{
+    this->push({GateOp::s_adj, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::s(Qubit q)
+{
+    this->push({GateOp::s, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::s(Array ctls, Qubit q)
+{
+    return this->flushed().s(ctls, q);
+}
+void PeepholeOptimizer::s_adj(Array ctls, Qubit q)
+{
+    return this->flushed().s_adj(ctls, q);
+}
+void PeepholeOptimizer::swap(Qubit q1, Qubit q2)
+{
+    this->push({GateOp::swap, {q1.value, q2.value}, 0});
+}
+void PeepholeOptimizer::t_adj(Qubit q)
+{
+    this->push({GateOp::t_adj, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::t(Qubit q)
+{
+    this->push({GateOp::t, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::t(Array ctls, Qubit q)
+{
+    return this->flushed().t(ctls, q);
+}
+void PeepholeOptimizer::t_adj(Array ctls, Qubit q)
+{
+    return this->flushed().t_adj(ctls, q);
+}
+void PeepholeOptimizer::x(Qubit q)
+{
+    this->push({GateOp::x, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::x(Array ctls, Qubit q)
+{
+    return this->flushed().x(ctls, q);
+}
+void PeepholeOptimizer::y(Qubit q)
+{
+    this->push({GateOp::y, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::y(Array ctls, Qubit q)
+{
+    return this->flushed().y(ctls, q);
+}
+void PeepholeOptimizer::z(Qubit q)
+{
+    this->push({GateOp::z, {q.value, 0}, 0});
+}
+void PeepholeOptimizer::z(Array ctls, Qubit q)
+{
+    return this->flushed().z(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// ASSERTIONS
+//---------------------------------------------------------------------------//
+void PeepholeOptimizer::assertmeasurementprobability(Array paulis,
+                                                     Array qubits,
+                                                     Result r,
+                                                     double prob,
+                                                     String msg,
+                                                     double tol)
+{
+    return this->flushed().assertmeasurementprobability(
+        paulis, qubits, r, prob, msg, tol);
+}
+void PeepholeOptimizer::assertmeasurementprobability(Array ctls, Tuple args)
+{
+    return this->flushed().assertmeasurementprobability(ctls, args);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Add a gate to the window, cancelling or merging it if possible.
+ *
+ * The window is searched from the newest gate backward. Gates on other qubits
+ * and gates that commute with the new one are skipped; the first remaining
+ * gate is the only candidate for cancellation or merging.
+ */
+void PeepholeOptimizer::push(Gate g)
+{
+    ++counters_.gates;
+    if (opts_.window == 0)
+    {
+        this->emit(g);
+        return;
+    }
+
+    // Qubits and per-qubit action of a gate
+    auto num_qubits = [](Gate const& gate) {
+        return num_args(gate.op) - (gate.op == GateOp::r ? 1 : 0);
+    };
+    auto qubit = [](Gate const& gate, int i) {
+        return gate.op == GateOp::r ? gate.qubits[1] : gate.qubits[i];
+    };
+    auto axis = [](Gate const& gate, int i) {
+        switch (gate.op)
+        {
+            case GateOp::z:
+            case GateOp::s:
+            case GateOp::s_adj:
+            case GateOp::t:
+            case GateOp::t_adj:
+            case GateOp::rz:
+            case GateOp::rzz:
+            case GateOp::cz:
+                return Axis::z;
+            case GateOp::x:
+            case GateOp::rx:
+            case GateOp::rxx:
+                return Axis::x;
+            case GateOp::y:
+            case GateOp::ry:
+            case GateOp::ryy:
+                return Axis::y;
+            case GateOp::cnot:
+            case GateOp::cx:
+                return i == 0 ? Axis::z : Axis::x;
+            case GateOp::cy:
+                return i == 0 ? Axis::z : Axis::y;
+            case GateOp::r:
+                switch (static_cast<Pauli>(gate.qubits[0]))
+                {
+                    case Pauli::x:
+                        return Axis::x;
+                    case Pauli::y:
+                        return Axis::y;
+                    case Pauli::z:
+                        return Axis::z;
+                    default:
+                        return Axis::general;
+                }
+            default:
+                return Axis::general;
+        }
+    };
+
+    // Check shared qubits: whether any is shared and all commute
+    auto overlap = [&](Gate const& a, Gate const& b, bool* commutes) {
+        bool shared = false;
+        *commutes = true;
+        for (int i = 0; i != num_qubits(a); ++i)
+        {
+            for (int j = 0; j != num_qubits(b); ++j)
+            {
+                if (qubit(a, i) != qubit(b, j))
+                    continue;
+                shared = true;
+                Axis ax = axis(a, i);
+                if (ax == Axis::general || ax != axis(b, j))
+                {
+                    *commutes = false;
+                }
+            }
+        }
+        return shared;
+    };
+
+    // Whether two gates act on the same qubits in an equivalent order
+    auto same_qubits = [&](Gate const& a, Gate const& b) {
+        if (a.op == GateOp::r && a.qubits[0] != b.qubits[0])
+        {
+            // Different Pauli axes
+            return false;
+        }
+        if (num_qubits(a) == 1)
+        {
+            return qubit(a, 0) == qubit(b, 0);
+        }
+        if (a.qubits[0] == b.qubits[0] && a.qubits[1] == b.qubits[1])
+        {
+            return true;
+        }
+        return is_symmetric(a.op) && a.qubits[0] == b.qubits[1]
+               && a.qubits[1] == b.qubits[0];
+    };
+
+    for (auto iter = pending_.end(); iter != pending_.begin();)
+    {
+        --iter;
+        Gate& prev = *iter;
+        bool commutes{};
+        if (!overlap(prev, g, &commutes))
+            continue;
+
+        bool const inverts = inverse(prev.op) == g.op
+                             || (is_cnot(prev.op) && is_cnot(g.op));
+        if (inverts && same_qubits(prev, g))
+        {
+            pending_.erase(iter);
+            ++counters_.cancelled;
+            counters_.removed += 2;
+            return;
+        }
+        if (prev.op == g.op && is_rotation(g.op) && same_qubits(prev, g))
+        {
+            prev.angle += g.angle;
+            ++counters_.merged;
+            counters_.removed += 1;
+            constexpr double two_pi = 6.28318530717958647692;
+            if (std::fabs(std::remainder(prev.angle, two_pi))
+                <= opts_.angle_tolerance)
+            {
+                // Full turn: only a global phase remains
+                pending_.erase(iter);
+                counters_.removed += 1;
+            }
+            return;
+        }
+        if (!commutes)
+            break;
+    }
+
+    if (pending_.size() >= opts_.window)
+    {
+        this->emit(pending_.front());
+        pending_.pop_front();
+    }
+    pending_.push_back(g);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a gate to the backend.
+ */
+void PeepholeOptimizer::emit(Gate const& g)
+{
+    Qubit q0{g.qubits[0]};
+    Qubit q1{g.qubits[1]};
+    switch (g.op)
+    {
+        // clang-format off
+        case GateOp::ccx: return target_.ccx(q0, q1);
+        case GateOp::cnot: return target_.cnot(q0, q1);
+        case GateOp::cx: return target_.cx(q0, q1);
+        case GateOp::cy: return target_.cy(q0, q1);
+        case GateOp::cz: return target_.cz(q0, q1);
+        case GateOp::h: return target_.h(q0);
+        case GateOp::r:
+            return target_.r(static_cast<Pauli>(g.qubits[0]), g.angle, q1);
+        case GateOp::rx: return target_.rx(g.angle, q0);
+        case GateOp::rxx: return target_.rxx(g.angle, q0, q1);
+        case GateOp::ry: return target_.ry(g.angle, q0);
+        case GateOp::ryy: return target_.ryy(g.angle, q0, q1);
+        case GateOp::rz: return target_.rz(g.angle, q0);
+        case GateOp::rzz: return target_.rzz(g.angle, q0, q1);
+        case GateOp::s: return target_.s(q0);
+        case GateOp::s_adj: return target_.s_adj(q0);
+        case GateOp::swap: return target_.swap(q0, q1);
+        case GateOp::t: return target_.t(q0);
+        case GateOp::t_adj: return target_.t_adj(q0);
+        case GateOp::x: return target_.x(q0);
+        case GateOp::y: return target_.y(q0);
+        case GateOp::z: return target_.z(q0);
+        default: QIREE_ASSERT_UNREACHABLE();
+        // clang-format on
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply all pending gates and get the backend.
+ */
+QuantumInterface& PeepholeOptimizer::flushed()
+{
+    this->flush();
+    return target_;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,175 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PeepholeOptimizer.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <deque>
+
+#include "GateTape.hh"
+#include "QuantumInterface.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Remove redundant gates before they reach a backend.
+ *
+ * This decorator sits between the \c Executor and any \c QuantumInterface
+ * and holds the most recent gates in a bounded window. An incoming gate is
+ * moved backward through the window past gates it commutes with, and then:
+ * - an inverse pair (\c h/h, \c s/s_adj, a repeated \c cnot, ...) is removed,
+ * - a rotation about the same axis on the same qubits has its angle added to
+ *   the earlier one (and both are removed if the sum is a full turn),
+ * - otherwise the gate is appended to the window.
+ *
+ * Two gates commute if on every qubit they share, both act in the algebra of
+ * the same Pauli: for example \c rz and \c t commute with the control of a
+ * \c cnot and with either qubit of a \c cz, and \c x commutes with the target
+ * of a \c cnot.
+ *
+ * When the window is full, its oldest gate is applied to the backend. The
+ * whole window is applied before any measurement, reset, unsupported
+ * instruction, or \c tear_down, so the backend sees the same program order
+ * around measurements. Runtime output is written after the measurements it
+ * reports, so results are complete when a runtime reads them.
+ *
+ * \code
+   PeepholeOptimizer opt(sim);
+   execute(opt, sim);
+   std::cout << opt.counters().removed << " gates removed\n";
+ * \endcode
+ */
+class PeepholeOptimizer final : virtual public QuantumInterface
+{
+  public:
+    //! Optimization options
+    struct Options
+    {
+        size_type window{32};  //!< Maximum number of pending gates
+        double angle_tolerance{1e-12};  //!< Remove rotations this small
+    };
+
+    //! Statistics about the optimization
+    struct Counters
+    {
+        size_type gates{0};  //!< Number of gates received
+        size_type removed{0};  //!< Number of gates not sent to the backend
+        size_type cancelled{0};  //!< Number of inverse pairs removed
+        size_type merged{0};  //!< Number of rotations merged
+    };
+
+  public:
+    // Construct with the backend and options
+    PeepholeOptimizer(QuantumInterface& target, Options const& opts);
+
+    // Construct with the backend and default options
+    explicit PeepholeOptimizer(QuantumInterface& target);
+
+    // Apply all pending gates to the backend
+    void flush();
+
+    //!@{
+    //! \name Accessors
+    Counters const& counters() const { return counters_; }
+    size_type num_pending() const { return pending_.size(); }
+    //!@}
+
+    //!@{
+    //! \name Executor setup/teardown
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    void reserve_qubits(size_type num_qubits) final;
+    void label_result(Result, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Assertions
+    void assertmeasurementprobability(
+        Array, Array, Result, double, String, double) final;
+    void assertmeasurementprobability(Array, Tuple) final;
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    //! Gate waiting in the window
+    struct Gate
+    {
+        GateOp op;
+        size_type qubits[2];
+        double angle;
+    };
+
+    //// DATA ////
+
+    QuantumInterface& target_;
+    Options opts_;
+    std::deque<Gate> pending_;
+    Counters counters_;
+
+    //// HELPER FUNCTIONS ////
+
+    void push(Gate g);
+    void emit(Gate const& g);
+    QuantumInterface& flushed();
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
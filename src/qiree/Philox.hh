@@ -0,0 +1,93 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Philox.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Philox4x32-10 counter-based random number generator.
+ *
+ * Each call maps a 128-bit counter to 128 random bits under a 64-bit key,
+ * as described by Salmon et al., "Parallel random numbers: as easy as 1, 2,
+ * 3" (SC11). There is no state to advance: any counter can be evaluated
+ * independently, so separate threads or shots that use distinct counters
+ * draw from non-overlapping streams without sharing or locking anything.
+ */
+class Philox4x32
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using key_type = std::uint64_t;
+    using counter_type = std::array<std::uint32_t, 4>;
+    using result_type = std::array<std::uint32_t, 4>;
+    //!@}
+
+  public:
+    //! Construct with a key (e.g. a seed)
+    explicit constexpr Philox4x32(key_type key) : key_{key} {}
+
+    // Generate random bits for a counter
+    inline constexpr result_type operator()(counter_type ctr) const;
+
+    // Generate random bits for a counter made of two 64-bit halves
+    inline constexpr result_type
+    operator()(std::uint64_t hi, std::uint64_t lo) const;
+
+  private:
+    key_type key_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Generate random bits for a counter.
+ */
+constexpr auto Philox4x32::operator()(counter_type ctr) const -> result_type
+{
+    constexpr std::uint64_t m0{0xD2511F53};
+    constexpr std::uint64_t m1{0xCD9E8D57};
+    constexpr std::uint32_t w0{0x9E3779B9};
+    constexpr std::uint32_t w1{0xBB67AE85};
+
+    auto k0 = static_cast<std::uint32_t>(key_);
+    auto k1 = static_cast<std::uint32_t>(key_ >> 32);
+    for (int round = 0; round != 10; ++round)
+    {
+        std::uint64_t const p0 = m0 * ctr[0];
+        std::uint64_t const p1 = m1 * ctr[2];
+        ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ k0,
+               static_cast<std::uint32_t>(p1),
+               static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ k1,
+               static_cast<std::uint32_t>(p0)};
+        k0 += w0;
+        k1 += w1;
+    }
+    return ctr;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Generate random bits for a counter made of two 64-bit halves.
+ */
+constexpr auto
+Philox4x32::operator()(std::uint64_t hi, std::uint64_t lo) const -> result_type
+{
+    return (*this)(counter_type{static_cast<std::uint32_t>(lo),
+                                static_cast<std::uint32_t>(lo >> 32),
+                                static_cast<std::uint32_t>(hi),
+                                static_cast<std::uint32_t>(hi >> 32)});
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
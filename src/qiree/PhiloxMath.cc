@@ -0,0 +1,82 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PhiloxMath.cc
+//---------------------------------------------------------------------------//
+#include "PhiloxMath.hh"
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Combine two 32-bit words of generator output
+std::uint64_t join(std::uint32_t hi, std::uint32_t lo)
+{
+    return (std::uint64_t{hi} << 32) | lo;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw a uniformly distributed integer in [lo, hi].
+ *
+ * Values that would bias the modulo are rejected; each generator evaluation
+ * provides two 64-bit candidates, so a second evaluation is almost never
+ * needed.
+ */
+std::int64_t PhiloxMath::drawrandomint(std::int64_t lo, std::int64_t hi)
+{
+    QIREE_VALIDATE(lo <= hi,
+                   << "invalid random integer range [" << lo << ", " << hi
+                   << "]");
+
+    // Number of possible values, which wraps to zero for the full range
+    std::uint64_t const span = static_cast<std::uint64_t>(hi)
+                               - static_cast<std::uint64_t>(lo) + 1;
+    // Smallest candidate that is not biased: 2^64 mod span
+    std::uint64_t const threshold = span == 0 ? 0 : (0 - span) % span;
+
+    while (true)
+    {
+        auto const bits = this->next();
+        for (std::uint64_t x :
+             {join(bits[1], bits[0]), join(bits[3], bits[2])})
+        {
+            if (x >= threshold)
+            {
+                std::uint64_t const offset = span == 0 ? x : x % span;
+                return static_cast<std::int64_t>(
+                    static_cast<std::uint64_t>(lo) + offset);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw a uniformly distributed real number in [lo, hi].
+ *
+ * The 53 high bits of one candidate are scaled so that both bounds can be
+ * drawn.
+ */
+double PhiloxMath::drawrandomdouble(double lo, double hi)
+{
+    QIREE_VALIDATE(lo <= hi,
+                   << "invalid random real range [" << lo << ", " << hi
+                   << "]");
+
+    constexpr double max_int53 = double((std::uint64_t{1} << 53) - 1);
+    auto const bits = this->next();
+    double const u = double(join(bits[1], bits[0]) >> 11) / max_int53;
+    return lo + (hi - lo) * u;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,88 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PhiloxMath.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+
+#include "MathInterface.hh"
+#include "Philox.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Draw random numbers for a QIR program from a counter-based generator.
+ *
+ * Every draw evaluates \c Philox4x32 keyed by the seed at the counter
+ * (shot, call index), where the call index counts generator evaluations
+ * since the start of the shot. The numbers drawn by a shot therefore depend
+ * only on the seed and the shot index: shots can run in any order, or on
+ * separate threads with one instance each, and still reproduce the same
+ * values.
+ *
+ * The caller selects the shot before each execution:
+ * \code
+   PhiloxMath math(seed);
+   for (size_type shot = 0; shot != num_shots; ++shot)
+   {
+       math.start_shot(shot);
+       execute(sim, sim, math);
+   }
+ * \endcode
+ */
+class PhiloxMath final : public MathInterface
+{
+  public:
+    // Construct with a random seed
+    explicit PhiloxMath(std::uint64_t seed) : philox_{seed} {}
+
+    // Restart the draws for a shot
+    inline void start_shot(size_type shot);
+
+    // Draw a uniformly distributed integer in [lo, hi]
+    std::int64_t drawrandomint(std::int64_t lo, std::int64_t hi) final;
+
+    // Draw a uniformly distributed real number in [lo, hi]
+    double drawrandomdouble(double lo, double hi) final;
+
+    //! Number of generator evaluations in the current shot
+    size_type num_calls() const { return call_; }
+
+  private:
+    Philox4x32 philox_;
+    size_type shot_{0};
+    size_type call_{0};
+
+    // Evaluate the generator at the next counter
+    inline Philox4x32::result_type next();
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Restart the draws for a shot.
+ */
+void PhiloxMath::start_shot(size_type shot)
+{
+    shot_ = shot;
+    call_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Evaluate the generator at the next counter.
+ */
+Philox4x32::result_type PhiloxMath::next()
+{
+    return philox_(shot_, call_++);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -52,6 +52,10 @@ class QuantumInterface
     virtual void set_up(EntryPointAttrs const&) = 0;
     //! Complete an execution
     virtual void tear_down() = 0;
+    //! Make qubits up to the given count available during an execution
+    virtual void reserve_qubits(size_type num_qubits) = 0;
+    //! Report a measured result under the program's qubit (default: ignore)
+    virtual void label_result(Result, Qubit) {}
     //@}
 
     //@{
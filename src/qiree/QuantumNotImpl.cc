@@ -12,6 +12,10 @@
 namespace qiree
 {
 //---------------------------------------------------------------------------//
+void QuantumNotImpl::reserve_qubits(size_type)
+{
+    QIREE_NOT_IMPLEMENTED("dynamic qubit allocation");
+}
 Result QuantumNotImpl::m(Qubit)
 {
     QIREE_NOT_IMPLEMENTED("quantum instruction 'm.body'");
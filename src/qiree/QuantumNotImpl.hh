@@ -18,6 +18,12 @@ namespace qiree
 class QuantumNotImpl : virtual public QuantumInterface
 {
   public:
+    //@{
+    //! \name Executor setup/teardown
+
+    void reserve_qubits(size_type) override;
+
+    //@}
     //@{
     //! \name Measurements
 
@@ -0,0 +1,69 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/QubitAllocator.cc
+//---------------------------------------------------------------------------//
+#include "QubitAllocator.hh"
+
+#include "Assert.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Start an execution with the given number of static qubits.
+ *
+ * Storage from earlier executions is kept.
+ */
+void QubitAllocator::reset(size_type num_static)
+{
+    num_static_ = num_static;
+    num_live_ = 0;
+    is_live_.clear();
+    free_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get an unused qubit.
+ */
+Qubit QubitAllocator::allocate()
+{
+    size_type index;
+    if (!free_.empty())
+    {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        index = is_live_.size();
+        is_live_.push_back(false);
+    }
+    QIREE_ASSERT(!is_live_[index]);
+    is_live_[index] = true;
+    ++num_live_;
+    return Qubit{num_static_ + index};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Return a qubit for reuse.
+ */
+void QubitAllocator::release(Qubit q)
+{
+    QIREE_VALIDATE(q.value >= num_static_
+                       && q.value - num_static_ < is_live_.size()
+                       && is_live_[q.value - num_static_],
+                   << "cannot release qubit " << q.value
+                   << ", which was not dynamically allocated");
+    size_type const index = q.value - num_static_;
+    is_live_[index] = false;
+    free_.push_back(index);
+    --num_live_;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,59 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/QubitAllocator.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <vector>
+
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Hand out qubit indices for dynamic qubit management.
+ *
+ * The first \c num_static qubits are the ones declared by the entry point's
+ * \c required_num_qubits attribute and are never handed out. Released
+ * indices go on a free list and are reused (most recently released first)
+ * before a new index is created, so the number of qubits a backend must
+ * simulate is the peak number live at once rather than the total number of
+ * allocations. That peak is the \c high_water mark.
+ *
+ * Per the QIR specification, a qubit must be in the |0> state (or have just
+ * been measured) when it is released. The allocator does not touch the
+ * quantum state: the executor resets each qubit as it is released.
+ */
+class QubitAllocator
+{
+  public:
+    // Start an execution with the given number of static qubits
+    void reset(size_type num_static);
+
+    // Get an unused qubit
+    Qubit allocate();
+
+    // Return a qubit for reuse
+    void release(Qubit q);
+
+    //!@{
+    //! \name Accessors
+    //! Number of dynamically allocated qubits in use
+    size_type num_live() const { return num_live_; }
+    //! Number of qubits (static and dynamic) that have ever been in use
+    size_type high_water() const { return num_static_ + is_live_.size(); }
+    //!@}
+
+  private:
+    size_type num_static_{0};
+    size_type num_live_{0};
+    std::vector<bool> is_live_;
+    std::vector<size_type> free_;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
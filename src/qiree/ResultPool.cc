@@ -0,0 +1,83 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultPool.cc
+//---------------------------------------------------------------------------//
+#include "ResultPool.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Start an execution with the given number of static results.
+ *
+ * All outcomes are cleared to |0>. Storage from earlier executions is kept.
+ */
+void ResultPool::reset(size_type num_static)
+{
+    num_static_ = num_static;
+    num_live_ = 0;
+    ref_counts_.clear();
+    free_.clear();
+    bits_.assign((num_static + 63) / 64, 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get an unused result in the |0> state.
+ */
+Result ResultPool::allocate()
+{
+    size_type index;
+    if (!free_.empty())
+    {
+        index = free_.back();
+        free_.pop_back();
+    }
+    else
+    {
+        index = ref_counts_.size();
+        ref_counts_.push_back(0);
+        bits_.resize((this->size() + 63) / 64, 0);
+    }
+    QIREE_ASSERT(ref_counts_[index] == 0);
+    ref_counts_[index] = 1;
+    ++num_live_;
+
+    Result result{num_static_ + index};
+    this->set(result, QState::zero);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a dynamic result.
+ *
+ * Static and constant results are not reference counted, so changes to them
+ * are ignored.
+ */
+void ResultPool::update_reference_count(Result r, count_type delta)
+{
+    if (is_constant(r) || r.value < num_static_)
+        return;
+
+    size_type const index = r.value - num_static_;
+    QIREE_VALIDATE(index < ref_counts_.size() && ref_counts_[index] > 0,
+                   << "cannot update the reference count of result "
+                   << r.value << ", which was not allocated");
+    count_type& count = ref_counts_[index];
+    count += delta;
+    QIREE_VALIDATE(count >= 0,
+                   << "reference count of result " << r.value
+                   << " became negative");
+    if (count == 0)
+    {
+        free_.push_back(index);
+        --num_live_;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,114 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultPool.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "Assert.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Hand out result identifiers and store measured outcomes.
+ *
+ * The first \c num_static results are the ones declared by the entry point's
+ * \c required_num_results attribute: they always exist and are never
+ * recycled. Results created by \c m and \c mresetz are allocated after them
+ * with a reference count of one; when the program drops the count to zero,
+ * the identifier goes on a free list and is reused by the next allocation.
+ *
+ * Outcomes are stored one bit per result, and reference counts in a flat
+ * array, so no object is allocated per result. The constant results returned
+ * by \c __quantum__rt__result_get_zero and \c result_get_one are the
+ * sentinel identifiers \c zero() and \c one() , which need no storage.
+ */
+class ResultPool
+{
+  public:
+    //! Reference count change
+    using count_type = std::int32_t;
+
+    //! Constant result that always reads as |0>
+    static constexpr Result zero() { return Result{~size_type(1)}; }
+    //! Constant result that always reads as |1>
+    static constexpr Result one() { return Result{~size_type(0)}; }
+
+    //! Whether a result is one of the constants
+    static constexpr bool is_constant(Result r)
+    {
+        return r.value >= zero().value;
+    }
+
+  public:
+    // Start an execution with the given number of static results
+    void reset(size_type num_static);
+
+    // Get an unused result in the |0> state
+    Result allocate();
+
+    // Change the reference count of a dynamic result
+    void update_reference_count(Result r, count_type delta);
+
+    // Get the stored outcome of a result
+    inline QState operator[](Result r) const;
+
+    // Store the outcome of a result
+    inline void set(Result r, QState value);
+
+    //! Whether two results have the same outcome
+    bool equal(Result a, Result b) const { return (*this)[a] == (*this)[b]; }
+
+    //!@{
+    //! \name Accessors
+    //! Number of result identifiers (static and dynamic) that exist
+    size_type size() const { return num_static_ + ref_counts_.size(); }
+    //! Number of dynamic results still referenced
+    size_type num_live() const { return num_live_; }
+    //!@}
+
+  private:
+    size_type num_static_{0};
+    size_type num_live_{0};
+    std::vector<count_type> ref_counts_;
+    std::vector<size_type> free_;
+    std::vector<std::uint64_t> bits_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the stored outcome of a result.
+ */
+QState ResultPool::operator[](Result r) const
+{
+    if (is_constant(r))
+    {
+        return static_cast<QState>(r.value == one().value);
+    }
+    QIREE_EXPECT(r.value < this->size());
+    return static_cast<QState>((bits_[r.value / 64] >> (r.value % 64)) & 1);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Store the outcome of a result.
+ */
+void ResultPool::set(Result r, QState value)
+{
+    QIREE_EXPECT(!is_constant(r) && r.value < this->size());
+    std::uint64_t const mask = std::uint64_t(1) << (r.value % 64);
+    std::uint64_t& word = bits_[r.value / 64];
+    word = (value == QState::one ? word | mask : word & ~mask);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,352 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.cc
+//---------------------------------------------------------------------------//
+#include "ResultSink.hh"
+
+#include <cstdio>
+
+#include "Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Append an unsigned integer in decimal
+void append_decimal(std::string* s, size_type value)
+{
+    char buf[24];
+    int len = std::snprintf(
+        buf, sizeof(buf), "%llu", static_cast<unsigned long long>(value));
+    s->append(buf, len);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a sink of the given format.
+ */
+std::unique_ptr<ResultSink>
+ResultSink::from_format(ResultFormat fmt, std::ostream& os)
+{
+    switch (fmt)
+    {
+        case ResultFormat::text:
+            return std::make_unique<TextResultSink>(os);
+        case ResultFormat::jsonl:
+            return std::make_unique<JsonResultSink>(os);
+        case ResultFormat::binary:
+            return std::make_unique<BinaryResultSink>(os);
+        default:
+            QIREE_ASSERT_UNREACHABLE();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write the measured bits of every shot, packed contiguously.
+ *
+ * Bit \em j of shot \em s is bit <code>s * num_bits + j</code> of \c words,
+ * which has \c num_shot_words(num_shots, num_bits) elements. Formats that
+ * only report counts ignore the shots.
+ */
+void ResultSink::shots(size_type, size_type, std::uint64_t const*) {}
+
+//---------------------------------------------------------------------------//
+// TEXT
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the output stream.
+ */
+TextResultSink::TextResultSink(std::ostream& os) : os_{os} {}
+
+void TextResultSink::begin(EntryPointAttrs const&) {}
+
+void TextResultSink::record(Qubit q,
+                            OptionalCString tag,
+                            size_type zeros,
+                            size_type ones)
+{
+    buffer_ += "qubit ";
+    append_decimal(&buffer_, q.value);
+    buffer_ += " experiment ";
+    buffer_ += (tag ? tag : "<null>");
+    buffer_ += ": {0: ";
+    append_decimal(&buffer_, zeros);
+    buffer_ += ", 1: ";
+    append_decimal(&buffer_, ones);
+    buffer_ += "}\n";
+}
+
+void TextResultSink::error(std::string_view message)
+{
+    buffer_ += message;
+    buffer_ += '\n';
+}
+
+void TextResultSink::end()
+{
+    os_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+//---------------------------------------------------------------------------//
+// JSON LINES
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the output stream.
+ */
+JsonResultSink::JsonResultSink(std::ostream& os) : os_{os} {}
+
+void JsonResultSink::begin(EntryPointAttrs const& attrs)
+{
+    labeled_ = !attrs.output_labeling_schema.empty();
+    buffer_ += R"({"type":"begin","schema":)";
+    this->append_string(attrs.output_labeling_schema);
+    buffer_ += R"(,"profiles":)";
+    this->append_string(attrs.qir_profiles);
+    buffer_ += "}\n";
+}
+
+void JsonResultSink::record(Qubit q,
+                            OptionalCString tag,
+                            size_type zeros,
+                            size_type ones)
+{
+    buffer_ += R"({"type":"result","qubit":)";
+    append_decimal(&buffer_, q.value);
+    if (labeled_ && tag)
+    {
+        buffer_ += R"(,"tag":)";
+        this->append_string(tag);
+    }
+    buffer_ += R"(,"counts":[)";
+    append_decimal(&buffer_, zeros);
+    buffer_ += ',';
+    append_decimal(&buffer_, ones);
+    buffer_ += "]}\n";
+}
+
+void JsonResultSink::shots(size_type num_shots,
+                           size_type num_bits,
+                           std::uint64_t const* words)
+{
+    buffer_ += R"({"type":"shots","num_shots":)";
+    append_decimal(&buffer_, num_shots);
+    buffer_ += R"(,"num_bits":)";
+    append_decimal(&buffer_, num_bits);
+    buffer_ += R"(,"words":[)";
+    size_type const num_words = num_shot_words(num_shots, num_bits);
+    for (size_type i = 0; i != num_words; ++i)
+    {
+        char buf[20];
+        int len = std::snprintf(buf,
+                                sizeof(buf),
+                                "\"%llx\"",
+                                static_cast<unsigned long long>(words[i]));
+        if (i != 0)
+        {
+            buffer_ += ',';
+        }
+        buffer_.append(buf, len);
+    }
+    buffer_ += "]}\n";
+}
+
+void JsonResultSink::error(std::string_view message)
+{
+    buffer_ += R"({"type":"error","message":)";
+    this->append_string(message);
+    buffer_ += "}\n";
+}
+
+void JsonResultSink::end()
+{
+    buffer_ += "{\"type\":\"end\"}\n";
+    os_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Append a quoted and escaped JSON string.
+ */
+void JsonResultSink::append_string(std::string_view s)
+{
+    append_json_string(s, &buffer_);
+}
+
+//---------------------------------------------------------------------------//
+// BINARY
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the output stream.
+ */
+BinaryResultSink::BinaryResultSink(std::ostream& os) : os_{os} {}
+
+void BinaryResultSink::begin(EntryPointAttrs const& attrs)
+{
+    if (!wrote_header_)
+    {
+        buffer_ += "QIRR";
+        this->append_u32(version);
+        wrote_header_ = true;
+    }
+    labeled_ = !attrs.output_labeling_schema.empty();
+    buffer_ += 'B';
+    this->append_string(attrs.output_labeling_schema);
+    this->append_string(attrs.qir_profiles);
+}
+
+void BinaryResultSink::record(Qubit q,
+                              OptionalCString tag,
+                              size_type zeros,
+                              size_type ones)
+{
+    buffer_ += 'R';
+    this->append_u64(q.value);
+    this->append_u64(zeros);
+    this->append_u64(ones);
+    this->append_string(labeled_ && tag ? tag : "");
+}
+
+void BinaryResultSink::shots(size_type num_shots,
+                             size_type num_bits,
+                             std::uint64_t const* words)
+{
+    QIREE_EXPECT(num_bits <= 0xffffffffu);
+    buffer_ += 'S';
+    this->append_u64(num_shots);
+    this->append_u32(static_cast<std::uint32_t>(num_bits));
+    size_type const num_words = num_shot_words(num_shots, num_bits);
+    for (size_type i = 0; i != num_words; ++i)
+    {
+        this->append_u64(words[i]);
+    }
+}
+
+void BinaryResultSink::error(std::string_view message)
+{
+    buffer_ += 'X';
+    this->append_string(message);
+}
+
+void BinaryResultSink::end()
+{
+    buffer_ += 'E';
+    os_.write(buffer_.data(), buffer_.size());
+    buffer_.clear();
+}
+
+void BinaryResultSink::append_u32(std::uint32_t value)
+{
+    for (int i = 0; i != 4; ++i)
+    {
+        buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+void BinaryResultSink::append_u64(std::uint64_t value)
+{
+    for (int i = 0; i != 8; ++i)
+    {
+        buffer_ += static_cast<char>((value >> (8 * i)) & 0xff);
+    }
+}
+
+void BinaryResultSink::append_string(std::string_view s)
+{
+    QIREE_EXPECT(s.size() <= 0xffffffffu);
+    this->append_u32(static_cast<std::uint32_t>(s.size()));
+    buffer_ += s;
+}
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the name of an output format.
+ */
+char const* to_cstring(ResultFormat fmt)
+{
+    switch (fmt)
+    {
+        case ResultFormat::text:
+            return "text";
+        case ResultFormat::jsonl:
+            return "jsonl";
+        case ResultFormat::binary:
+            return "binary";
+        default:
+            return "";
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Append a string to a buffer as a quoted and escaped JSON string.
+ */
+void append_json_string(std::string_view s, std::string* buffer)
+{
+    QIREE_EXPECT(buffer);
+    *buffer += '"';
+    for (char c : s)
+    {
+        switch (c)
+        {
+            case '"':
+                *buffer += "\\\"";
+                break;
+            case '\\':
+                *buffer += "\\\\";
+                break;
+            case '\n':
+                *buffer += "\\n";
+                break;
+            case '\t':
+                *buffer += "\\t";
+                break;
+            default:
+                if (static_cast<unsigned char>(c) < 0x20)
+                {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    *buffer += buf;
+                }
+                else
+                {
+                    *buffer += c;
+                }
+        }
+    }
+    *buffer += '"';
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get an output format from its name.
+ */
+ResultFormat to_result_format(std::string_view name)
+{
+    for (int i = 0; i != static_cast<int>(ResultFormat::size_); ++i)
+    {
+        auto fmt = static_cast<ResultFormat>(i);
+        if (name == to_cstring(fmt))
+        {
+            return fmt;
+        }
+    }
+    QIREE_VALIDATE(false,
+                   << "invalid output format '" << name
+                   << "' (expected text, jsonl, or binary)");
+    return ResultFormat::size_;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,216 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+//! Output format of a result sink
+enum class ResultFormat
+{
+    text,  //!< Human-readable lines (the historical output)
+    jsonl,  //!< One JSON object per line
+    binary,  //!< Compact little-endian records
+    size_
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Destination for the program output written by a runtime implementation.
+ *
+ * A \c RuntimeInterface implementation calls \c begin with the entry point
+ * attributes once the results of an execution are available, then one
+ * \c record per recorded result, and finally \c end. Optionally it may pass
+ * the individual shots as bit-packed records.
+ *
+ * Result tags are only written by structured formats when the entry point
+ * declares an \c output_labeling_schema ; the schema name itself is written
+ * at the start of each execution.
+ *
+ * Sinks accumulate an execution's output in memory and write it to the
+ * stream in a single call at \c end . They never flush the stream: that is
+ * left to the caller (or to the stream's destruction).
+ */
+class ResultSink
+{
+  public:
+    // Create a sink of the given format
+    static std::unique_ptr<ResultSink>
+    from_format(ResultFormat fmt, std::ostream& os);
+
+    virtual ~ResultSink() = default;
+
+    //! Start the output of an execution
+    virtual void begin(EntryPointAttrs const& attrs) = 0;
+
+    //! Write the counts of one recorded result
+    virtual void
+    record(Qubit q, OptionalCString tag, size_type zeros, size_type ones)
+        = 0;
+
+    // Write the measured bits of every shot, packed contiguously
+    virtual void shots(size_type num_shots,
+                       size_type num_bits,
+                       std::uint64_t const* words);
+
+    //! Report that an execution failed
+    virtual void error(std::string_view message) = 0;
+
+    //! Complete the output of an execution
+    virtual void end() = 0;
+
+  protected:
+    ResultSink() = default;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write results as human-readable lines.
+ *
+ * Each record is written as
+ * \verbatim
+qubit 0 experiment <null>: {0: 512, 1: 488}
+ * \endverbatim
+ * regardless of the labeling schema.
+ */
+class TextResultSink final : public ResultSink
+{
+  public:
+    // Construct with the output stream
+    explicit TextResultSink(std::ostream& os);
+
+    void begin(EntryPointAttrs const& attrs) final;
+    void record(Qubit q,
+                OptionalCString tag,
+                size_type zeros,
+                size_type ones) final;
+    void error(std::string_view message) final;
+    void end() final;
+
+  private:
+    std::ostream& os_;
+    std::string buffer_;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write results as JSON lines.
+ *
+ * Each execution writes a \c begin object with the labeling schema and
+ * profiles, one \c result object per record, and an \c end object:
+ * \verbatim
+{"type":"begin","schema":"labeled","profiles":"base_profile"}
+{"type":"result","qubit":0,"tag":"r0","counts":[512,488]}
+{"type":"end"}
+ * \endverbatim
+ * Per-shot records are written as \c shots objects whose \c words are
+ * hexadecimal strings, since JSON numbers cannot hold 64 bits exactly.
+ */
+class JsonResultSink final : public ResultSink
+{
+  public:
+    // Construct with the output stream
+    explicit JsonResultSink(std::ostream& os);
+
+    void begin(EntryPointAttrs const& attrs) final;
+    void record(Qubit q,
+                OptionalCString tag,
+                size_type zeros,
+                size_type ones) final;
+    void shots(size_type num_shots,
+               size_type num_bits,
+               std::uint64_t const* words) final;
+    void error(std::string_view message) final;
+    void end() final;
+
+  private:
+    std::ostream& os_;
+    std::string buffer_;
+    bool labeled_{false};
+
+    void append_string(std::string_view s);
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write results as compact binary records.
+ *
+ * The stream starts with the four bytes \c QIRR and a 32-bit format version.
+ * Each chunk then starts with a one-byte kind; integers are little-endian
+ * and strings are a 32-bit length followed by the bytes:
+ * - \c 'B' begin: schema string, profiles string
+ * - \c 'R' result: u64 qubit, u64 zero count, u64 one count, tag string
+ *   (empty when the program is unlabeled)
+ * - \c 'S' shots: u64 number of shots, u32 bits per shot, then the packed
+ *   shot words as u64
+ * - \c 'X' error: message string
+ * - \c 'E' end of execution
+ *
+ * Bit \em j of shot \em s is bit <code>s * num_bits + j</code> of the
+ * packed words.
+ */
+class BinaryResultSink final : public ResultSink
+{
+  public:
+    //! Format version written in the stream header
+    static constexpr std::uint32_t version = 1;
+
+    // Construct with the output stream
+    explicit BinaryResultSink(std::ostream& os);
+
+    void begin(EntryPointAttrs const& attrs) final;
+    void record(Qubit q,
+                OptionalCString tag,
+                size_type zeros,
+                size_type ones) final;
+    void shots(size_type num_shots,
+               size_type num_bits,
+               std::uint64_t const* words) final;
+    void error(std::string_view message) final;
+    void end() final;
+
+  private:
+    std::ostream& os_;
+    std::string buffer_;
+    bool labeled_{false};
+    bool wrote_header_{false};
+
+    void append_u32(std::uint32_t value);
+    void append_u64(std::uint64_t value);
+    void append_string(std::string_view s);
+};
+
+//---------------------------------------------------------------------------//
+// FREE FUNCTIONS
+//---------------------------------------------------------------------------//
+
+// Get the name of an output format
+char const* to_cstring(ResultFormat fmt);
+
+// Get an output format from its name
+ResultFormat to_result_format(std::string_view name);
+
+// Append a string to a buffer as a quoted and escaped JSON string
+void append_json_string(std::string_view s, std::string* buffer);
+
+// Number of 64-bit words needed to pack a number of shots
+inline size_type num_shot_words(size_type num_shots, size_type num_bits)
+{
+    return (num_shots * num_bits + 63) / 64;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -7,6 +7,8 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
+#include <cstdint>
+
 #include "Types.hh"
 
 namespace qiree
@@ -49,6 +51,18 @@ class RuntimeInterface
     //! No one uses tuples??
     virtual void tuple_record_output(size_type, OptionalCString tag) = 0;
 
+    //!@{
+    //! \name Results
+    //! Get a constant result that reads as |0>
+    virtual Result result_get_zero() = 0;
+    //! Get a constant result that reads as |1>
+    virtual Result result_get_one() = 0;
+    //! Whether two results have the same measured value
+    virtual bool result_equal(Result, Result) = 0;
+    //! Change the reference count of a result returned by \c m or \c mresetz
+    virtual void result_update_reference_count(Result, std::int32_t delta) = 0;
+    //!@}
+
   protected:
     virtual ~RuntimeInterface() = default;
 };
@@ -0,0 +1,232 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/RuntimeObjects.cc
+//---------------------------------------------------------------------------//
+#include "RuntimeObjects.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a change to a reference count and check that it stays valid.
+ */
+template<class T>
+bool release_reference(T& count, T delta, char const* kind)
+{
+    count += delta;
+    QIREE_VALIDATE(count >= 0,
+                   << "reference count of QIR " << kind
+                   << " became negative");
+    return count == 0;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a zero-initialized one-dimensional array.
+ */
+Array RuntimeObjects::array_create(size_type elem_size, size_type size)
+{
+    size_type const bytes = elem_size * size;
+    auto* h = static_cast<ArrayHeader*>(
+        arena_.allocate(sizeof(ArrayHeader) + bytes));
+    *h = {1, 0, elem_size, size};
+    Array result{reinterpret_cast<std::uintptr_t>(h)};
+    std::memset(data(result), 0, bytes);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Copy an array if forced or if it is aliased, else add a reference.
+ */
+Array RuntimeObjects::array_copy(Array arr, bool force)
+{
+    if (arr.value == 0)
+        return arr;
+
+    auto* h = header(arr);
+    if (!force && h->alias_count == 0)
+    {
+        ++h->ref_count;
+        return arr;
+    }
+    Array result = this->array_create(h->elem_size, h->size);
+    std::memcpy(data(result), data(arr), h->elem_size * h->size);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a new array with the elements of two arrays.
+ */
+Array RuntimeObjects::array_concatenate(Array first, Array second)
+{
+    auto const* h1 = header(first);
+    auto const* h2 = header(second);
+    QIREE_VALIDATE(h1->elem_size == h2->elem_size,
+                   << "cannot concatenate QIR arrays with element sizes "
+                   << h1->elem_size << " and " << h2->elem_size);
+
+    Array result = this->array_create(h1->elem_size, h1->size + h2->size);
+    size_type const bytes1 = h1->elem_size * h1->size;
+    std::memcpy(data(result), data(first), bytes1);
+    std::memcpy(data(result) + bytes1, data(second), h2->elem_size * h2->size);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of an array, releasing it at zero.
+ */
+void RuntimeObjects::update_reference_count(Array arr, count_type delta)
+{
+    if (arr.value == 0)
+        return;
+
+    auto* h = header(arr);
+    if (release_reference(h->ref_count, delta, "array"))
+    {
+        arena_.deallocate(h, sizeof(ArrayHeader) + h->elem_size * h->size);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the alias count of an array.
+ */
+void RuntimeObjects::update_alias_count(Array arr, count_type delta)
+{
+    if (arr.value == 0)
+        return;
+
+    auto* h = header(arr);
+    h->alias_count += delta;
+    QIREE_VALIDATE(h->alias_count >= 0,
+                   << "alias count of QIR array became negative");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a zero-initialized tuple with the given size in bytes.
+ */
+Tuple RuntimeObjects::tuple_create(size_type bytes)
+{
+    auto* h = static_cast<TupleHeader*>(
+        arena_.allocate(sizeof(TupleHeader) + bytes));
+    *h = {1, 0, bytes};
+    std::memset(h + 1, 0, bytes);
+    return Tuple{reinterpret_cast<std::uintptr_t>(h + 1)};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Copy a tuple if forced or if it is aliased, else add a reference.
+ */
+Tuple RuntimeObjects::tuple_copy(Tuple tup, bool force)
+{
+    if (tup.value == 0)
+        return tup;
+
+    auto* h = header(tup);
+    if (!force && h->alias_count == 0)
+    {
+        ++h->ref_count;
+        return tup;
+    }
+    Tuple result = this->tuple_create(h->size);
+    std::memcpy(reinterpret_cast<void*>(result.value), h + 1, h->size);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a tuple, releasing it at zero.
+ */
+void RuntimeObjects::update_reference_count(Tuple tup, count_type delta)
+{
+    if (tup.value == 0)
+        return;
+
+    auto* h = header(tup);
+    if (release_reference(h->ref_count, delta, "tuple"))
+    {
+        arena_.deallocate(h, sizeof(TupleHeader) + h->size);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the alias count of a tuple.
+ */
+void RuntimeObjects::update_alias_count(Tuple tup, count_type delta)
+{
+    if (tup.value == 0)
+        return;
+
+    auto* h = header(tup);
+    h->alias_count += delta;
+    QIREE_VALIDATE(h->alias_count >= 0,
+                   << "alias count of QIR tuple became negative");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a string from characters.
+ */
+String RuntimeObjects::string_create(std::string_view s)
+{
+    auto* h = static_cast<StringHeader*>(
+        arena_.allocate(sizeof(StringHeader) + s.size() + 1));
+    *h = {1, s.size()};
+    String result{reinterpret_cast<std::uintptr_t>(h)};
+    char* chars = data(result);
+    std::memcpy(chars, s.data(), s.size());
+    chars[s.size()] = '\0';
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create a new string by joining two strings.
+ */
+String RuntimeObjects::string_concatenate(String first, String second)
+{
+    auto const s1 = string_view(first);
+    auto const s2 = string_view(second);
+    auto* h = static_cast<StringHeader*>(
+        arena_.allocate(sizeof(StringHeader) + s1.size() + s2.size() + 1));
+    *h = {1, s1.size() + s2.size()};
+    String result{reinterpret_cast<std::uintptr_t>(h)};
+    char* chars = data(result);
+    std::memcpy(chars, s1.data(), s1.size());
+    std::memcpy(chars + s1.size(), s2.data(), s2.size());
+    chars[h->length] = '\0';
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a string, releasing it at zero.
+ */
+void RuntimeObjects::update_reference_count(String str, count_type delta)
+{
+    if (str.value == 0)
+        return;
+
+    auto* h = header(str);
+    if (release_reference(h->ref_count, delta, "string"))
+    {
+        arena_.deallocate(h, sizeof(StringHeader) + h->length + 1);
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,265 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/RuntimeObjects.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+#include "Arena.hh"
+#include "Assert.hh"
+#include "Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Arrays, tuples, and strings created by a running QIR program.
+ *
+ * Unlike qubits and results, these are real memory: the opaque \c Array ,
+ * \c Tuple , and \c String values are addresses of objects in a
+ * per-execution \c Arena . An array or string value points to a header
+ * followed by its data; a tuple value points directly to its data (the
+ * program casts it to a structure), with the header stored just before it.
+ *
+ * Objects start with a reference count of one and are returned to the arena
+ * when it drops to zero. The counts are plain integers since a program
+ * executes on a single thread. Alias counts are tracked only to decide
+ * whether \c array_copy and \c tuple_copy must make a copy. Any objects that
+ * are leaked by the program are released together by \c clear at the end of
+ * the execution.
+ *
+ * Backends that receive arrays (e.g. the controls of an \c Array -ctl gate)
+ * read them through the static accessors:
+ * \code
+   for (size_type i = 0; i != RuntimeObjects::array_size(ctls); ++i)
+   {
+       Qubit q = RuntimeObjects::array_get<Qubit>(ctls, i);
+   }
+ * \endcode
+ * and read the arguments packed in a tuple as a structure with the same
+ * layout, e.g. \c {double,%Qubit*} for the arguments of \c rx.ctl .
+ */
+class RuntimeObjects
+{
+  public:
+    //! Reference or alias count change
+    using count_type = std::int32_t;
+
+  public:
+    // Construct with default arena options
+    RuntimeObjects() = default;
+
+    // Construct with arena options
+    explicit RuntimeObjects(Arena::Options opts) : arena_{opts} {}
+
+    // Release all objects at once
+    void clear() { arena_.clear(); }
+
+    //! Number of objects still referenced
+    size_type num_live() const { return arena_.num_live(); }
+
+    //!@{
+    //! \name Arrays
+    Array array_create(size_type elem_size, size_type size);
+    Array array_copy(Array arr, bool force);
+    Array array_concatenate(Array first, Array second);
+    void update_reference_count(Array arr, count_type delta);
+    static void update_alias_count(Array arr, count_type delta);
+
+    static inline size_type array_size(Array arr);
+    static inline size_type array_elem_size(Array arr);
+    static inline void* array_element(Array arr, size_type i);
+    template<class T>
+    static inline T array_get(Array arr, size_type i);
+    //!@}
+
+    //!@{
+    //! \name Tuples
+    Tuple tuple_create(size_type bytes);
+    Tuple tuple_copy(Tuple tup, bool force);
+    void update_reference_count(Tuple tup, count_type delta);
+    static void update_alias_count(Tuple tup, count_type delta);
+
+    template<class T>
+    static inline T tuple_get(Tuple tup);
+    //!@}
+
+    //!@{
+    //! \name Strings
+    String string_create(std::string_view s);
+    String string_concatenate(String first, String second);
+    void update_reference_count(String str, count_type delta);
+
+    static inline std::string_view string_view(String str);
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    struct alignas(16) ArrayHeader
+    {
+        count_type ref_count;
+        count_type alias_count;
+        size_type elem_size;
+        size_type size;
+    };
+
+    struct alignas(16) TupleHeader
+    {
+        count_type ref_count;
+        count_type alias_count;
+        size_type size;
+    };
+
+    struct alignas(16) StringHeader
+    {
+        count_type ref_count;
+        size_type length;
+    };
+
+    //// DATA ////
+
+    Arena arena_;
+
+    //// HELPER FUNCTIONS ////
+
+    static inline ArrayHeader* header(Array arr);
+    static inline TupleHeader* header(Tuple tup);
+    static inline StringHeader* header(String str);
+    static inline char* data(Array arr);
+    static inline char* data(String str);
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the number of elements in an array.
+ */
+size_type RuntimeObjects::array_size(Array arr)
+{
+    return header(arr)->size;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the size in bytes of each element of an array.
+ */
+size_type RuntimeObjects::array_elem_size(Array arr)
+{
+    return header(arr)->elem_size;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a pointer to an array element.
+ */
+void* RuntimeObjects::array_element(Array arr, size_type i)
+{
+    auto const* h = header(arr);
+    QIREE_VALIDATE(i < h->size,
+                   << "array index " << i << " is out of range for size "
+                   << h->size);
+    return data(arr) + i * h->elem_size;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read an array element as a value of a trivially copyable type.
+ *
+ * Opaque QIR pointers such as \c %Qubit* can be read as the corresponding
+ * \c OpaqueId .
+ */
+template<class T>
+T RuntimeObjects::array_get(Array arr, size_type i)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    QIREE_EXPECT(array_elem_size(arr) == sizeof(T));
+    T result;
+    std::memcpy(&result, array_element(arr, i), sizeof(T));
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the contents of a tuple as a trivially copyable structure.
+ *
+ * The tuple's data may also come from storage that the program allocated
+ * itself, so only the data pointer is used.
+ */
+template<class T>
+T RuntimeObjects::tuple_get(Tuple tup)
+{
+    static_assert(std::is_trivially_copyable_v<T>);
+    QIREE_EXPECT(tup.value != 0);
+    T result;
+    std::memcpy(&result, reinterpret_cast<void const*>(tup.value), sizeof(T));
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * View the characters of a string.
+ */
+std::string_view RuntimeObjects::string_view(String str)
+{
+    return {data(str), header(str)->length};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the header of an array.
+ */
+auto RuntimeObjects::header(Array arr) -> ArrayHeader*
+{
+    QIREE_EXPECT(arr.value != 0);
+    return reinterpret_cast<ArrayHeader*>(arr.value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the header stored just before a tuple's data.
+ */
+auto RuntimeObjects::header(Tuple tup) -> TupleHeader*
+{
+    QIREE_EXPECT(tup.value != 0);
+    return reinterpret_cast<TupleHeader*>(tup.value) - 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the header of a string.
+ */
+auto RuntimeObjects::header(String str) -> StringHeader*
+{
+    QIREE_EXPECT(str.value != 0);
+    return reinterpret_cast<StringHeader*>(str.value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the elements following an array header.
+ */
+char* RuntimeObjects::data(Array arr)
+{
+    return reinterpret_cast<char*>(header(arr) + 1);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the null-terminated characters following a string header.
+ */
+char* RuntimeObjects::data(String str)
+{
+    return reinterpret_cast<char*>(header(str) + 1);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,331 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/VirtualSwap.cc
+//---------------------------------------------------------------------------//
+#include "VirtualSwap.hh"
+
+#include <numeric>
+#include <utility>
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the backend.
+ */
+VirtualSwap::VirtualSwap(QuantumInterface& target) : target_{target} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Undo the permutation with real SWAP gates.
+ *
+ * Each logical qubit not on its own physical qubit is swapped into place,
+ * which takes at most one swap per qubit.
+ */
+void VirtualSwap::restore()
+{
+    for (size_type lq = 0; lq != to_physical_.size(); ++lq)
+    {
+        size_type const pq = to_physical_[lq];
+        if (pq == lq)
+            continue;
+
+        // Exchange physical qubits lq and pq
+        target_.swap(Qubit{lq}, Qubit{pq});
+        ++counters_.applied;
+
+        size_type const other = to_logical_[lq];
+        to_physical_[other] = pq;
+        to_logical_[pq] = other;
+        to_physical_[lq] = lq;
+        to_logical_[lq] = lq;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare to build a quantum circuit for an entry point.
+ */
+void VirtualSwap::set_up(EntryPointAttrs const& attrs)
+{
+    to_physical_.resize(attrs.required_num_qubits);
+    std::iota(to_physical_.begin(), to_physical_.end(), size_type{0});
+    to_logical_ = to_physical_;
+    target_.set_up(attrs);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * The permutation is left in place: measurements have already been mapped to
+ * the physical qubits and labeled with the logical ones.
+ */
+void VirtualSwap::tear_down()
+{
+    target_.tear_down();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available, mapping each new qubit to itself.
+ */
+void VirtualSwap::reserve_qubits(size_type num_qubits)
+{
+    for (size_type q = to_physical_.size(); q < num_qubits; ++q)
+    {
+        to_physical_.push_back(q);
+        to_logical_.push_back(q);
+    }
+    target_.reserve_qubits(num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Pass a result's qubit label to the backend.
+ *
+ * The label is already a logical qubit, so it is not remapped.
+ */
+void VirtualSwap::label_result(Result r, Qubit q)
+{
+    target_.label_result(r, q);
+}
+
+//---------------------------------------------------------------------------//
+// MEASUREMENTS
+//---------------------------------------------------------------------------//
+Result VirtualSwap::m(Qubit q)
+{
+    Result r = target_.m(this->map(q));
+    target_.label_result(r, q);
+    return r;
+}
+Result VirtualSwap::measure(Array paulis, Array qubits)
+{
+    return this->restored().measure(paulis, qubits);
+}
+Result VirtualSwap::mresetz(Qubit q)
+{
+    Result r = target_.mresetz(this->map(q));
+    target_.label_result(r, q);
+    return r;
+}
+void VirtualSwap::mz(Qubit q, Result r)
+{
+    target_.mz(this->map(q), r);
+    target_.label_result(r, q);
+}
+QState VirtualSwap::read_result(Result r)
+{
+    return target_.read_result(r);
+}
+
+//---------------------------------------------------------------------------//
+// GATES
+//---------------------------------------------------------------------------//
+void VirtualSwap::ccx(Qubit q1, Qubit q2)
+{
+    target_.ccx(this->map(q1), this->map(q2));
+}
+void VirtualSwap::cnot(Qubit q1, Qubit q2)
+{
+    target_.cnot(this->map(q1), this->map(q2));
+}
+void VirtualSwap::cx(Qubit q1, Qubit q2)
+{
+    target_.cx(this->map(q1), this->map(q2));
+}
+void VirtualSwap::cy(Qubit q1, Qubit q2)
+{
+    target_.cy(this->map(q1), this->map(q2));
+}
+void VirtualSwap::cz(Qubit q1, Qubit q2)
+{
+    target_.cz(this->map(q1), this->map(q2));
+}
+void VirtualSwap::exp_adj(Array paulis, double theta, Array qubits)
+{
+    return this->restored().exp_adj(paulis, theta, qubits);
+}
+void VirtualSwap::exp(Array paulis, double theta, Array qubits)
+{
+    return this->restored().exp(paulis, theta, qubits);
+}
+void VirtualSwap::exp(Array ctls, Tuple args)
+{
+    return this->restored().exp(ctls, args);
+}
+void VirtualSwap::exp_adj(Array ctls, Tuple args)
+{
+    return this->restored().exp_adj(ctls, args);
+}
+void VirtualSwap::h(Qubit q)
+{
+    target_.h(this->map(q));
+}
+void VirtualSwap::h(Array ctls, Qubit q)
+{
+    return this->restored().h(ctls, q);
+}
+void VirtualSwap::r_adj(Pauli p, double theta, Qubit q)
+{
+    target_.r_adj(p, theta, this->map(q));
+}
+void VirtualSwap::r(Pauli p, double theta, Qubit q)
+{
+    target_.r(p, theta, this->map(q));
+}
+void VirtualSwap::r(Array ctls, Tuple args)
+{
+    return this->restored().r(ctls, args);
+}
+void VirtualSwap::r_adj(Array ctls, Tuple args)
+{
+    return this->restored().r_adj(ctls, args);
+}
+void VirtualSwap::reset(Qubit q)
+{
+    target_.reset(this->map(q));
+}
+void VirtualSwap::rx(double theta, Qubit q)
+{
+    target_.rx(theta, this->map(q));
+}
+void VirtualSwap::rx(Array ctls, Tuple args)
+{
+    return this->restored().rx(ctls, args);
+}
+void VirtualSwap::rxx(double theta, Qubit q1, Qubit q2)
+{
+    target_.rxx(theta, this->map(q1), this->map(q2));
+}
+void VirtualSwap::ry(double theta, Qubit q)
+{
+    target_.ry(theta, this->map(q));
+}
+void VirtualSwap::ry(Array ctls, Tuple args)
+{
+    return this->restored().ry(ctls, args);
+}
+void VirtualSwap::ryy(double theta, Qubit q1, Qubit q2)
+{
+    target_.ryy(theta, this->map(q1), this->map(q2));
+}
+void VirtualSwap::rz(double theta, Qubit q)
+{
+    target_.rz(theta, this->map(q));
+}
+void VirtualSwap::rz(Array ctls, Tuple args)
+{
+    return this->restored().rz(ctls, args);
+}
+void VirtualSwap::rzz(double theta, Qubit q1, Qubit q2)
+{
+    target_.rzz(theta, this->map(q1), this->map(q2));
+}
+void VirtualSwap::s_adj(Qubit q)
+{
+    target_.s_adj(this->map(q));
+}
+void VirtualSwap::s(Qubit q)
+{
+    target_.s(this->map(q));
+}
+void VirtualSwap::s(Array ctls, Qubit q)
+{
+    return this->restored().s(ctls, q);
+}
+void VirtualSwap::s_adj(Array ctls, Qubit q)
+{
+    return this->restored().s_adj(ctls, q);
+}
+void VirtualSwap::swap(Qubit q1, Qubit q2)
+{
+    if (q1.value >= to_physical_.size() || q2.value >= to_physical_.size())
+    {
+        target_.swap(this->map(q1), this->map(q2));
+        return;
+    }
+    size_type& p1 = to_physical_[q1.value];
+    size_type& p2 = to_physical_[q2.value];
+    std::swap(p1, p2);
+    to_logical_[p1] = q1.value;
+    to_logical_[p2] = q2.value;
+    ++counters_.relabeled;
+}
+void VirtualSwap::t_adj(Qubit q)
+{
+    target_.t_adj(this->map(q));
+}
+void VirtualSwap::t(Qubit q)
+{
+    target_.t(this->map(q));
+}
+void VirtualSwap::t(Array ctls, Qubit q)
+{
+    return this->restored().t(ctls, q);
+}
+void VirtualSwap::t_adj(Array ctls, Qubit q)
+{
+    return this->restored().t_adj(ctls, q);
+}
+void VirtualSwap::x(Qubit q)
+{
+    target_.x(this->map(q));
+}
+void VirtualSwap::x(Array ctls, Qubit q)
+{
+    return this->restored().x(ctls, q);
+}
+void VirtualSwap::y(Qubit q)
+{
+    target_.y(this->map(q));
+}
+void VirtualSwap::y(Array ctls, Qubit q)
+{
+    return this->restored().y(ctls, q);
+}
+void VirtualSwap::z(Qubit q)
+{
+    target_.z(this->map(q));
+}
+void VirtualSwap::z(Array ctls, Qubit q)
+{
+    return this->restored().z(ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// ASSERTIONS
+//---------------------------------------------------------------------------//
+void VirtualSwap::assertmeasurementprobability(Array paulis,
+                                               Array qubits,
+                                               Result r,
+                                               double prob,
+                                               String msg,
+                                               double tol)
+{
+    return this->restored().assertmeasurementprobability(
+        paulis, qubits, r, prob, msg, tol);
+}
+void VirtualSwap::assertmeasurementprobability(Array ctls, Tuple args)
+{
+    return this->restored().assertmeasurementprobability(ctls, args);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Undo the permutation and get the backend.
+ */
+QuantumInterface& VirtualSwap::restored()
+{
+    this->restore();
+    return target_;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
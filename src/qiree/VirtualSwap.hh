@@ -0,0 +1,158 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/VirtualSwap.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <vector>
+
+#include "QuantumInterface.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Replace SWAP gates with a relabeling of qubits.
+ *
+ * This decorator tracks a permutation from the logical qubits used by the
+ * program to the physical qubits of the backend. A \c swap exchanges two
+ * entries of the permutation and sends nothing to the backend; every later
+ * gate, reset, and measurement is applied to the physical qubits. After
+ * each measurement the backend is told the logical qubit with
+ * \c label_result , so output that labels results by qubit is the same as
+ * without the decorator.
+ *
+ * Instructions whose qubits are passed in opaque arrays cannot be remapped:
+ * before forwarding them, the permutation is undone with real SWAP gates.
+ *
+ * The permutation is reset to the identity at each \c set_up .
+ *
+ * \code
+   VirtualSwap vswap(xacc);
+   execute(vswap, xacc);
+ * \endcode
+ */
+class VirtualSwap final : virtual public QuantumInterface
+{
+  public:
+    //! Statistics about the relabeling
+    struct Counters
+    {
+        size_type relabeled{0};  //!< Swaps replaced by a relabeling
+        size_type applied{0};  //!< Swaps sent to restore the identity
+    };
+
+  public:
+    // Construct with the backend
+    explicit VirtualSwap(QuantumInterface& target);
+
+    // Undo the permutation with real SWAP gates
+    void restore();
+
+    //! Physical qubit currently holding a logical qubit
+    Qubit physical(Qubit q) const { return this->map(q); }
+
+    //!@{
+    //! \name Accessors
+    Counters const& counters() const { return counters_; }
+    //!@}
+
+    //!@{
+    //! \name Executor setup/teardown
+    void set_up(EntryPointAttrs const&) final;
+    void tear_down() final;
+    void reserve_qubits(size_type num_qubits) final;
+    void label_result(Result, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Measurements
+    Result m(Qubit) final;
+    Result measure(Array, Array) final;
+    Result mresetz(Qubit) final;
+    void mz(Qubit, Result) final;
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void ccx(Qubit, Qubit) final;
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    void h(Qubit) final;
+    void h(Array, Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rx(Array, Tuple) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ry(Array, Tuple) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rz(Array, Tuple) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s_adj(Qubit) final;
+    void s(Qubit) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t_adj(Qubit) final;
+    void t(Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Assertions
+    void assertmeasurementprobability(
+        Array, Array, Result, double, String, double) final;
+    void assertmeasurementprobability(Array, Tuple) final;
+    //!@}
+
+  private:
+    QuantumInterface& target_;
+    std::vector<size_type> to_physical_;
+    std::vector<size_type> to_logical_;
+    Counters counters_;
+
+    inline Qubit map(Qubit q) const;
+    QuantumInterface& restored();
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get the physical qubit for a logical one.
+ */
+Qubit VirtualSwap::map(Qubit q) const
+{
+    if (q.value >= to_physical_.size())
+    {
+        // Not described by the entry point: leave unchanged
+        return q;
+    }
+    return Qubit{to_physical_[q.value]};
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,397 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/GateFuser.cc
+//---------------------------------------------------------------------------//
+#include "GateFuser.hh"
+
+#include <algorithm>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using value_type = GateFuser::value_type;
+
+//! Maximum dimension of a fused block matrix
+constexpr size_type max_dim = size_type(1) << GateFuser::max_block_qubits;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Expand a matrix on a subset of qubits into a larger ordered support.
+ *
+ * The result acts as the identity on support qubits that are not in the
+ * source list.
+ */
+void embed(size_type const* src_qubits,
+           size_type src_num_qubits,
+           value_type const* src,
+           size_type const* support,
+           size_type num_support,
+           value_type* dst)
+{
+    size_type pos[GateFuser::max_block_qubits];
+    size_type src_mask = 0;
+    for (size_type b = 0; b != src_num_qubits; ++b)
+    {
+        auto iter
+            = std::find(support, support + num_support, src_qubits[b]);
+        QIREE_ASSERT(iter != support + num_support);
+        pos[b] = iter - support;
+        src_mask |= size_type(1) << pos[b];
+    }
+
+    auto gather = [&](size_type i) {
+        size_type result = 0;
+        for (size_type b = 0; b != src_num_qubits; ++b)
+        {
+            result |= ((i >> pos[b]) & 1) << b;
+        }
+        return result;
+    };
+
+    size_type const dim = size_type(1) << num_support;
+    size_type const src_dim = size_type(1) << src_num_qubits;
+    for (size_type r = 0; r != dim; ++r)
+    {
+        size_type const src_r = gather(r);
+        for (size_type c = 0; c != dim; ++c)
+        {
+            value_type v{0};
+            if (((r ^ c) & ~src_mask) == 0)
+            {
+                v = src[src_r * src_dim + gather(c)];
+            }
+            dst[r * dim + c] = v;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Left-multiply a square matrix in place: dst <- lhs * dst.
+ */
+void left_multiply(value_type const* lhs, size_type dim, value_type* dst)
+{
+    QIREE_EXPECT(dim <= max_dim);
+    value_type tmp[max_dim * max_dim];
+    for (size_type r = 0; r != dim; ++r)
+    {
+        for (size_type c = 0; c != dim; ++c)
+        {
+            value_type sum{0};
+            for (size_type k = 0; k != dim; ++k)
+            {
+                sum += lhs[r * dim + k] * dst[k * dim + c];
+            }
+            tmp[r * dim + c] = sum;
+        }
+    }
+    std::copy(tmp, tmp + dim * dim, dst);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with the state to be updated.
+ */
+GateFuser::GateFuser(StateVector* state) : state_{state}
+{
+    QIREE_EXPECT(state_);
+    qubit_block_.assign(state_->num_qubits(), no_block);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Buffer a gate given as a dense matrix on an ordered list of qubits.
+ */
+void GateFuser::apply(size_type const* qubits,
+                      size_type num_qubits,
+                      value_type const* matrix)
+{
+    QIREE_EXPECT(qubits && matrix && num_qubits > 0);
+    ++counters_.gates;
+
+    // Find the pending blocks this gate touches and their combined support
+    size_type touched[max_block_qubits];
+    size_type num_touched = 0;
+    size_type support[max_block_qubits];
+    size_type num_support = 0;
+    bool fits = num_qubits <= max_block_qubits;
+    if (fits)
+    {
+        std::copy(qubits, qubits + num_qubits, support);
+        num_support = num_qubits;
+    }
+    for (size_type i = 0; i != num_qubits; ++i)
+    {
+        QIREE_EXPECT(qubits[i] < qubit_block_.size());
+        size_type const b = qubit_block_[qubits[i]];
+        if (b == no_block
+            || std::find(touched, touched + num_touched, b)
+                   != touched + num_touched)
+        {
+            continue;
+        }
+        if (!fits)
+        {
+            // Gate is too wide: just flush what it touches
+            this->apply_block(b);
+            continue;
+        }
+        touched[num_touched++] = b;
+        Block const& block = blocks_[b];
+        for (size_type j = 0; j != block.num_qubits; ++j)
+        {
+            size_type const q = block.qubits[j];
+            if (std::find(support, support + num_support, q)
+                != support + num_support)
+            {
+                continue;
+            }
+            if (num_support == max_block_qubits)
+            {
+                fits = false;
+                break;
+            }
+            support[num_support++] = q;
+        }
+        if (!fits)
+        {
+            // Combined support is too large: flush everything touched so far
+            // and any remaining blocks on the gate's qubits
+            for (size_type t = 0; t != num_touched; ++t)
+            {
+                this->apply_block(touched[t]);
+            }
+            num_touched = 0;
+        }
+    }
+
+    if (!fits && num_qubits > max_block_qubits)
+    {
+        // Wide gate: apply directly
+        state_->apply(qubits, num_qubits, matrix);
+        ++counters_.sweeps;
+        return;
+    }
+    if (!fits)
+    {
+        // Pending blocks on these qubits were flushed: start a new block
+        num_support = num_qubits;
+        std::copy(qubits, qubits + num_qubits, support);
+        num_touched = 0;
+    }
+
+    // Construct the fused matrix: gate * (product of touched blocks)
+    size_type const new_id = this->allocate_block();
+    Block& result = blocks_[new_id];
+    result.num_qubits = num_support;
+    std::copy(support, support + num_support, result.qubits.begin());
+    if (num_touched == 0 && num_support == num_qubits)
+    {
+        size_type const dim = size_type(1) << num_qubits;
+        std::copy(matrix, matrix + dim * dim, result.matrix.begin());
+    }
+    else
+    {
+        size_type const dim = size_type(1) << num_support;
+        std::array<value_type, max_block_dim * max_block_dim> temp;
+        // Accumulate the touched blocks, then the new gate
+        std::fill(result.matrix.begin(), result.matrix.end(), value_type{0});
+        for (size_type i = 0; i != dim; ++i)
+        {
+            result.matrix[i * dim + i] = 1;
+        }
+        for (size_type t = 0; t != num_touched; ++t)
+        {
+            Block& block = blocks_[touched[t]];
+            embed(block.qubits.data(),
+                  block.num_qubits,
+                  block.matrix.data(),
+                  support,
+                  num_support,
+                  temp.data());
+            left_multiply(temp.data(), dim, result.matrix.data());
+
+            // Release the old block
+            block.num_qubits = 0;
+            free_blocks_.push_back(touched[t]);
+            --num_pending_;
+        }
+        embed(qubits, num_qubits, matrix, support, num_support, temp.data());
+        left_multiply(temp.data(), dim, result.matrix.data());
+    }
+
+    for (size_type j = 0; j != num_support; ++j)
+    {
+        qubit_block_[support[j]] = new_id;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply the pending block (if any) that acts on a qubit.
+ */
+void GateFuser::flush(size_type qubit)
+{
+    QIREE_EXPECT(qubit < qubit_block_.size());
+    size_type const b = qubit_block_[qubit];
+    if (b != no_block)
+    {
+        this->apply_block(b);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply all pending blocks and change the number of qubits of the state.
+ */
+void GateFuser::resize_state(size_type num_qubits)
+{
+    this->flush();
+    state_->resize(num_qubits);
+    qubit_block_.assign(num_qubits, no_block);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply all pending blocks.
+ *
+ * Disjoint blocks are packed together (first-fit, largest first) so that,
+ * for example, three independent single-qubit rotations cost one sweep.
+ */
+void GateFuser::flush()
+{
+    // Gather distinct pending blocks
+    std::vector<size_type>& pending = scratch_;
+    pending.clear();
+    for (size_type b : qubit_block_)
+    {
+        if (b != no_block
+            && std::find(pending.begin(), pending.end(), b) == pending.end())
+        {
+            pending.push_back(b);
+        }
+    }
+    std::sort(pending.begin(), pending.end(), [this](size_type a, size_type b) {
+        return blocks_[a].num_qubits > blocks_[b].num_qubits;
+    });
+
+    for (auto iter = pending.begin(); iter != pending.end(); ++iter)
+    {
+        if (*iter == no_block)
+            continue;
+        for (auto other = iter + 1; other != pending.end(); ++other)
+        {
+            if (*other != no_block
+                && blocks_[*iter].num_qubits + blocks_[*other].num_qubits
+                       <= max_block_qubits)
+            {
+                this->absorb_block(*iter, *other);
+                *other = no_block;
+            }
+        }
+        this->apply_block(*iter);
+    }
+    QIREE_ENSURE(num_pending_ == 0);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Get an unused block.
+ */
+size_type GateFuser::allocate_block()
+{
+    ++num_pending_;
+    if (!free_blocks_.empty())
+    {
+        size_type result = free_blocks_.back();
+        free_blocks_.pop_back();
+        return result;
+    }
+    blocks_.emplace_back();
+    return blocks_.size() - 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Merge a disjoint pending block into another.
+ */
+void GateFuser::absorb_block(size_type dst_id, size_type src_id)
+{
+    Block& dst = blocks_[dst_id];
+    Block& src = blocks_[src_id];
+    QIREE_EXPECT(dst.num_qubits + src.num_qubits <= max_block_qubits);
+
+    // Combined support: destination qubits are the low bits
+    size_type support[max_block_qubits];
+    size_type const num_support = dst.num_qubits + src.num_qubits;
+    std::copy(dst.qubits.begin(), dst.qubits.begin() + dst.num_qubits, support);
+    std::copy(src.qubits.begin(),
+              src.qubits.begin() + src.num_qubits,
+              support + dst.num_qubits);
+
+    size_type const dim = size_type(1) << num_support;
+    std::array<value_type, max_block_dim * max_block_dim> combined;
+    std::array<value_type, max_block_dim * max_block_dim> temp;
+    embed(dst.qubits.data(),
+          dst.num_qubits,
+          dst.matrix.data(),
+          support,
+          num_support,
+          combined.data());
+    embed(src.qubits.data(),
+          src.num_qubits,
+          src.matrix.data(),
+          support,
+          num_support,
+          temp.data());
+    left_multiply(temp.data(), dim, combined.data());
+
+    dst.num_qubits = num_support;
+    std::copy(support, support + num_support, dst.qubits.begin());
+    dst.matrix = combined;
+    for (size_type j = 0; j != num_support; ++j)
+    {
+        qubit_block_[support[j]] = dst_id;
+    }
+
+    src.num_qubits = 0;
+    free_blocks_.push_back(src_id);
+    --num_pending_;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a pending block to the state and release it.
+ */
+void GateFuser::apply_block(size_type block_id)
+{
+    QIREE_EXPECT(block_id < blocks_.size());
+    Block& block = blocks_[block_id];
+    QIREE_EXPECT(block.num_qubits > 0);
+
+    state_->apply(block.qubits.data(), block.num_qubits, block.matrix.data());
+    ++counters_.sweeps;
+
+    for (size_type j = 0; j != block.num_qubits; ++j)
+    {
+        qubit_block_[block.qubits[j]] = no_block;
+    }
+    block.num_qubits = 0;
+    free_blocks_.push_back(block_id);
+    --num_pending_;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
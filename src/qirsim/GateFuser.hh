@@ -0,0 +1,122 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/GateFuser.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <vector>
+
+#include "StateVector.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Buffer gates and merge them into dense blocks before touching the state.
+ *
+ * Each pending block is a dense matrix on at most \c max_block_qubits qubits,
+ * and pending blocks never share a qubit, so they commute and can be applied
+ * in any order. An incoming gate is multiplied into the blocks it touches if
+ * the combined support still fits in one block; otherwise those blocks are
+ * applied to the state (one sweep each) and the gate starts a new block.
+ *
+ * Callers must flush a qubit before measuring or resetting it, and flush
+ * everything before reading the state. A full flush packs disjoint blocks
+ * together so that independent gates on different qubits share a sweep.
+ */
+class GateFuser
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using value_type = StateVector::value_type;
+    //!@}
+
+    //! Maximum number of qubits in a fused block
+    static constexpr size_type max_block_qubits = 3;
+
+    //! Statistics about fusion
+    struct Counters
+    {
+        size_type gates{0};  //!< Number of gates received
+        size_type sweeps{0};  //!< Number of matrices applied to the state
+    };
+
+  public:
+    // Construct with the state to be updated
+    explicit GateFuser(StateVector* state);
+
+    // Buffer a gate given as a dense matrix on an ordered list of qubits
+    void apply(size_type const* qubits,
+               size_type num_qubits,
+               value_type const* matrix);
+
+    // Buffer a gate given as a dense matrix on an ordered list of qubits
+    inline void apply(std::initializer_list<size_type> qubits,
+                      value_type const* matrix);
+
+    // Apply the pending block (if any) that acts on a qubit
+    void flush(size_type qubit);
+
+    // Apply all pending blocks
+    void flush();
+
+    // Apply all pending blocks and change the number of qubits of the state
+    void resize_state(size_type num_qubits);
+
+    //! Number of blocks waiting to be applied
+    size_type num_pending() const { return num_pending_; }
+
+    //! Access fusion statistics
+    Counters const& counters() const { return counters_; }
+
+  private:
+    //// TYPES ////
+
+    static constexpr size_type max_block_dim = size_type(1)
+                                               << max_block_qubits;
+    static constexpr size_type no_block = static_cast<size_type>(-1);
+
+    struct Block
+    {
+        size_type num_qubits{0};
+        std::array<size_type, max_block_qubits> qubits;
+        std::array<value_type, max_block_dim * max_block_dim> matrix;
+    };
+
+    //// DATA ////
+
+    StateVector* state_;
+    std::vector<Block> blocks_;
+    std::vector<size_type> free_blocks_;
+    std::vector<size_type> qubit_block_;
+    std::vector<size_type> scratch_;
+    size_type num_pending_{0};
+    Counters counters_;
+
+    //// HELPER FUNCTIONS ////
+
+    size_type allocate_block();
+    void absorb_block(size_type dst_id, size_type src_id);
+    void apply_block(size_type block_id);
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Buffer a gate given as a dense matrix on an ordered list of qubits.
+ */
+void GateFuser::apply(std::initializer_list<size_type> qubits,
+                      value_type const* matrix)
+{
+    return this->apply(qubits.begin(), qubits.size(), matrix);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,225 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MarginalSampler.cc
+//---------------------------------------------------------------------------//
+#include "MarginalSampler.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct from a state and the measured qubits.
+ */
+MarginalSampler::MarginalSampler(StateVector const& state,
+                                 VecQubit qubits,
+                                 Options opts)
+    : state_{state}, qubits_{std::move(qubits)}, opts_{opts}
+{
+    QIREE_EXPECT(qubits_.size() <= 8 * sizeof(key_type));
+    QIREE_EXPECT(opts_.chunk_size > 0);
+
+    auto const& amps = state_.amplitudes();
+    if (qubits_.size() <= opts_.max_dense_qubits)
+    {
+        // Accumulate marginal probabilities in one pass
+        size_type const num_keys = size_type(1) << qubits_.size();
+        std::vector<double> prob(num_keys, 0.0);
+        for (size_type i = 0; i != amps.size(); ++i)
+        {
+            prob[this->to_key(i)] += std::norm(amps[i]);
+        }
+
+        // Build the alias table (Vose's method)
+        double total = 0;
+        for (double p : prob)
+        {
+            total += p;
+        }
+        QIREE_VALIDATE(total > 0, << "cannot sample from a zero state");
+
+        threshold_.resize(num_keys);
+        alias_.resize(num_keys);
+        std::vector<key_type> small;
+        std::vector<key_type> large;
+        for (key_type k = 0; k != num_keys; ++k)
+        {
+            threshold_[k] = prob[k] * num_keys / total;
+            alias_[k] = k;
+            (threshold_[k] < 1 ? small : large).push_back(k);
+        }
+        while (!small.empty() && !large.empty())
+        {
+            key_type s = small.back();
+            small.pop_back();
+            key_type l = large.back();
+            alias_[s] = l;
+            threshold_[l] -= 1 - threshold_[s];
+            if (threshold_[l] < 1)
+            {
+                large.pop_back();
+                small.push_back(l);
+            }
+        }
+        // Remaining entries are saturated up to roundoff
+        for (key_type k : large)
+        {
+            threshold_[k] = 1;
+        }
+        for (key_type k : small)
+        {
+            threshold_[k] = 1;
+        }
+    }
+    else
+    {
+        // Prefix sum over the full state
+        cumulative_.resize(amps.size());
+        double total = 0;
+        for (size_type i = 0; i != amps.size(); ++i)
+        {
+            total += std::norm(amps[i]);
+            cumulative_[i] = total;
+        }
+        QIREE_VALIDATE(total > 0, << "cannot sample from a zero state");
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with default options.
+ */
+MarginalSampler::MarginalSampler(StateVector const& state, VecQubit qubits)
+    : MarginalSampler{state, std::move(qubits), Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw shots and tally the outcomes.
+ */
+auto MarginalSampler::operator()(size_type num_shots,
+                                 std::uint64_t seed) const -> Counts
+{
+    size_type const num_chunks = (num_shots + opts_.chunk_size - 1)
+                                 / opts_.chunk_size;
+    size_type num_threads = opts_.num_threads;
+    if (num_threads == 0)
+    {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, num_chunks);
+
+    auto chunk_shots = [&](size_type chunk) {
+        return std::min(opts_.chunk_size, num_shots - chunk * opts_.chunk_size);
+    };
+
+    if (num_threads <= 1)
+    {
+        Counts result;
+        for (size_type c = 0; c != num_chunks; ++c)
+        {
+            this->sample_chunk(chunk_shots(c), seed, c, &result);
+        }
+        return result;
+    }
+
+    // Threads pull chunks from a shared counter and tally into own shard
+    ShardedHistogram thread_counts(num_threads);
+    std::atomic<size_type> next_chunk{0};
+    std::vector<std::thread> threads;
+    threads.reserve(num_threads);
+    for (size_type t = 0; t != num_threads; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (size_type c = next_chunk++; c < num_chunks; c = next_chunk++)
+            {
+                this->sample_chunk(
+                    chunk_shots(c), seed, c, &thread_counts.shard(t));
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    return std::move(thread_counts).merge();
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Extract the measured bits of a state index.
+ */
+auto MarginalSampler::to_key(size_type index) const -> key_type
+{
+    key_type result = 0;
+    for (size_type j = 0; j != qubits_.size(); ++j)
+    {
+        result |= static_cast<key_type>((index >> qubits_[j]) & 1) << j;
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw a chunk of shots with an independent stream.
+ */
+void MarginalSampler::sample_chunk(size_type num_shots,
+                                   std::uint64_t seed,
+                                   size_type chunk,
+                                   Counts* counts) const
+{
+    std::seed_seq seq{static_cast<std::uint32_t>(seed),
+                      static_cast<std::uint32_t>(seed >> 32),
+                      static_cast<std::uint32_t>(chunk),
+                      static_cast<std::uint32_t>(chunk >> 32)};
+    std::mt19937_64 rng(seq);
+    std::uniform_real_distribution<double> sample_uniform;
+
+    if (this->dense())
+    {
+        double const num_keys = static_cast<double>(alias_.size());
+        for (size_type i = 0; i != num_shots; ++i)
+        {
+            double u = sample_uniform(rng) * num_keys;
+            auto k = std::min(static_cast<key_type>(u),
+                              static_cast<key_type>(alias_.size() - 1));
+            if (u - k >= threshold_[k])
+            {
+                k = alias_[k];
+            }
+            counts->add(k);
+        }
+    }
+    else
+    {
+        double const total = cumulative_.back();
+        for (size_type i = 0; i != num_shots; ++i)
+        {
+            double u = sample_uniform(rng) * total;
+            auto iter
+                = std::upper_bound(cumulative_.begin(), cumulative_.end(), u);
+            if (iter == cumulative_.end())
+            {
+                --iter;
+            }
+            counts->add(this->to_key(iter - cumulative_.begin()));
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
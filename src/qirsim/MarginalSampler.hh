@@ -0,0 +1,85 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MarginalSampler.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "qiree/Histogram.hh"
+
+#include "StateVector.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Draw many measurement shots from a single final state.
+ *
+ * The distribution is built once over the measured qubits: if there are few
+ * enough of them, the marginal probabilities are accumulated in one pass over
+ * the state into an alias table for constant-time draws; otherwise a prefix
+ * sum over the full state is searched for each draw.
+ *
+ * Shots are drawn in fixed-size chunks, each with its own generator seeded by
+ * the chunk index, so the result depends only on the seed and not on the
+ * number of threads.
+ *
+ * Bit \em j of each sampled key is the outcome of \c qubits[j] .
+ */
+class MarginalSampler
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using key_type = Histogram::key_type;
+    using Counts = Histogram;
+    using VecQubit = std::vector<size_type>;
+    //!@}
+
+    //! Sampling options
+    struct Options
+    {
+        size_type num_threads{0};  //!< Worker threads (0 for hardware)
+        size_type chunk_size{8192};  //!< Shots per independent stream
+        size_type max_dense_qubits{20};  //!< Largest alias table exponent
+    };
+
+  public:
+    // Construct from a state and the measured qubits
+    MarginalSampler(StateVector const& state, VecQubit qubits, Options opts);
+
+    // Construct with default options
+    MarginalSampler(StateVector const& state, VecQubit qubits);
+
+    // Draw shots and tally the outcomes
+    Counts operator()(size_type num_shots, std::uint64_t seed) const;
+
+    //! Whether draws use an alias table over the marginal distribution
+    bool dense() const { return !alias_.empty(); }
+
+  private:
+    StateVector const& state_;
+    VecQubit qubits_;
+    Options opts_;
+
+    // Dense marginal: alias method
+    std::vector<double> threshold_;
+    std::vector<key_type> alias_;
+
+    // Full state: cumulative probability
+    std::vector<double> cumulative_;
+
+    key_type to_key(size_type index) const;
+    void sample_chunk(size_type num_shots,
+                      std::uint64_t seed,
+                      size_type chunk,
+                      Counts* counts) const;
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
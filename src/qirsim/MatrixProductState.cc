@@ -0,0 +1,653 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MatrixProductState.cc
+//---------------------------------------------------------------------------//
+#include "MatrixProductState.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+#include <utility>
+
+#include "qiree/Assert.hh"
+
+#include "detail/GateMatrices.hh"
+#include "detail/Svd.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Singular values this far below the largest are numerically zero
+constexpr double zero_tolerance = 1e-14;
+
+//! Number of singular values to keep and the weight discarded
+struct Truncation
+{
+    size_type keep;
+    double discarded;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Choose how many singular values to keep.
+ *
+ * The smallest values are dropped while there are more than \c max_bond of
+ * them, while their cumulative relative weight is at most \c threshold, or
+ * when they are numerically zero. At least one value is always kept.
+ */
+Truncation
+truncate(std::vector<double> const& s, size_type max_bond, double threshold)
+{
+    double total = 0;
+    for (double sigma : s)
+    {
+        total += sigma * sigma;
+    }
+
+    Truncation result{s.size(), 0.0};
+    while (result.keep > 1)
+    {
+        double const sigma = s[result.keep - 1];
+        double const weight = sigma * sigma;
+        if (result.keep > max_bond
+            || result.discarded + weight <= threshold * total
+            || sigma <= zero_tolerance * s.front())
+        {
+            result.discarded += weight;
+            --result.keep;
+        }
+        else
+        {
+            break;
+        }
+    }
+    result.discarded /= total;
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+//! Exchange the operand order of a two-qubit gate
+detail::Matrix4 swap_operands(std::complex<double> const* matrix)
+{
+    auto swap_bits = [](size_type i) { return ((i & 1) << 1) | (i >> 1); };
+    detail::Matrix4 result;
+    for (size_type r = 0; r != 4; ++r)
+    {
+        for (size_type c = 0; c != 4; ++c)
+        {
+            result[r * 4 + c] = matrix[swap_bits(r) * 4 + swap_bits(c)];
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct in the |0...0> state.
+ */
+MatrixProductState::MatrixProductState(size_type num_qubits,
+                                       Options const& opts)
+    : opts_{opts}
+    , sites_(num_qubits)
+    , qubit_to_site_(num_qubits)
+    , site_to_qubit_(num_qubits)
+{
+    QIREE_VALIDATE(opts_.max_bond > 0,
+                   << "invalid maximum bond dimension " << opts_.max_bond);
+    QIREE_VALIDATE(
+        opts_.truncation_threshold >= 0 && opts_.truncation_threshold < 1,
+        << "invalid truncation threshold " << opts_.truncation_threshold);
+    this->reset();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct in the |0...0> state with default options.
+ */
+MatrixProductState::MatrixProductState(size_type num_qubits)
+    : MatrixProductState{num_qubits, Options{}}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reset to the |0...0> state.
+ *
+ * This also restores the identity qubit-to-site mapping and clears the
+ * accumulated truncation error.
+ */
+void MatrixProductState::reset()
+{
+    for (auto& site : sites_)
+    {
+        site.left = 1;
+        site.right = 1;
+        site.data.assign({value_type{1}, value_type{0}});
+    }
+    std::iota(qubit_to_site_.begin(), qubit_to_site_.end(), size_type{0});
+    std::iota(site_to_qubit_.begin(), site_to_qubit_.end(), size_type{0});
+    center_ = 0;
+    truncation_error_ = 0;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Append qubits in the |0> state.
+ *
+ * Each new qubit is a product site with unit bonds added after the last site,
+ * which keeps the canonical form. The number of qubits cannot decrease.
+ */
+void MatrixProductState::resize(size_type num_qubits)
+{
+    QIREE_EXPECT(num_qubits >= this->num_qubits());
+    for (size_type q = this->num_qubits(); q != num_qubits; ++q)
+    {
+        Site site;
+        site.data.assign({value_type{1}, value_type{0}});
+        qubit_to_site_.push_back(sites_.size());
+        site_to_qubit_.push_back(q);
+        sites_.push_back(std::move(site));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a single-qubit gate.
+ *
+ * A unitary on the physical index preserves the canonical form, so no
+ * decomposition is needed.
+ */
+void MatrixProductState::apply(value_type const* matrix, size_type qubit)
+{
+    QIREE_EXPECT(qubit < this->num_qubits());
+
+    Site& site = sites_[qubit_to_site_[qubit]];
+    for (size_type l = 0; l != site.left; ++l)
+    {
+        value_type* a0 = site.data.data() + (l * 2) * site.right;
+        value_type* a1 = a0 + site.right;
+        for (size_type r = 0; r != site.right; ++r)
+        {
+            value_type const x0 = a0[r];
+            value_type const x1 = a1[r];
+            a0[r] = matrix[0] * x0 + matrix[1] * x1;
+            a1[r] = matrix[2] * x0 + matrix[3] * x1;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit gate.
+ *
+ * If the qubits are not neighbours, the first is swapped along the chain until
+ * it is adjacent to the second.
+ */
+void MatrixProductState::apply(value_type const* matrix,
+                               size_type q1,
+                               size_type q2)
+{
+    QIREE_EXPECT(q1 < this->num_qubits() && q2 < this->num_qubits());
+    QIREE_EXPECT(q1 != q2);
+
+    size_type s1 = qubit_to_site_[q1];
+    size_type const s2 = qubit_to_site_[q2];
+    for (; s1 + 1 < s2; ++s1)
+    {
+        this->swap_sites(s1);
+    }
+    for (; s2 + 1 < s1; --s1)
+    {
+        this->swap_sites(s1 - 1);
+    }
+
+    if (s1 < s2)
+    {
+        this->apply_adjacent(matrix, s1);
+    }
+    else
+    {
+        auto swapped = swap_operands(matrix);
+        this->apply_adjacent(swapped.data(), s2);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring |1> on a qubit.
+ */
+auto MatrixProductState::probability_one(size_type qubit) -> real_type
+{
+    QIREE_EXPECT(qubit < this->num_qubits());
+
+    size_type const s = qubit_to_site_[qubit];
+    this->move_center(s);
+
+    Site const& site = sites_[s];
+    real_type prob[2] = {0, 0};
+    for (size_type l = 0; l != site.left; ++l)
+    {
+        for (size_type p = 0; p != 2; ++p)
+        {
+            value_type const* a = site.data.data() + (l * 2 + p) * site.right;
+            for (size_type r = 0; r != site.right; ++r)
+            {
+                prob[p] += std::norm(a[r]);
+            }
+        }
+    }
+    return prob[1] / (prob[0] + prob[1]);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Project a qubit onto a measured state and renormalize.
+ */
+void MatrixProductState::collapse(size_type qubit, QState outcome)
+{
+    QIREE_EXPECT(qubit < this->num_qubits());
+
+    size_type const s = qubit_to_site_[qubit];
+    this->move_center(s);
+
+    Site& site = sites_[s];
+    size_type const keep = (outcome == QState::one ? 1 : 0);
+    real_type norm = 0;
+    for (size_type l = 0; l != site.left; ++l)
+    {
+        for (size_type p = 0; p != 2; ++p)
+        {
+            value_type* a = site.data.data() + (l * 2 + p) * site.right;
+            for (size_type r = 0; r != site.right; ++r)
+            {
+                if (p == keep)
+                {
+                    norm += std::norm(a[r]);
+                }
+                else
+                {
+                    a[r] = 0;
+                }
+            }
+        }
+    }
+    QIREE_VALIDATE(norm > 0,
+                   << "cannot collapse qubit " << qubit
+                   << " onto a state with zero probability");
+
+    real_type const scale = 1 / std::sqrt(norm);
+    for (auto& a : site.data)
+    {
+        a *= scale;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Draw shots over a set of qubits without disturbing the state.
+ *
+ * Bit \em j of each sampled key is the outcome of \c qubits[j] , so at most
+ * 64 qubits can be sampled jointly; use \c sample_marginals for more.
+ */
+auto MatrixProductState::sample(VecQubit const& qubits,
+                                size_type num_shots,
+                                std::uint64_t seed) -> Counts
+{
+    QIREE_VALIDATE(qubits.size() <= 8 * sizeof(key_type),
+                   << "cannot jointly sample " << qubits.size()
+                   << " qubits into a " << 8 * sizeof(key_type)
+                   << "-bit histogram key");
+
+    Counts result;
+    this->sample_shots(
+        qubits, num_shots, seed, [&result](std::vector<char> const& bits) {
+            key_type key = 0;
+            for (size_type j = 0; j != bits.size(); ++j)
+            {
+                key |= key_type(bits[j]) << j;
+            }
+            result.add(key);
+        });
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Count the outcomes of each qubit over shots drawn from the state.
+ *
+ * The shots are the same as those drawn by \c sample with the same seed,
+ * but only the [zero, one] counts of each qubit are kept, so any number of
+ * qubits can be sampled.
+ */
+auto MatrixProductState::sample_marginals(VecQubit const& qubits,
+                                          size_type num_shots,
+                                          std::uint64_t seed) -> VecMarginal
+{
+    VecMarginal result(qubits.size(), {0, 0});
+    this->sample_shots(
+        qubits, num_shots, seed, [&result](std::vector<char> const& bits) {
+            for (size_type j = 0; j != bits.size(); ++j)
+            {
+                ++result[j][bits[j] ? 1 : 0];
+            }
+        });
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Largest bond dimension in the chain.
+ */
+size_type MatrixProductState::max_bond_dimension() const
+{
+    size_type result = 1;
+    for (auto const& site : sites_)
+    {
+        result = std::max(result, site.right);
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Draw shots over a set of qubits and pass each shot's outcomes to a
+ * function.
+ *
+ * With the orthogonality center on the first site, each shot is drawn exactly
+ * by sampling sites left to right from their conditional distributions, at a
+ * cost linear in the chain length and quadratic in the bond dimension.
+ * Element \em j of the outcomes is 1 if \c qubits[j] was measured as |1>.
+ */
+template<class F>
+void MatrixProductState::sample_shots(VecQubit const& qubits,
+                                      size_type num_shots,
+                                      std::uint64_t seed,
+                                      F&& record_shot)
+{
+    std::vector<char> bits(qubits.size(), 0);
+    if (qubits.empty())
+    {
+        for (size_type shot = 0; shot != num_shots; ++shot)
+        {
+            record_shot(bits);
+        }
+        return;
+    }
+
+    // Map sites to output bits
+    std::vector<int> site_bit(sites_.size(), -1);
+    size_type last_site = 0;
+    for (size_type j = 0; j != qubits.size(); ++j)
+    {
+        QIREE_EXPECT(qubits[j] < this->num_qubits());
+        size_type const s = qubit_to_site_[qubits[j]];
+        site_bit[s] = static_cast<int>(j);
+        last_site = std::max(last_site, s);
+    }
+
+    this->move_center(0);
+
+    std::mt19937_64 rng(seed);
+    std::uniform_real_distribution<double> sample_uniform;
+    std::vector<value_type> env;
+    std::vector<value_type> next[2];
+    for (size_type shot = 0; shot != num_shots; ++shot)
+    {
+        env.assign(1, value_type{1});
+        for (size_type s = 0; s <= last_site; ++s)
+        {
+            Site const& site = sites_[s];
+            real_type weight[2] = {0, 0};
+            for (size_type p = 0; p != 2; ++p)
+            {
+                next[p].assign(site.right, value_type{0});
+                for (size_type l = 0; l != site.left; ++l)
+                {
+                    value_type const e = env[l];
+                    value_type const* a = site.data.data()
+                                          + (l * 2 + p) * site.right;
+                    for (size_type r = 0; r != site.right; ++r)
+                    {
+                        next[p][r] += e * a[r];
+                    }
+                }
+                for (auto const& v : next[p])
+                {
+                    weight[p] += std::norm(v);
+                }
+            }
+            size_type const p = sample_uniform(rng) * (weight[0] + weight[1])
+                                        < weight[1]
+                                    ? 1
+                                    : 0;
+            if (site_bit[s] >= 0)
+            {
+                bits[site_bit[s]] = static_cast<char>(p);
+            }
+            real_type const scale = 1 / std::sqrt(weight[p]);
+            env.resize(site.right);
+            for (size_type r = 0; r != site.right; ++r)
+            {
+                env[r] = next[p][r] * scale;
+            }
+        }
+        record_shot(bits);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Move the orthogonality center to a site.
+ *
+ * Each step splits the center tensor with an SVD, leaves the isometry behind,
+ * and absorbs the remaining factor into the neighbour. Only numerically zero
+ * singular values are dropped.
+ */
+void MatrixProductState::move_center(size_type target)
+{
+    QIREE_EXPECT(target < sites_.size());
+
+    constexpr auto no_limit = std::numeric_limits<size_type>::max();
+
+    while (center_ < target)
+    {
+        Site& a = sites_[center_];
+        Site& b = sites_[center_ + 1];
+        size_type const m = a.right;
+        size_type const cols = 2 * b.right;
+
+        auto dec = detail::svd(2 * a.left, m, a.data.data());
+        size_type const k = truncate(dec.s, no_limit, 0).keep;
+
+        // Left-canonical isometry
+        a.data.resize(2 * a.left * k);
+        for (size_type row = 0; row != 2 * a.left; ++row)
+        {
+            for (size_type j = 0; j != k; ++j)
+            {
+                a.data[row * k + j] = dec.u[row * dec.rank + j];
+            }
+        }
+        a.right = k;
+
+        // Absorb S V^H into the next site
+        std::vector<value_type> data(k * cols, value_type{0});
+        for (size_type j = 0; j != k; ++j)
+        {
+            for (size_type i = 0; i != m; ++i)
+            {
+                value_type const f = dec.s[j] * dec.vh[j * m + i];
+                value_type const* src = b.data.data() + i * cols;
+                for (size_type c = 0; c != cols; ++c)
+                {
+                    data[j * cols + c] += f * src[c];
+                }
+            }
+        }
+        b.data = std::move(data);
+        b.left = k;
+        ++center_;
+    }
+
+    while (center_ > target)
+    {
+        Site& a = sites_[center_ - 1];
+        Site& b = sites_[center_];
+        size_type const m = b.left;
+        size_type const rows = 2 * a.left;
+        size_type const cols = 2 * b.right;
+
+        auto dec = detail::svd(m, cols, b.data.data());
+        size_type const k = truncate(dec.s, no_limit, 0).keep;
+
+        // Right-canonical isometry
+        b.data.assign(dec.vh.begin(), dec.vh.begin() + k * cols);
+        b.left = k;
+
+        // Absorb U S into the previous site
+        std::vector<value_type> data(rows * k, value_type{0});
+        for (size_type row = 0; row != rows; ++row)
+        {
+            for (size_type i = 0; i != m; ++i)
+            {
+                value_type const x = a.data[row * m + i];
+                for (size_type j = 0; j != k; ++j)
+                {
+                    data[row * k + j] += x * dec.u[i * dec.rank + j]
+                                         * dec.s[j];
+                }
+            }
+        }
+        a.data = std::move(data);
+        a.right = k;
+        --center_;
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit gate to a site and its right neighbour.
+ *
+ * The low bit of the gate index corresponds to the left site. The two sites
+ * are contracted, updated, and split with a truncated SVD, leaving the
+ * orthogonality center on the right site.
+ */
+void MatrixProductState::apply_adjacent(value_type const* matrix,
+                                        size_type s)
+{
+    QIREE_EXPECT(s + 1 < sites_.size());
+
+    this->move_center(s);
+    Site& a = sites_[s];
+    Site& b = sites_[s + 1];
+    size_type const left = a.left;
+    size_type const bond = a.right;
+    size_type const right = b.right;
+    QIREE_ASSERT(b.left == bond);
+
+    // Contract into theta[l][pa][pb][r], a (2 left, 2 right) matrix
+    std::vector<value_type> theta(left * 4 * right, value_type{0});
+    for (size_type row = 0; row != 2 * left; ++row)
+    {
+        for (size_type i = 0; i != bond; ++i)
+        {
+            value_type const x = a.data[row * bond + i];
+            value_type const* src = b.data.data() + i * 2 * right;
+            value_type* dst = theta.data() + row * 2 * right;
+            for (size_type c = 0; c != 2 * right; ++c)
+            {
+                dst[c] += x * src[c];
+            }
+        }
+    }
+
+    // Apply the gate to the physical indices
+    for (size_type l = 0; l != left; ++l)
+    {
+        for (size_type r = 0; r != right; ++r)
+        {
+            auto index = [&](size_type pa, size_type pb) {
+                return ((l * 2 + pa) * 2 + pb) * right + r;
+            };
+            value_type in[4];
+            for (size_type i = 0; i != 4; ++i)
+            {
+                in[i] = theta[index(i & 1, i >> 1)];
+            }
+            for (size_type i = 0; i != 4; ++i)
+            {
+                value_type out{0};
+                for (size_type j = 0; j != 4; ++j)
+                {
+                    out += matrix[i * 4 + j] * in[j];
+                }
+                theta[index(i & 1, i >> 1)] = out;
+            }
+        }
+    }
+
+    // Split and truncate
+    size_type const rows = 2 * left;
+    size_type const cols = 2 * right;
+    auto dec = detail::svd(rows, cols, theta.data());
+    auto trunc
+        = truncate(dec.s, opts_.max_bond, opts_.truncation_threshold);
+    size_type const k = trunc.keep;
+    truncation_error_ += trunc.discarded;
+
+    real_type norm = 0;
+    for (size_type j = 0; j != k; ++j)
+    {
+        norm += dec.s[j] * dec.s[j];
+    }
+    real_type const scale = 1 / std::sqrt(norm);
+
+    a.data.resize(rows * k);
+    for (size_type row = 0; row != rows; ++row)
+    {
+        for (size_type j = 0; j != k; ++j)
+        {
+            a.data[row * k + j] = dec.u[row * dec.rank + j];
+        }
+    }
+    a.right = k;
+
+    b.data.resize(k * cols);
+    for (size_type j = 0; j != k; ++j)
+    {
+        real_type const sigma = dec.s[j] * scale;
+        for (size_type c = 0; c != cols; ++c)
+        {
+            b.data[j * cols + c] = sigma * dec.vh[j * cols + c];
+        }
+    }
+    b.left = k;
+    center_ = s + 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Exchange the qubits on a site and its right neighbour.
+ */
+void MatrixProductState::swap_sites(size_type s)
+{
+    this->apply_adjacent(detail::swap_gate.data(), s);
+    std::swap(site_to_qubit_[s], site_to_qubit_[s + 1]);
+    qubit_to_site_[site_to_qubit_[s]] = s;
+    qubit_to_site_[site_to_qubit_[s + 1]] = s + 1;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
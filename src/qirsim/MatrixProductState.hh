@@ -0,0 +1,141 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MatrixProductState.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <complex>
+#include <cstdint>
+#include <vector>
+
+#include "qiree/Histogram.hh"
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Matrix product state of an N-qubit register.
+ *
+ * Each qubit occupies one site of a chain, and each site holds a rank-3
+ * tensor \f$ A^{p}_{l r} \f$ whose left and right (bond) dimensions bound the
+ * entanglement across that cut. Memory and time scale with the bond
+ * dimension rather than \f$ 2^N \f$, so shallow circuits with mostly local
+ * entanglement on many qubits remain cheap.
+ *
+ * The state is kept in mixed canonical form about an orthogonality center,
+ * which is moved with singular value decompositions as needed. Two-qubit
+ * gates are applied to adjacent sites by contracting them, applying the gate,
+ * and splitting the result again with an SVD that keeps at most \c max_bond
+ * singular values and discards the smallest ones whose total weight is below
+ * \c truncation_threshold. The discarded weight is accumulated as the
+ * truncation error; the state is renormalized after each truncation.
+ *
+ * Gates on non-adjacent qubits are routed by swapping sites until the qubits
+ * are neighbours. The qubits are not swapped back: a qubit-to-site
+ * permutation tracks where each qubit currently lives.
+ *
+ * Gate matrices follow the \c StateVector convention: row-major, with the
+ * first listed qubit as the least significant bit of the matrix index.
+ */
+class MatrixProductState
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using value_type = std::complex<double>;
+    using real_type = double;
+    using key_type = Histogram::key_type;
+    using Counts = Histogram;
+    using VecMarginal = Histogram::VecMarginal;
+    using VecQubit = std::vector<size_type>;
+    //!@}
+
+    //! Truncation options
+    struct Options
+    {
+        size_type max_bond{64};  //!< Maximum bond dimension
+        real_type truncation_threshold{1e-12};  //!< Discarded weight per SVD
+    };
+
+  public:
+    // Construct in the |0...0> state
+    MatrixProductState(size_type num_qubits, Options const& opts);
+
+    // Construct in the |0...0> state with default options
+    explicit MatrixProductState(size_type num_qubits);
+
+    // Reset to the |0...0> state
+    void reset();
+
+    // Append qubits in the |0> state
+    void resize(size_type num_qubits);
+
+    // Apply a single-qubit gate
+    void apply(value_type const* matrix, size_type qubit);
+
+    // Apply a two-qubit gate
+    void apply(value_type const* matrix, size_type q1, size_type q2);
+
+    // Probability of measuring |1> on a qubit
+    real_type probability_one(size_type qubit);
+
+    // Project a qubit onto a measured state and renormalize
+    void collapse(size_type qubit, QState outcome);
+
+    // Draw shots over a set of qubits without disturbing the state
+    Counts sample(VecQubit const& qubits,
+                  size_type num_shots,
+                  std::uint64_t seed);
+
+    // Count the outcomes of each qubit over shots drawn from the state
+    VecMarginal sample_marginals(VecQubit const& qubits,
+                                 size_type num_shots,
+                                 std::uint64_t seed);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return qubit_to_site_.size(); }
+    Options const& options() const { return opts_; }
+    real_type truncation_error() const { return truncation_error_; }
+    size_type site(size_type qubit) const { return qubit_to_site_[qubit]; }
+    size_type max_bond_dimension() const;
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    //! Site tensor stored as a row-major (left * 2 + p, right) matrix
+    struct Site
+    {
+        size_type left{1};
+        size_type right{1};
+        std::vector<value_type> data;
+    };
+
+    //// DATA ////
+
+    Options opts_;
+    std::vector<Site> sites_;
+    std::vector<size_type> qubit_to_site_;
+    std::vector<size_type> site_to_qubit_;
+    size_type center_{0};
+    real_type truncation_error_{0};
+
+    //// HELPER FUNCTIONS ////
+
+    void move_center(size_type site);
+    void apply_adjacent(value_type const* matrix, size_type site);
+    void swap_sites(size_type site);
+    template<class F>
+    void sample_shots(VecQubit const& qubits,
+                      size_type num_shots,
+                      std::uint64_t seed,
+                      F&& record_shot);
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
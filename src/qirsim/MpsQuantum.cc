@@ -0,0 +1,495 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.cc
+//---------------------------------------------------------------------------//
+#include "MpsQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+
+#include "qiree/Assert.hh"
+
+#include "detail/GateMatrices.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+MpsQuantum::MpsQuantum(std::ostream& os, Options const& opts)
+    : output_{os}, opts_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(opts_.shots > 0,
+                   << "invalid number of shots " << opts_.shots);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with number of shots and random seed.
+ */
+MpsQuantum::MpsQuantum(std::ostream& os, size_type shots, size_type seed)
+    : MpsQuantum{os, [&] {
+                     Options opts;
+                     opts.shots = shots;
+                     opts.seed = seed;
+                     return opts;
+                 }()}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct for a single shot.
+ */
+MpsQuantum::MpsQuantum(std::ostream& os) : MpsQuantum{os, 1, 0} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare to build a quantum circuit for an entry point.
+ *
+ * The state is reused between shots if the qubit count is unchanged.
+ */
+void MpsQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(this->remaining_shots() > 0,
+                   << "all " << opts_.shots
+                   << " shots have already been run");
+
+    if (!state_ || state_->num_qubits() != attrs.required_num_qubits)
+    {
+        MatrixProductState::Options mps_opts;
+        mps_opts.max_bond = opts_.max_bond;
+        mps_opts.truncation_threshold = opts_.truncation_threshold;
+        state_ = std::make_unique<MatrixProductState>(
+            attrs.required_num_qubits, mps_opts);
+    }
+    else
+    {
+        state_->reset();
+    }
+    results_.reset(attrs.required_num_results);
+    result_to_qubit_.assign(attrs.required_num_results, Qubit{});
+    recorded_.clear();
+
+    deferring_ = opts_.sample_final_state;
+    deferred_qubits_.clear();
+    deferred_results_.clear();
+    is_deferred_.assign(attrs.required_num_qubits, false);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available during an execution.
+ *
+ * The new qubits are appended in |0> as product sites.
+ */
+void MpsQuantum::reserve_qubits(size_type num_qubits)
+{
+    if (num_qubits <= this->num_qubits())
+        return;
+
+    state_->resize(num_qubits);
+    is_deferred_.resize(num_qubits, false);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Label a result with the program's qubit.
+ *
+ * The label replaces the measured qubit in the output, for decorators that
+ * measure a different qubit than the program named.
+ */
+void MpsQuantum::label_result(Result r, Qubit q)
+{
+    QIREE_EXPECT(r.value < result_to_qubit_.size());
+    result_to_qubit_[r.value] = q;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * If measurements are still deferred, the execution accounts for all
+ * remaining shots. The tallied output is written after the final shot, and
+ * the truncation statistics are updated.
+ */
+void MpsQuantum::tear_down()
+{
+    ++num_executions_;
+    truncation_error_
+        = std::max(truncation_error_, state_->truncation_error());
+    max_bond_dimension_
+        = std::max(max_bond_dimension_, state_->max_bond_dimension());
+    this->tally_records();
+    if (this->remaining_shots() == 0)
+    {
+        this->write_output();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result.
+ *
+ * The result is allocated from the pool with a reference count of one.
+ */
+Result MpsQuantum::m(Qubit q)
+{
+    Result r = results_.allocate();
+    if (result_to_qubit_.size() < results_.size())
+    {
+        result_to_qubit_.resize(results_.size());
+    }
+    this->mz(q, r);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result MpsQuantum::mresetz(Qubit q)
+{
+    Result r = this->m(q);
+    this->reset(q);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a result.
+ *
+ * The measurement is deferred unless feedback has already been detected or the
+ * qubit was measured before.
+ */
+void MpsQuantum::mz(Qubit q, Result r)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+    QIREE_EXPECT(r.value < this->num_results());
+
+    result_to_qubit_[r.value] = q;
+    if (deferring_ && !is_deferred_[q.value])
+    {
+        is_deferred_[q.value] = true;
+        deferred_qubits_.push_back(q.value);
+        deferred_results_.push_back(r);
+        return;
+    }
+    this->end_deferral();
+    results_.set(r, this->measure_qubit(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a result.
+ *
+ * Since the program may branch on the result, deferred measurements are
+ * collapsed.
+ */
+QState MpsQuantum::read_result(Result r)
+{
+    this->end_deferral();
+    return results_[r];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two results have the same measured value.
+ */
+bool MpsQuantum::result_equal(Result a, Result b)
+{
+    return this->read_result(a) == this->read_result(b);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a result returned by m or mresetz.
+ */
+void MpsQuantum::result_update_reference_count(Result r, std::int32_t delta)
+{
+    results_.update_reference_count(r, delta);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize the execution environment, resetting qubits.
+ */
+void MpsQuantum::initialize(OptionalCString) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mark the start of an array of results.
+ */
+void MpsQuantum::array_record_output(size_type, OptionalCString) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Save one result.
+ *
+ * Records are matched between shots by their order in the program output and
+ * tallied when the execution completes.
+ */
+void MpsQuantum::result_record_output(Result r, OptionalCString tag)
+{
+    QIREE_EXPECT(r.value < this->num_results());
+
+    if (recorded_.size() == records_.size())
+    {
+        records_.push_back({result_to_qubit_[r.value], tag ? tag : "<null>"});
+    }
+    recorded_.push_back(r);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * No one uses tuples!
+ */
+void MpsQuantum::tuple_record_output(size_type, OptionalCString)
+{
+    QIREE_NOT_IMPLEMENTED("MpsQuantum::tuple_record_output");
+}
+
+//---------------------------------------------------------------------------//
+// QUANTUM INSTRUCTION MAPPING
+//---------------------------------------------------------------------------//
+void MpsQuantum::cnot(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cx_gate.data(), q1, q2);
+}
+void MpsQuantum::cx(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cx_gate.data(), q1, q2);
+}
+void MpsQuantum::cy(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cy_gate.data(), q1, q2);
+}
+void MpsQuantum::cz(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cz_gate.data(), q1, q2);
+}
+void MpsQuantum::h(Qubit q)
+{
+    this->apply(detail::h_gate.data(), q);
+}
+void MpsQuantum::r_adj(Pauli p, double angle, Qubit q)
+{
+    return this->r(p, -angle, q);
+}
+void MpsQuantum::r(Pauli p, double angle, Qubit q)
+{
+    switch (p)
+    {
+        case Pauli::i:
+            return this->apply(detail::ri_gate(angle).data(), q);
+        case Pauli::x:
+            return this->rx(angle, q);
+        case Pauli::y:
+            return this->ry(angle, q);
+        case Pauli::z:
+            return this->rz(angle, q);
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+void MpsQuantum::reset(Qubit q)
+{
+    // Resetting is a mid-circuit measurement
+    this->end_deferral();
+    if (this->measure_qubit(q) == QState::one)
+    {
+        this->apply(detail::x_gate.data(), q);
+    }
+}
+void MpsQuantum::rx(double angle, Qubit q)
+{
+    this->apply(detail::rx_gate(angle).data(), q);
+}
+void MpsQuantum::rxx(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::rxx_gate(angle).data(), q1, q2);
+}
+void MpsQuantum::ry(double angle, Qubit q)
+{
+    this->apply(detail::ry_gate(angle).data(), q);
+}
+void MpsQuantum::ryy(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::ryy_gate(angle).data(), q1, q2);
+}
+void MpsQuantum::rz(double angle, Qubit q)
+{
+    this->apply(detail::rz_gate(angle).data(), q);
+}
+void MpsQuantum::rzz(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::rzz_gate(angle).data(), q1, q2);
+}
+void MpsQuantum::s(Qubit q)
+{
+    this->apply(detail::s_gate.data(), q);
+}
+void MpsQuantum::s_adj(Qubit q)
+{
+    this->apply(detail::s_adj_gate.data(), q);
+}
+void MpsQuantum::swap(Qubit q1, Qubit q2)
+{
+    this->apply(detail::swap_gate.data(), q1, q2);
+}
+void MpsQuantum::t(Qubit q)
+{
+    this->apply(detail::t_gate.data(), q);
+}
+void MpsQuantum::t_adj(Qubit q)
+{
+    this->apply(detail::t_adj_gate.data(), q);
+}
+void MpsQuantum::x(Qubit q)
+{
+    this->apply(detail::x_gate.data(), q);
+}
+void MpsQuantum::y(Qubit q)
+{
+    this->apply(detail::y_gate.data(), q);
+}
+void MpsQuantum::z(Qubit q)
+{
+    this->apply(detail::z_gate.data(), q);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a one-qubit gate.
+ */
+void MpsQuantum::apply(value_type const* matrix, Qubit q)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+    if (QIREE_UNLIKELY(is_deferred_[q.value]))
+    {
+        this->end_deferral();
+    }
+    state_->apply(matrix, q.value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a two-qubit gate.
+ *
+ * The first qubit is the least significant bit of the matrix index.
+ */
+void MpsQuantum::apply(value_type const* matrix, Qubit q1, Qubit q2)
+{
+    QIREE_EXPECT(q1.value < this->num_qubits());
+    QIREE_EXPECT(q2.value < this->num_qubits());
+    QIREE_EXPECT(q1.value != q2.value);
+    if (QIREE_UNLIKELY(is_deferred_[q1.value] || is_deferred_[q2.value]))
+    {
+        this->end_deferral();
+    }
+    state_->apply(matrix, q1.value, q2.value);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample and collapse a single qubit.
+ */
+QState MpsQuantum::measure_qubit(Qubit q)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+
+    double const p_one = state_->probability_one(q.value);
+    std::uniform_real_distribution<double> sample_uniform;
+    auto result = sample_uniform(rng_) < p_one ? QState::one : QState::zero;
+    state_->collapse(q.value, result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Collapse deferred measurements because the program needs them.
+ *
+ * The measurements are performed in program order, and the rest of the
+ * execution simulates a single shot.
+ */
+void MpsQuantum::end_deferral()
+{
+    if (!deferring_)
+        return;
+
+    deferring_ = false;
+    for (size_type i = 0; i != deferred_qubits_.size(); ++i)
+    {
+        size_type q = deferred_qubits_[i];
+        is_deferred_[q] = false;
+        results_.set(deferred_results_[i], this->measure_qubit(Qubit{q}));
+    }
+    deferred_qubits_.clear();
+    deferred_results_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete the shots represented by this execution.
+ *
+ * Without feedback, the remaining shots are all sampled from the final state.
+ */
+void MpsQuantum::tally_records()
+{
+    // Count the outcomes of each deferred measurement in one pass; any
+    // number of qubits can be deferred since no joint key is formed
+    size_type num_shots = 1;
+    MatrixProductState::VecMarginal marginals;
+    if (deferring_)
+    {
+        num_shots = this->remaining_shots();
+        marginals
+            = state_->sample_marginals(deferred_qubits_, num_shots, rng_());
+    }
+
+    for (size_type i = 0; i != recorded_.size(); ++i)
+    {
+        Result r = recorded_[i];
+        size_type ones = 0;
+        // A result that was recycled or measured again is written by its
+        // latest deferred measurement
+        auto iter = std::find_if(
+            deferred_results_.rbegin(),
+            deferred_results_.rend(),
+            [r](Result other) { return other.value == r.value; });
+        if (iter != deferred_results_.rend())
+        {
+            ones = marginals[deferred_results_.rend() - iter - 1][1];
+        }
+        else if (results_[r] == QState::one)
+        {
+            ones = num_shots;
+        }
+        records_[i].counts[0] += num_shots - ones;
+        records_[i].counts[1] += ones;
+    }
+    completed_shots_ += num_shots;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write tallied results.
+ */
+void MpsQuantum::write_output()
+{
+    for (auto const& rec : records_)
+    {
+        output_ << "qubit " << rec.qubit.value << " experiment " << rec.tag
+                << ": {0: " << rec.counts[0] << ", 1: " << rec.counts[1]
+                << "}\n";
+    }
+    output_.flush();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
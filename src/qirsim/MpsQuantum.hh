@@ -0,0 +1,229 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/ResultPool.hh"
+#include "qiree/RuntimeInterface.hh"
+#include "qiree/Types.hh"
+
+#include "MatrixProductState.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate a QIR program natively with a matrix product state.
+ *
+ * This backend targets wide, shallow circuits with mostly nearest-neighbour
+ * entanglement, which are too large for a \c StateVector but whose
+ * entanglement is bounded. The accuracy is controlled by the maximum bond
+ * dimension and truncation threshold of the \c MatrixProductState; the
+ * largest truncation error (discarded weight) over all executions is
+ * available after the run.
+ *
+ * Measurements are deferred in the same way as \c SimQuantum : without
+ * feedback, all shots are sampled directly from the final state; otherwise
+ * each execution is a single shot.
+ *
+ * \code
+   MpsQuantum::Options opts;
+   opts.shots = 1000;
+   opts.max_bond = 32;
+   MpsQuantum sim(std::cout, opts);
+   while (sim.remaining_shots() > 0)
+   {
+       execute(sim, sim);
+   }
+ * \endcode
+ */
+class MpsQuantum final : virtual public QuantumNotImpl,
+                         virtual public RuntimeInterface
+{
+  public:
+    //! Simulation options
+    struct Options
+    {
+        size_type shots{1};  //!< Number of shots to simulate
+        size_type seed{0};  //!< Random number seed
+        size_type max_bond{64};  //!< Maximum bond dimension
+        double truncation_threshold{1e-12};  //!< Discarded weight per SVD
+        bool sample_final_state{true};  //!< Sample shots from a final state
+    };
+
+  public:
+    // Construct with options
+    MpsQuantum(std::ostream& os, Options const& opts);
+
+    // Construct with number of shots and random seed
+    MpsQuantum(std::ostream& os, size_type shots, size_type seed);
+
+    // Construct for a single shot
+    explicit MpsQuantum(std::ostream& os);
+
+    QIREE_DELETE_COPY_MOVE(MpsQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_results() const { return results_.size(); }
+    size_type num_qubits() const { return state_ ? state_->num_qubits() : 0; }
+    size_type remaining_shots() const
+    {
+        return opts_.shots - completed_shots_;
+    }
+    size_type num_executions() const { return num_executions_; }
+    double truncation_error() const { return truncation_error_; }
+    size_type max_bond_dimension() const { return max_bond_dimension_; }
+    //!@}
+
+    //!@{
+    //! \name Quantum interface
+    // Prepare to build a quantum circuit for an entry point
+    void set_up(EntryPointAttrs const&) override;
+
+    // Complete an execution
+    void tear_down() override;
+
+    // Make more qubits available during an execution
+    void reserve_qubits(size_type num_qubits) override;
+
+    // Label a result with the program's qubit
+    void label_result(Result, Qubit) final;
+
+    // Measure a qubit into a new result
+    Result m(Qubit) final;
+
+    // Measure a qubit into a new result and reset it
+    Result mresetz(Qubit) final;
+
+    // Measure a qubit into a result
+    void mz(Qubit, Result) final;
+
+    // Read the value of a result.
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Runtime interface
+    // Initialize the execution environment, resetting qubits
+    void initialize(OptionalCString env) override;
+
+    // Mark the start of an array of results
+    void array_record_output(size_type, OptionalCString tag) final;
+
+    // Save one result
+    void result_record_output(Result result, OptionalCString tag) final;
+
+    // No one uses tuples??
+    void tuple_record_output(size_type, OptionalCString) final;
+
+    // Get a constant result that reads as |0>
+    Result result_get_zero() final { return ResultPool::zero(); }
+
+    // Get a constant result that reads as |1>
+    Result result_get_one() final { return ResultPool::one(); }
+
+    // Whether two results have the same measured value
+    bool result_equal(Result, Result) final;
+
+    // Change the reference count of a result returned by m or mresetz
+    void result_update_reference_count(Result, std::int32_t delta) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void h(Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s(Qubit) final;
+    void s_adj(Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t(Qubit) final;
+    void t_adj(Qubit) final;
+    void x(Qubit) final;
+    void y(Qubit) final;
+    void z(Qubit) final;
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    using value_type = MatrixProductState::value_type;
+
+    //! Tally of a single recorded output over all shots
+    struct RecordCounts
+    {
+        Qubit qubit;
+        std::string tag;
+        size_type counts[2]{0, 0};
+    };
+
+    //// DATA ////
+
+    std::ostream& output_;
+    Options opts_;
+    size_type completed_shots_{0};
+    size_type num_executions_{0};
+    std::mt19937_64 rng_;
+    double truncation_error_{0};
+    size_type max_bond_dimension_{0};
+
+    std::unique_ptr<MatrixProductState> state_;
+    ResultPool results_;
+    std::vector<Qubit> result_to_qubit_;
+
+    // Measurements not yet collapsed in the current execution
+    bool deferring_{false};
+    std::vector<size_type> deferred_qubits_;
+    std::vector<Result> deferred_results_;
+    std::vector<bool> is_deferred_;
+
+    std::vector<RecordCounts> records_;
+    std::vector<Result> recorded_;
+
+    //// HELPER FUNCTIONS ////
+
+    // Apply a one-qubit gate
+    void apply(value_type const* matrix, Qubit q);
+
+    // Apply a two-qubit gate
+    void apply(value_type const* matrix, Qubit q1, Qubit q2);
+
+    // Sample and collapse a single qubit
+    QState measure_qubit(Qubit q);
+
+    // Collapse deferred measurements because the program needs them
+    void end_deferral();
+
+    // Complete the shots represented by this execution
+    void tally_records();
+
+    // Write tallied results
+    void write_output();
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,945 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SimQuantum.cc
+//---------------------------------------------------------------------------//
+#include "SimQuantum.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <string_view>
+#include <utility>
+
+#include "qiree/Assert.hh"
+#include "qiree/RuntimeObjects.hh"
+
+#include "detail/GateMatrices.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Arguments of \c rx.ctl , \c ry.ctl , and \c rz.ctl : {double,%Qubit*}
+struct RotationArgs
+{
+    double angle;
+    std::uintptr_t qubit;
+};
+
+//! Arguments of \c r.ctl and \c r.ctladj : {i2,double,%Qubit*}
+struct PauliRotationArgs
+{
+    pauli_type pauli;
+    double angle;
+    std::uintptr_t qubit;
+
+    //! Pauli axis (bits above the stored i2 are unspecified)
+    Pauli axis() const { return static_cast<Pauli>(pauli & 0b11); }
+};
+
+//! Arguments of \c exp.ctl and \c exp.ctladj : {%Array*,double,%Array*}
+struct ExpArgs
+{
+    std::uintptr_t paulis;
+    double theta;
+    std::uintptr_t qubits;
+};
+
+//! Arguments of \c assertmeasurementprobability.ctl
+struct AssertArgs
+{
+    std::uintptr_t paulis;
+    std::uintptr_t qubits;
+    std::uintptr_t result;
+    double probability;
+    std::uintptr_t message;
+    double tolerance;
+};
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get the matrix of a rotation about a Pauli axis.
+ */
+detail::Matrix2 pauli_rotation(Pauli p, double angle)
+{
+    switch (p)
+    {
+        case Pauli::i:
+            return detail::ri_gate(angle);
+        case Pauli::x:
+            return detail::rx_gate(angle);
+        case Pauli::y:
+            return detail::ry_gate(angle);
+        case Pauli::z:
+            return detail::rz_gate(angle);
+    }
+    QIREE_ASSERT_UNREACHABLE();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with options.
+ */
+SimQuantum::SimQuantum(std::ostream& os, Options const& opts)
+    : output_{os}, opts_{opts}, rng_{opts.seed}
+{
+    QIREE_VALIDATE(opts_.shots > 0,
+                   << "invalid number of shots " << opts_.shots);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with number of shots and random seed.
+ */
+SimQuantum::SimQuantum(std::ostream& os, size_type shots, size_type seed)
+    : SimQuantum{os, [&] {
+                     Options opts;
+                     opts.shots = shots;
+                     opts.seed = seed;
+                     return opts;
+                 }()}
+{
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct for a single shot.
+ */
+SimQuantum::SimQuantum(std::ostream& os) : SimQuantum{os, 1, 0} {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access fusion statistics.
+ */
+GateFuser::Counters const& SimQuantum::fusion_counters() const
+{
+    QIREE_EXPECT(fuser_);
+    return fuser_->counters();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare to build a quantum circuit for an entry point.
+ *
+ * The state vector's storage is reused between shots. If a branch is pending
+ * from an earlier measurement, this execution resumes it: its saved state is
+ * loaded and its measurement history is replayed.
+ */
+void SimQuantum::set_up(EntryPointAttrs const& attrs)
+{
+    QIREE_VALIDATE(this->remaining_shots() > 0,
+                   << "all " << opts_.shots
+                   << " shots have already been run");
+
+    if (!branches_.empty())
+    {
+        Branch& b = branches_.back();
+        QIREE_ASSERT(state_);
+        *state_ = std::move(b.state);
+        // The branch may have allocated qubits dynamically
+        fuser_->resize_state(state_->num_qubits());
+        replay_ = std::move(b.history);
+        num_shots_ = b.num_shots;
+        branches_.pop_back();
+    }
+    else
+    {
+        if (!state_)
+        {
+            state_ = std::make_unique<StateVector>(attrs.required_num_qubits);
+            fuser_ = std::make_unique<GateFuser>(state_.get());
+        }
+        else
+        {
+            fuser_->resize_state(attrs.required_num_qubits);
+            state_->reset();
+        }
+        replay_.clear();
+        // Without sampling or branching, every execution is a single shot
+        num_shots_ = opts_.sample_final_state || opts_.branch_shots
+                         ? this->remaining_shots()
+                         : 1;
+    }
+    history_.clear();
+    results_.reset(attrs.required_num_results);
+    result_to_qubit_.assign(attrs.required_num_results, Qubit{});
+    recorded_.clear();
+
+    deferring_ = opts_.sample_final_state;
+    deferred_qubits_.clear();
+    deferred_results_.clear();
+    is_deferred_.assign(state_->num_qubits(), false);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete an execution.
+ *
+ * If measurements are still deferred, the shots represented by this execution
+ * are sampled from the final state. The tallied output is written after the
+ * final shot.
+ */
+void SimQuantum::tear_down()
+{
+    QIREE_ASSERT(!this->replaying());
+    ++num_executions_;
+    fuser_->flush();
+    this->tally_records();
+    if (this->remaining_shots() == 0)
+    {
+        this->write_output();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available during an execution.
+ *
+ * The new qubits are added in |0> to the state vector. When a branch is
+ * resumed, its saved state already includes them.
+ */
+void SimQuantum::reserve_qubits(size_type num_qubits)
+{
+    if (num_qubits <= this->num_qubits())
+        return;
+
+    fuser_->resize_state(num_qubits);
+    is_deferred_.resize(num_qubits, false);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Label a result with the program's qubit.
+ *
+ * The label replaces the measured qubit in the output, for decorators that
+ * measure a different qubit than the program named.
+ */
+void SimQuantum::label_result(Result r, Qubit q)
+{
+    QIREE_EXPECT(r.value < result_to_qubit_.size());
+    result_to_qubit_[r.value] = q;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result.
+ *
+ * The result is allocated from the pool with a reference count of one.
+ */
+Result SimQuantum::m(Qubit q)
+{
+    Result r = results_.allocate();
+    if (result_to_qubit_.size() < results_.size())
+    {
+        result_to_qubit_.resize(results_.size());
+    }
+    this->mz(q, r);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a new result and reset it.
+ */
+Result SimQuantum::mresetz(Qubit q)
+{
+    Result r = this->m(q);
+    this->reset(q);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Measure a qubit into a result.
+ *
+ * The measurement is deferred unless feedback has already been detected or the
+ * qubit was measured before.
+ */
+void SimQuantum::mz(Qubit q, Result r)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+    QIREE_EXPECT(r.value < this->num_results());
+
+    result_to_qubit_[r.value] = q;
+    if (deferring_ && !is_deferred_[q.value])
+    {
+        is_deferred_[q.value] = true;
+        deferred_qubits_.push_back(q.value);
+        deferred_results_.push_back(r);
+        return;
+    }
+    this->end_deferral();
+    results_.set(r, this->measure_qubit(q));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Read the value of a result.
+ *
+ * Since the program may branch on the result, all pending gates are applied.
+ */
+QState SimQuantum::read_result(Result r)
+{
+    this->end_deferral();
+    fuser_->flush();
+    return results_[r];
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Whether two results have the same measured value.
+ */
+bool SimQuantum::result_equal(Result a, Result b)
+{
+    return this->read_result(a) == this->read_result(b);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a result returned by m or mresetz.
+ */
+void SimQuantum::result_update_reference_count(Result r, std::int32_t delta)
+{
+    results_.update_reference_count(r, delta);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize the execution environment, resetting qubits.
+ */
+void SimQuantum::initialize(OptionalCString) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Mark the start of an array of results.
+ */
+void SimQuantum::array_record_output(size_type, OptionalCString) {}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Save one result.
+ *
+ * Records are matched between shots by their order in the program output and
+ * tallied when the execution completes.
+ */
+void SimQuantum::result_record_output(Result r, OptionalCString tag)
+{
+    QIREE_EXPECT(r.value < this->num_results());
+
+    if (recorded_.size() == records_.size())
+    {
+        records_.push_back({result_to_qubit_[r.value], tag ? tag : "<null>"});
+    }
+    recorded_.push_back(r);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * No one uses tuples!
+ */
+void SimQuantum::tuple_record_output(size_type, OptionalCString)
+{
+    QIREE_NOT_IMPLEMENTED("SimQuantum::tuple_record_output");
+}
+
+//---------------------------------------------------------------------------//
+// QUANTUM INSTRUCTION MAPPING
+//---------------------------------------------------------------------------//
+void SimQuantum::cnot(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cx_gate.data(), q1, q2);
+}
+void SimQuantum::cx(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cx_gate.data(), q1, q2);
+}
+void SimQuantum::cy(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cy_gate.data(), q1, q2);
+}
+void SimQuantum::cz(Qubit q1, Qubit q2)
+{
+    this->apply(detail::cz_gate.data(), q1, q2);
+}
+void SimQuantum::h(Qubit q)
+{
+    this->apply(detail::h_gate.data(), q);
+}
+void SimQuantum::r_adj(Pauli p, double angle, Qubit q)
+{
+    return this->r(p, -angle, q);
+}
+void SimQuantum::r(Pauli p, double angle, Qubit q)
+{
+    this->apply(pauli_rotation(p, angle).data(), q);
+}
+void SimQuantum::reset(Qubit q)
+{
+    // Resetting is a mid-circuit measurement
+    this->end_deferral();
+    if (this->measure_qubit(q) == QState::one)
+    {
+        this->apply(detail::x_gate.data(), q);
+    }
+}
+void SimQuantum::rx(double angle, Qubit q)
+{
+    this->apply(detail::rx_gate(angle).data(), q);
+}
+void SimQuantum::rxx(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::rxx_gate(angle).data(), q1, q2);
+}
+void SimQuantum::ry(double angle, Qubit q)
+{
+    this->apply(detail::ry_gate(angle).data(), q);
+}
+void SimQuantum::ryy(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::ryy_gate(angle).data(), q1, q2);
+}
+void SimQuantum::rz(double angle, Qubit q)
+{
+    this->apply(detail::rz_gate(angle).data(), q);
+}
+void SimQuantum::rzz(double angle, Qubit q1, Qubit q2)
+{
+    this->apply(detail::rzz_gate(angle).data(), q1, q2);
+}
+void SimQuantum::s(Qubit q)
+{
+    this->apply(detail::s_gate.data(), q);
+}
+void SimQuantum::s_adj(Qubit q)
+{
+    this->apply(detail::s_adj_gate.data(), q);
+}
+void SimQuantum::swap(Qubit q1, Qubit q2)
+{
+    this->apply(detail::swap_gate.data(), q1, q2);
+}
+void SimQuantum::t(Qubit q)
+{
+    this->apply(detail::t_gate.data(), q);
+}
+void SimQuantum::t_adj(Qubit q)
+{
+    this->apply(detail::t_adj_gate.data(), q);
+}
+void SimQuantum::x(Qubit q)
+{
+    this->apply(detail::x_gate.data(), q);
+}
+void SimQuantum::y(Qubit q)
+{
+    this->apply(detail::y_gate.data(), q);
+}
+void SimQuantum::z(Qubit q)
+{
+    this->apply(detail::z_gate.data(), q);
+}
+
+//---------------------------------------------------------------------------//
+// PAULI EXPONENTIALS
+//---------------------------------------------------------------------------//
+void SimQuantum::exp(Array paulis, double theta, Array qubits)
+{
+    this->apply_exp(paulis, theta, qubits, Array{});
+}
+void SimQuantum::exp_adj(Array paulis, double theta, Array qubits)
+{
+    this->apply_exp(paulis, -theta, qubits, Array{});
+}
+void SimQuantum::exp(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<ExpArgs>(args);
+    this->apply_exp(Array{a.paulis}, a.theta, Array{a.qubits}, ctls);
+}
+void SimQuantum::exp_adj(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<ExpArgs>(args);
+    this->apply_exp(Array{a.paulis}, -a.theta, Array{a.qubits}, ctls);
+}
+
+//---------------------------------------------------------------------------//
+// CONTROLLED INSTRUCTION MAPPING
+//---------------------------------------------------------------------------//
+void SimQuantum::h(Array ctls, Qubit q)
+{
+    this->apply(detail::h_gate.data(), ctls, q);
+}
+void SimQuantum::r(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<PauliRotationArgs>(args);
+    auto const m = pauli_rotation(a.axis(), a.angle);
+    this->apply(m.data(), ctls, Qubit{a.qubit});
+}
+void SimQuantum::r_adj(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<PauliRotationArgs>(args);
+    auto const m = pauli_rotation(a.axis(), -a.angle);
+    this->apply(m.data(), ctls, Qubit{a.qubit});
+}
+void SimQuantum::rx(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<RotationArgs>(args);
+    this->apply(detail::rx_gate(a.angle).data(), ctls, Qubit{a.qubit});
+}
+void SimQuantum::ry(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<RotationArgs>(args);
+    this->apply(detail::ry_gate(a.angle).data(), ctls, Qubit{a.qubit});
+}
+void SimQuantum::rz(Array ctls, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<RotationArgs>(args);
+    this->apply(detail::rz_gate(a.angle).data(), ctls, Qubit{a.qubit});
+}
+void SimQuantum::s(Array ctls, Qubit q)
+{
+    this->apply(detail::s_gate.data(), ctls, q);
+}
+void SimQuantum::s_adj(Array ctls, Qubit q)
+{
+    this->apply(detail::s_adj_gate.data(), ctls, q);
+}
+void SimQuantum::t(Array ctls, Qubit q)
+{
+    this->apply(detail::t_gate.data(), ctls, q);
+}
+void SimQuantum::t_adj(Array ctls, Qubit q)
+{
+    this->apply(detail::t_adj_gate.data(), ctls, q);
+}
+void SimQuantum::x(Array ctls, Qubit q)
+{
+    this->apply(detail::x_gate.data(), ctls, q);
+}
+void SimQuantum::y(Array ctls, Qubit q)
+{
+    this->apply(detail::y_gate.data(), ctls, q);
+}
+void SimQuantum::z(Array ctls, Qubit q)
+{
+    this->apply(detail::z_gate.data(), ctls, q);
+}
+
+//---------------------------------------------------------------------------//
+// ASSERTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Check the probability of a joint Pauli measurement outcome.
+ *
+ * Measuring the Pauli string yields \c Zero for its +1 eigenspace, so the
+ * probability of \c Zero is \f$ (1 + \langle P \rangle) / 2 \f$. The
+ * expectation is evaluated exactly from the amplitudes without disturbing
+ * the state. Any deferred measurement is collapsed first, even on other
+ * qubits, since an entangled qubit's probabilities depend on it. The
+ * assertion is skipped while a measurement history is being replayed, since
+ * that prefix was already checked by an earlier execution.
+ */
+void SimQuantum::assertmeasurementprobability(Array paulis,
+                                              Array qubits,
+                                              Result result,
+                                              double probability,
+                                              String message,
+                                              double tolerance)
+{
+    size_type const num_paulis = RuntimeObjects::array_size(paulis);
+    QIREE_VALIDATE(num_paulis == RuntimeObjects::array_size(qubits),
+                   << "measurement assertion has " << num_paulis
+                   << " Paulis but " << RuntimeObjects::array_size(qubits)
+                   << " qubits");
+
+    QState const outcome = ResultPool::is_constant(result)
+                               ? results_[result]
+                               : this->read_result(result);
+    if (!deferred_qubits_.empty())
+    {
+        this->end_deferral();
+    }
+
+    direct_qubits_.resize(num_paulis);
+    for (size_type i = 0; i != num_paulis; ++i)
+    {
+        direct_qubits_[i] = RuntimeObjects::array_get<Qubit>(qubits, i).value;
+    }
+    if (!this->prepare_direct())
+        return;
+
+    size_type x_mask = 0;
+    size_type z_mask = 0;
+    this->pauli_masks(paulis, &x_mask, &z_mask);
+    double const p_zero
+        = (1 + state_->expectation_pauli(x_mask, z_mask, opts_.num_threads))
+          / 2;
+    double const actual = outcome == QState::zero ? p_zero : 1 - p_zero;
+
+    QIREE_VALIDATE(std::fabs(actual - probability) <= tolerance,
+                   << (message.value ? RuntimeObjects::string_view(message)
+                                     : std::string_view{})
+                   << " (measurement probability is " << actual
+                   << " but expected " << probability << " +/- "
+                   << tolerance << ")");
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check a measurement probability regardless of the control qubits.
+ *
+ * Q# defines the controlled assertion to check the state unconditionally.
+ */
+void SimQuantum::assertmeasurementprobability(Array, Tuple args)
+{
+    auto a = RuntimeObjects::tuple_get<AssertArgs>(args);
+    this->assertmeasurementprobability(Array{a.paulis},
+                                       Array{a.qubits},
+                                       Result{a.result},
+                                       a.probability,
+                                       String{a.message},
+                                       a.tolerance);
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Buffer a one-qubit gate.
+ */
+void SimQuantum::apply(value_type const* matrix, Qubit q)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+    if (QIREE_UNLIKELY(is_deferred_[q.value]))
+    {
+        this->end_deferral();
+    }
+    if (this->replaying())
+        return;
+    fuser_->apply({q.value}, matrix);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Buffer a two-qubit gate.
+ *
+ * The first qubit is the least significant bit of the matrix index.
+ */
+void SimQuantum::apply(value_type const* matrix, Qubit q1, Qubit q2)
+{
+    QIREE_EXPECT(q1.value < this->num_qubits());
+    QIREE_EXPECT(q2.value < this->num_qubits());
+    QIREE_EXPECT(q1.value != q2.value);
+    if (QIREE_UNLIKELY(is_deferred_[q1.value] || is_deferred_[q2.value]))
+    {
+        this->end_deferral();
+    }
+    if (this->replaying())
+        return;
+    fuser_->apply({q1.value, q2.value}, matrix);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a one-qubit gate with an array of control qubits.
+ *
+ * Zero or one controls are buffered in the fuser like any other gate. With
+ * more, the pending blocks on the involved qubits are flushed and the
+ * state's multi-controlled kernel is applied directly.
+ */
+void SimQuantum::apply(value_type const* matrix, Array ctls, Qubit q)
+{
+    size_type const num_ctls = RuntimeObjects::array_size(ctls);
+    if (num_ctls == 0)
+    {
+        return this->apply(matrix, q);
+    }
+    if (num_ctls == 1)
+    {
+        Qubit const c = RuntimeObjects::array_get<Qubit>(ctls, 0);
+        detail::Matrix2 m;
+        std::copy(matrix, matrix + m.size(), m.begin());
+        return this->apply(detail::controlled_gate(m).data(), c, q);
+    }
+
+    // Controls followed by the target
+    direct_qubits_.resize(num_ctls + 1);
+    for (size_type i = 0; i != num_ctls; ++i)
+    {
+        direct_qubits_[i] = RuntimeObjects::array_get<Qubit>(ctls, i).value;
+    }
+    direct_qubits_.back() = q.value;
+    if (!this->prepare_direct())
+        return;
+
+    state_->apply_controlled(
+        direct_qubits_.data(), num_ctls, q.value, matrix);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a Pauli exponential, optionally with control qubits.
+ *
+ * The Pauli string is converted to X and Z bitmasks over the state's qubits
+ * and applied by \c StateVector::exp_pauli in one sweep. A null control
+ * array means the exponential is not controlled.
+ */
+void SimQuantum::apply_exp(Array paulis,
+                           double theta,
+                           Array qubits,
+                           Array ctls)
+{
+    size_type const num_paulis = RuntimeObjects::array_size(paulis);
+    QIREE_VALIDATE(num_paulis == RuntimeObjects::array_size(qubits),
+                   << "Pauli exponential has " << num_paulis
+                   << " Paulis but " << RuntimeObjects::array_size(qubits)
+                   << " qubits");
+
+    size_type const num_ctls
+        = ctls.value != 0 ? RuntimeObjects::array_size(ctls) : 0;
+    direct_qubits_.resize(num_paulis + num_ctls);
+    for (size_type i = 0; i != num_paulis; ++i)
+    {
+        direct_qubits_[i] = RuntimeObjects::array_get<Qubit>(qubits, i).value;
+    }
+    for (size_type i = 0; i != num_ctls; ++i)
+    {
+        direct_qubits_[num_paulis + i]
+            = RuntimeObjects::array_get<Qubit>(ctls, i).value;
+    }
+    if (!this->prepare_direct())
+        return;
+
+    size_type x_mask = 0;
+    size_type z_mask = 0;
+    this->pauli_masks(paulis, &x_mask, &z_mask);
+    size_type ctl_mask = 0;
+    for (size_type i = num_paulis; i != direct_qubits_.size(); ++i)
+    {
+        ctl_mask |= size_type(1) << direct_qubits_[i];
+    }
+    state_->exp_pauli(x_mask, z_mask, theta, ctl_mask);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Convert a Pauli array on the listed qubits to X and Z bitmasks.
+ *
+ * Pauli \em i acts on the qubit \c direct_qubits_[i] , which must be
+ * distinct. Y sets the qubit's bit in both masks, and I in neither.
+ */
+void SimQuantum::pauli_masks(Array paulis,
+                             size_type* x_mask,
+                             size_type* z_mask) const
+{
+    size_type const num_paulis = RuntimeObjects::array_size(paulis);
+    QIREE_EXPECT(num_paulis <= direct_qubits_.size());
+    *x_mask = 0;
+    *z_mask = 0;
+    for (size_type i = 0; i != num_paulis; ++i)
+    {
+        // Bits above the stored i2 are unspecified
+        auto const p = static_cast<Pauli>(
+            RuntimeObjects::array_get<pauli_type>(paulis, i) & 0b11);
+        size_type const bit = size_type(1) << direct_qubits_[i];
+        QIREE_EXPECT(!((*x_mask | *z_mask) & bit));
+        if (p == Pauli::x || p == Pauli::y)
+        {
+            *x_mask |= bit;
+        }
+        if (p == Pauli::z || p == Pauli::y)
+        {
+            *z_mask |= bit;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Prepare to update the listed qubits directly in the state.
+ *
+ * Deferred measurements on any of the qubits are collapsed first, and their
+ * pending fused blocks are applied. Other pending blocks act on different
+ * qubits and commute with the update. Returns false if the update must be
+ * skipped because a measurement history is being replayed.
+ */
+bool SimQuantum::prepare_direct()
+{
+    bool deferred = false;
+    for (size_type q : direct_qubits_)
+    {
+        QIREE_EXPECT(q < this->num_qubits());
+        deferred = deferred || is_deferred_[q];
+    }
+    if (QIREE_UNLIKELY(deferred))
+    {
+        this->end_deferral();
+    }
+    if (this->replaying())
+        return false;
+
+    for (size_type q : direct_qubits_)
+    {
+        fuser_->flush(q);
+    }
+    return true;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Sample and collapse a single qubit.
+ *
+ * While replaying a branch, the saved state already reflects the recorded
+ * outcome. Without branching, a collapse reduces the execution to one shot.
+ */
+QState SimQuantum::measure_qubit(Qubit q)
+{
+    QIREE_EXPECT(q.value < this->num_qubits());
+
+    QState result;
+    if (this->replaying())
+    {
+        result = replay_[history_.size()];
+    }
+    else
+    {
+        fuser_->flush(q.value);
+        double const p_one = state_->probability_one(q.value);
+        if (opts_.branch_shots)
+        {
+            result = this->branch(q, p_one);
+        }
+        else
+        {
+            num_shots_ = 1;
+            std::uniform_real_distribution<double> sample_uniform;
+            result = sample_uniform(rng_) < p_one ? QState::one
+                                                  : QState::zero;
+            state_->collapse(q.value, result);
+        }
+    }
+    history_.push_back(result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Split the current shots between two measurement outcomes.
+ *
+ * The number of shots with outcome one is drawn from a binomial distribution.
+ * If both outcomes occur, the execution continues with the more common one and
+ * the other is saved as a pending branch.
+ */
+QState SimQuantum::branch(Qubit q, double p_one)
+{
+    p_one = std::clamp(p_one, 0.0, 1.0);
+    std::binomial_distribution<size_type> sample_ones(num_shots_, p_one);
+    size_type const ones = sample_ones(rng_);
+    size_type const zeros = num_shots_ - ones;
+
+    QState const result = ones >= zeros ? QState::one : QState::zero;
+    if (ones != 0 && zeros != 0)
+    {
+        QState const other = result == QState::one ? QState::zero
+                                                   : QState::one;
+        fuser_->flush();
+        Branch b{result == QState::one ? zeros : ones, history_, *state_};
+        b.history.push_back(other);
+        b.state.collapse(q.value, other);
+        branches_.push_back(std::move(b));
+        num_shots_ -= branches_.back().num_shots;
+    }
+    state_->collapse(q.value, result);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Collapse deferred measurements because the program needs them.
+ *
+ * The measurements are performed in program order, branching the shots of
+ * this execution as needed.
+ */
+void SimQuantum::end_deferral()
+{
+    if (!deferring_)
+        return;
+
+    deferring_ = false;
+    for (size_type i = 0; i != deferred_qubits_.size(); ++i)
+    {
+        size_type q = deferred_qubits_[i];
+        is_deferred_[q] = false;
+        results_.set(deferred_results_[i], this->measure_qubit(Qubit{q}));
+    }
+    deferred_qubits_.clear();
+    deferred_results_.clear();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Complete the shots represented by this execution.
+ *
+ * Without feedback, the shots are all sampled from the final state.
+ */
+void SimQuantum::tally_records()
+{
+    size_type const num_shots = num_shots_;
+    MarginalSampler::Counts counts;
+    if (deferring_)
+    {
+        MarginalSampler::Options sample_opts;
+        sample_opts.num_threads = opts_.num_threads;
+        MarginalSampler sample(*state_, deferred_qubits_, sample_opts);
+        counts = sample(num_shots, rng_());
+    }
+
+    // Tabulate the outcome of each deferred measurement in one pass
+    auto const marginals = counts.marginals(deferred_results_.size());
+
+    for (size_type i = 0; i != recorded_.size(); ++i)
+    {
+        Result r = recorded_[i];
+        size_type ones = 0;
+        // A result that was recycled or measured again is written by its
+        // latest deferred measurement
+        auto iter = std::find_if(
+            deferred_results_.rbegin(),
+            deferred_results_.rend(),
+            [r](Result other) { return other.value == r.value; });
+        if (iter != deferred_results_.rend())
+        {
+            ones = marginals[deferred_results_.rend() - iter - 1][1];
+        }
+        else if (results_[r] == QState::one)
+        {
+            ones = num_shots;
+        }
+        records_[i].counts[0] += num_shots - ones;
+        records_[i].counts[1] += ones;
+    }
+    completed_shots_ += num_shots;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write tallied results.
+ */
+void SimQuantum::write_output()
+{
+    for (auto const& rec : records_)
+    {
+        output_ << "qubit " << rec.qubit.value << " experiment " << rec.tag
+                << ": {0: " << rec.counts[0] << ", 1: " << rec.counts[1]
+                << "}\n";
+    }
+    output_.flush();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
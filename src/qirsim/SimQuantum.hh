@@ -0,0 +1,315 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SimQuantum.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/QuantumNotImpl.hh"
+#include "qiree/ResultPool.hh"
+#include "qiree/RuntimeInterface.hh"
+#include "qiree/Types.hh"
+
+#include "GateFuser.hh"
+#include "MarginalSampler.hh"
+#include "StateVector.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Simulate a QIR program natively with a dense state vector.
+ *
+ * Gates are buffered through a \c GateFuser so that runs of one- to
+ * three-qubit gates cost a single sweep of the state. Pending gates are
+ * flushed when a measurement, reset, or \c read_result needs the state.
+ *
+ * Measurements are deferred while the program has not used their results:
+ * if execution completes without feedback (no \c read_result, reset, or
+ * further operation on a measured qubit), all remaining shots are drawn from
+ * the single final state with a \c MarginalSampler. Otherwise the deferred
+ * measurements are collapsed in order at the first sign of feedback.
+ *
+ * With feedback, shots are \em branched rather than simulated one at a time.
+ * An execution starts out representing all of its shots; when a measurement
+ * collapses the state, the shots are split binomially between the two
+ * outcomes. The execution continues along one outcome, and the other is saved
+ * as a pending branch with a copy of the collapsed state and the measurement
+ * history that led to it. The next execution replays that history: it skips
+ * every gate and returns the recorded outcomes until the branch point, then
+ * resumes simulating from the saved state. Shots with a common measurement
+ * history therefore share the simulated prefix, and a dynamic circuit costs
+ * one execution per distinct history rather than one per shot.
+ *
+ * Gates with an array of controls (the \c ctl variants) are applied by a
+ * dedicated \c StateVector kernel that touches only the amplitudes where
+ * every control is set; a single control is fused like any two-qubit gate.
+ * Pauli exponentials (\c exp ) are likewise applied as a single sweep of the
+ * state, without basis changes or CNOT ladders.
+ *
+ * \c assertmeasurementprobability is checked exactly from the amplitudes, so
+ * a single execution verifies a state that would otherwise take many sampled
+ * shots to estimate. A failed assertion throws a \c RuntimeError .
+ *
+ * Recorded results are tallied across shots and written to the output stream
+ * after the last shot, so the executor should be called until no shots
+ * remain:
+ * \code
+   SimQuantum sim(std::cout, num_shots);
+   while (sim.remaining_shots() > 0)
+   {
+       execute(sim, sim);
+   }
+ * \endcode
+ */
+class SimQuantum final : virtual public QuantumNotImpl,
+                         virtual public RuntimeInterface
+{
+  public:
+    //! Simulation options
+    struct Options
+    {
+        size_type shots{1};  //!< Number of shots to simulate
+        size_type seed{0};  //!< Random number seed
+        bool sample_final_state{true};  //!< Sample shots from a final state
+        size_type num_threads{0};  //!< Worker threads (0 for hardware)
+        bool branch_shots{true};  //!< Share prefixes between feedback shots
+    };
+
+  public:
+    // Construct with options
+    SimQuantum(std::ostream& os, Options const& opts);
+
+    // Construct with number of shots and random seed
+    SimQuantum(std::ostream& os, size_type shots, size_type seed);
+
+    // Construct for a single shot
+    explicit SimQuantum(std::ostream& os);
+
+    QIREE_DELETE_COPY_MOVE(SimQuantum);
+
+    //!@{
+    //! \name Accessors
+    size_type num_results() const { return results_.size(); }
+    size_type num_qubits() const { return state_ ? state_->num_qubits() : 0; }
+    size_type remaining_shots() const
+    {
+        return opts_.shots - completed_shots_;
+    }
+    size_type num_executions() const { return num_executions_; }
+    size_type num_pending_branches() const { return branches_.size(); }
+    GateFuser::Counters const& fusion_counters() const;
+    //!@}
+
+    //!@{
+    //! \name Quantum interface
+    // Prepare to build a quantum circuit for an entry point
+    void set_up(EntryPointAttrs const&) override;
+
+    // Complete an execution
+    void tear_down() override;
+
+    // Make more qubits available during an execution
+    void reserve_qubits(size_type num_qubits) override;
+
+    // Label a result with the program's qubit
+    void label_result(Result, Qubit) final;
+
+    // Measure a qubit into a new result
+    Result m(Qubit) final;
+
+    // Measure a qubit into a new result and reset it
+    Result mresetz(Qubit) final;
+
+    // Measure a qubit into a result
+    void mz(Qubit, Result) final;
+
+    // Read the value of a result.
+    QState read_result(Result) final;
+    //!@}
+
+    //!@{
+    //! \name Runtime interface
+    // Initialize the execution environment, resetting qubits
+    void initialize(OptionalCString env) override;
+
+    // Mark the start of an array of results
+    void array_record_output(size_type, OptionalCString tag) final;
+
+    // Save one result
+    void result_record_output(Result result, OptionalCString tag) final;
+
+    // No one uses tuples??
+    void tuple_record_output(size_type, OptionalCString) final;
+
+    // Get a constant result that reads as |0>
+    Result result_get_zero() final { return ResultPool::zero(); }
+
+    // Get a constant result that reads as |1>
+    Result result_get_one() final { return ResultPool::one(); }
+
+    // Whether two results have the same measured value
+    bool result_equal(Result, Result) final;
+
+    // Change the reference count of a result returned by m or mresetz
+    void result_update_reference_count(Result, std::int32_t delta) final;
+    //!@}
+
+    //!@{
+    //! \name Gates
+    void cnot(Qubit, Qubit) final;
+    void cx(Qubit, Qubit) final;
+    void cy(Qubit, Qubit) final;
+    void cz(Qubit, Qubit) final;
+    void h(Qubit) final;
+    void r_adj(Pauli, double, Qubit) final;
+    void r(Pauli, double, Qubit) final;
+    void reset(Qubit) final;
+    void rx(double, Qubit) final;
+    void rxx(double, Qubit, Qubit) final;
+    void ry(double, Qubit) final;
+    void ryy(double, Qubit, Qubit) final;
+    void rz(double, Qubit) final;
+    void rzz(double, Qubit, Qubit) final;
+    void s(Qubit) final;
+    void s_adj(Qubit) final;
+    void swap(Qubit, Qubit) final;
+    void t(Qubit) final;
+    void t_adj(Qubit) final;
+    void x(Qubit) final;
+    void y(Qubit) final;
+    void z(Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Pauli exponentials
+    void exp(Array, double, Array) final;
+    void exp_adj(Array, double, Array) final;
+    void exp(Array, Tuple) final;
+    void exp_adj(Array, Tuple) final;
+    //!@}
+
+    //!@{
+    //! \name Controlled gates
+    void h(Array, Qubit) final;
+    void r(Array, Tuple) final;
+    void r_adj(Array, Tuple) final;
+    void rx(Array, Tuple) final;
+    void ry(Array, Tuple) final;
+    void rz(Array, Tuple) final;
+    void s(Array, Qubit) final;
+    void s_adj(Array, Qubit) final;
+    void t(Array, Qubit) final;
+    void t_adj(Array, Qubit) final;
+    void x(Array, Qubit) final;
+    void y(Array, Qubit) final;
+    void z(Array, Qubit) final;
+    //!@}
+
+    //!@{
+    //! \name Assertions
+    void assertmeasurementprobability(
+        Array, Array, Result, double, String, double) final;
+    void assertmeasurementprobability(Array, Tuple) final;
+    //!@}
+
+  private:
+    //// TYPES ////
+
+    using value_type = StateVector::value_type;
+
+    //! Tally of a single recorded output over all shots
+    struct RecordCounts
+    {
+        Qubit qubit;
+        std::string tag;
+        size_type counts[2]{0, 0};
+    };
+
+    //! Shots that diverged from an execution at a measurement
+    struct Branch
+    {
+        size_type num_shots;
+        std::vector<QState> history;
+        StateVector state;
+    };
+
+    //// DATA ////
+
+    std::ostream& output_;
+    Options opts_;
+    size_type completed_shots_{0};
+    size_type num_executions_{0};
+    std::mt19937_64 rng_;
+
+    std::unique_ptr<StateVector> state_;
+    std::unique_ptr<GateFuser> fuser_;
+    ResultPool results_;
+    std::vector<Qubit> result_to_qubit_;
+
+    // Measurements not yet collapsed in the current execution
+    bool deferring_{false};
+    std::vector<size_type> deferred_qubits_;
+    std::vector<Result> deferred_results_;
+    std::vector<bool> is_deferred_;
+
+    // Shots represented by the current execution
+    size_type num_shots_{1};
+    std::vector<QState> history_;
+    std::vector<QState> replay_;
+    std::vector<Branch> branches_;
+
+    std::vector<RecordCounts> records_;
+    std::vector<Result> recorded_;
+    std::vector<size_type> direct_qubits_;
+
+    //// HELPER FUNCTIONS ////
+
+    // Buffer a one-qubit gate
+    void apply(value_type const* matrix, Qubit q);
+
+    // Buffer a two-qubit gate
+    void apply(value_type const* matrix, Qubit q1, Qubit q2);
+
+    // Apply a one-qubit gate with an array of control qubits
+    void apply(value_type const* matrix, Array ctls, Qubit q);
+
+    // Apply a Pauli exponential, optionally with control qubits
+    void apply_exp(Array paulis, double theta, Array qubits, Array ctls);
+
+    // Convert a Pauli array on the listed qubits to X and Z bitmasks
+    void pauli_masks(Array paulis, size_type* x_mask, size_type* z_mask) const;
+
+    // Prepare to update the listed qubits directly in the state
+    bool prepare_direct();
+
+    // Whether the current execution is replaying a measurement history
+    bool replaying() const { return history_.size() < replay_.size(); }
+
+    // Sample and collapse a single qubit
+    QState measure_qubit(Qubit q);
+
+    // Split the current shots between two measurement outcomes
+    QState branch(Qubit q, double p_one);
+
+    // Collapse deferred measurements because the program needs them
+    void end_deferral();
+
+    // Complete the shots represented by this execution
+    void tally_records();
+
+    // Write tallied results
+    void write_output();
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
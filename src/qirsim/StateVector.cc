@@ -0,0 +1,432 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVector.cc
+//---------------------------------------------------------------------------//
+#include "StateVector.hh"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <thread>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Maximum number of qubits in a dense matrix application
+constexpr size_type max_apply_qubits = 5;
+
+//! Number of amplitudes summed by each task of a threaded reduction
+constexpr size_type reduction_chunk_size = size_type(1) << 16;
+
+//---------------------------------------------------------------------------//
+/*!
+ * Insert zero bits at the given (sorted, ascending) positions.
+ */
+inline size_type
+insert_zero_bits(size_type i, size_type const* sorted, size_type count)
+{
+    for (size_type j = 0; j != count; ++j)
+    {
+        size_type const p = sorted[j];
+        size_type const low = i & ((size_type(1) << p) - 1);
+        i = ((i >> p) << (p + 1)) | low;
+    }
+    return i;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Count the set bits of an index.
+ */
+inline size_type popcount(size_type bits)
+{
+#if defined(__clang__) || defined(__GNUC__)
+    return __builtin_popcountll(bits);
+#else
+    size_type result = 0;
+    for (; bits != 0; bits &= bits - 1)
+    {
+        ++result;
+    }
+    return result;
+#endif
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct in the |0...0> state.
+ */
+StateVector::StateVector(size_type num_qubits)
+{
+    this->resize(num_qubits);
+    amplitudes_.front() = 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Reset to the |0...0> state.
+ */
+void StateVector::reset()
+{
+    std::fill(amplitudes_.begin(), amplitudes_.end(), value_type{0});
+    amplitudes_.front() = 1;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the number of qubits, keeping existing amplitudes.
+ *
+ * Added qubits are the most significant bits of the amplitude index, so
+ * zero-filling the new amplitudes leaves them in |0>. Qubits removed by
+ * shrinking must be in |0>. The storage capacity is kept, so growing again to
+ * an earlier size does not allocate.
+ */
+void StateVector::resize(size_type num_qubits)
+{
+    QIREE_VALIDATE(num_qubits < 8 * sizeof(size_type) - 1,
+                   << "invalid number of qubits " << num_qubits
+                   << " for a state vector");
+    amplitudes_.resize(size_type(1) << num_qubits, value_type{0});
+    num_qubits_ = num_qubits;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a dense matrix to an ordered list of qubits.
+ *
+ * The matrix is \f$ 2^k \times 2^k \f$ in row-major order, and the first qubit
+ * in the list is the least significant bit of the matrix index. The state is
+ * traversed once: each of the \f$ 2^{n-k} \f$ groups of coupled amplitudes is
+ * gathered, multiplied, and scattered back.
+ */
+void StateVector::apply(size_type const* qubits,
+                        size_type num_qubits,
+                        value_type const* matrix)
+{
+    QIREE_EXPECT(qubits && matrix);
+    QIREE_EXPECT(num_qubits > 0 && num_qubits <= max_apply_qubits);
+    QIREE_EXPECT(num_qubits <= num_qubits_);
+
+    size_type const dim = size_type(1) << num_qubits;
+
+    // Sort bit positions for index expansion
+    std::array<size_type, max_apply_qubits> sorted;
+    std::copy(qubits, qubits + num_qubits, sorted.begin());
+    std::sort(sorted.begin(), sorted.begin() + num_qubits);
+    QIREE_EXPECT(sorted[num_qubits - 1] < num_qubits_);
+    QIREE_EXPECT(std::adjacent_find(sorted.begin(),
+                                    sorted.begin() + num_qubits)
+                 == sorted.begin() + num_qubits);
+
+    // Offset of each matrix index in the full state
+    std::array<size_type, size_type(1) << max_apply_qubits> offsets;
+    for (size_type j = 0; j != dim; ++j)
+    {
+        size_type offset = 0;
+        for (size_type b = 0; b != num_qubits; ++b)
+        {
+            if (j & (size_type(1) << b))
+            {
+                offset |= size_type(1) << qubits[b];
+            }
+        }
+        offsets[j] = offset;
+    }
+
+    std::array<value_type, size_type(1) << max_apply_qubits> local;
+    value_type* amp = amplitudes_.data();
+    size_type const num_groups = amplitudes_.size() >> num_qubits;
+    for (size_type i = 0; i != num_groups; ++i)
+    {
+        size_type const base = insert_zero_bits(i, sorted.data(), num_qubits);
+        for (size_type j = 0; j != dim; ++j)
+        {
+            local[j] = amp[base + offsets[j]];
+        }
+        value_type const* row = matrix;
+        for (size_type r = 0; r != dim; ++r, row += dim)
+        {
+            value_type sum{0};
+            for (size_type c = 0; c != dim; ++c)
+            {
+                sum += row[c] * local[c];
+            }
+            amp[base + offsets[r]] = sum;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a 2x2 matrix to a qubit where all control qubits are set.
+ *
+ * With \em k controls, only the \f$ 2^{n-k-1} \f$ pairs of amplitudes that
+ * differ in the target bit and have every control bit set are visited. The
+ * remaining "free" bits are enumerated directly with the subset iteration
+ * \c f = (f - free_mask) & free_mask , and the fixed bits are OR'd in.
+ * Diagonal matrices (e.g. controlled phases) skip the coupling, and if the
+ * upper-left element is one only the amplitude with the target set changes.
+ */
+void StateVector::apply_controlled(size_type const* controls,
+                                   size_type num_controls,
+                                   size_type target,
+                                   value_type const* matrix)
+{
+    QIREE_EXPECT(controls || num_controls == 0);
+    QIREE_EXPECT(matrix);
+    QIREE_EXPECT(target < num_qubits_);
+
+    size_type const target_mask = size_type(1) << target;
+    size_type ctl_mask = 0;
+    for (size_type i = 0; i != num_controls; ++i)
+    {
+        QIREE_EXPECT(controls[i] < num_qubits_ && controls[i] != target);
+        size_type const bit = size_type(1) << controls[i];
+        QIREE_EXPECT(!(ctl_mask & bit));
+        ctl_mask |= bit;
+    }
+    size_type const free_mask = (amplitudes_.size() - 1)
+                                & ~(ctl_mask | target_mask);
+
+    value_type const m00 = matrix[0];
+    value_type const m01 = matrix[1];
+    value_type const m10 = matrix[2];
+    value_type const m11 = matrix[3];
+    bool const diagonal = (m01 == value_type{0} && m10 == value_type{0});
+    bool const phase_only = diagonal && m00 == value_type{1};
+
+    value_type* amp = amplitudes_.data();
+    size_type f = 0;
+    do
+    {
+        size_type const i0 = f | ctl_mask;
+        size_type const i1 = i0 | target_mask;
+        if (phase_only)
+        {
+            amp[i1] *= m11;
+        }
+        else if (diagonal)
+        {
+            amp[i0] *= m00;
+            amp[i1] *= m11;
+        }
+        else
+        {
+            value_type const a0 = amp[i0];
+            value_type const a1 = amp[i1];
+            amp[i0] = m00 * a0 + m01 * a1;
+            amp[i1] = m10 * a0 + m11 * a1;
+        }
+        f = (f - free_mask) & free_mask;
+    } while (f != 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Apply exp(i theta P) for a Pauli string given as X and Z bitmasks.
+ *
+ * Qubit \em q of the Pauli string is X if only bit \em q of \c x_mask is
+ * set, Z if only bit \em q of \c z_mask is set, and Y if both are set, so
+ * that \f$ P|b\rangle = i^{n_Y} (-1)^{|b \wedge z|} |b \oplus x\rangle \f$.
+ * Since \f$ P^2 = 1 \f$, \f$ e^{i\theta P} = \cos\theta + i \sin\theta P
+ * \f$ couples each amplitude with the one whose X bits are flipped: the pairs
+ * are visited once, with the sign of each term given by the parity of its Z
+ * bits. A string without X or Y is diagonal and only rescales amplitudes.
+ * Only the amplitudes where every bit of \c ctl_mask is set are changed.
+ */
+void StateVector::exp_pauli(size_type x_mask,
+                            size_type z_mask,
+                            real_type theta,
+                            size_type ctl_mask)
+{
+    size_type const all_mask = amplitudes_.size() - 1;
+    QIREE_EXPECT(((x_mask | z_mask | ctl_mask) & ~all_mask) == 0);
+    QIREE_EXPECT(((x_mask | z_mask) & ctl_mask) == 0);
+
+    value_type const cos_theta{std::cos(theta)};
+    value_type const isin_theta{0, std::sin(theta)};
+    value_type* amp = amplitudes_.data();
+
+    if (x_mask == 0)
+    {
+        // Diagonal: exp(+i theta) for even Z parity, exp(-i theta) for odd
+        value_type const even = cos_theta + isin_theta;
+        value_type const odd = cos_theta - isin_theta;
+        size_type const free_mask = all_mask & ~ctl_mask;
+        size_type f = 0;
+        do
+        {
+            size_type const i = f | ctl_mask;
+            amp[i] *= (popcount(i & z_mask) & 1) ? odd : even;
+            f = (f - free_mask) & free_mask;
+        } while (f != 0);
+        return;
+    }
+
+    // Factor i^{n_Y} from the Y = iXZ terms, times i sin(theta)
+    static value_type const i_pow[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    value_type const coupling = isin_theta
+                                * i_pow[popcount(x_mask & z_mask) % 4];
+
+    // Visit each pair once from the member with the lowest X bit clear
+    size_type const pivot = x_mask & (~x_mask + 1);
+    size_type const free_mask = all_mask & ~(ctl_mask | pivot);
+    size_type f = 0;
+    do
+    {
+        size_type const i0 = f | ctl_mask;
+        size_type const i1 = i0 ^ x_mask;
+        value_type const a0 = amp[i0];
+        value_type const a1 = amp[i1];
+        value_type const c0 = (popcount(i0 & z_mask) & 1) ? -coupling
+                                                           : coupling;
+        value_type const c1 = (popcount(i1 & z_mask) & 1) ? -coupling
+                                                           : coupling;
+        amp[i0] = cos_theta * a0 + c1 * a1;
+        amp[i1] = cos_theta * a1 + c0 * a0;
+        f = (f - free_mask) & free_mask;
+    } while (f != 0);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Expectation value of a Pauli string given as X and Z bitmasks.
+ *
+ * The masks have the same meaning as in \c exp_pauli , and
+ * \f$ \langle P \rangle = \mathrm{Re}\, i^{n_Y} \sum_b (-1)^{|b \wedge z|}
+ * a^*_{b \oplus x} a_b \f$ is accumulated over fixed chunks of the state.
+ * Large states are reduced on multiple threads (all available ones if \c
+ * num_threads is zero); the chunk sums are added in order, so the result does
+ * not depend on the number of threads.
+ */
+auto StateVector::expectation_pauli(size_type x_mask,
+                                    size_type z_mask,
+                                    size_type num_threads) const -> real_type
+{
+    QIREE_EXPECT(((x_mask | z_mask) & ~(amplitudes_.size() - 1)) == 0);
+
+    value_type const* amp = amplitudes_.data();
+    size_type const size = amplitudes_.size();
+    auto sum_chunk = [amp, size, x_mask, z_mask](size_type chunk) {
+        size_type const begin = chunk * reduction_chunk_size;
+        size_type const end = std::min(begin + reduction_chunk_size, size);
+        value_type result{0};
+        for (size_type i = begin; i != end; ++i)
+        {
+            value_type const term = std::conj(amp[i ^ x_mask]) * amp[i];
+            result += (popcount(i & z_mask) & 1) ? -term : term;
+        }
+        return result;
+    };
+
+    size_type const num_chunks = (size + reduction_chunk_size - 1)
+                                 / reduction_chunk_size;
+    if (num_threads == 0)
+    {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    num_threads = std::min(num_threads, num_chunks);
+
+    std::vector<value_type> chunk_sums(num_chunks);
+    if (num_threads <= 1)
+    {
+        for (size_type c = 0; c != num_chunks; ++c)
+        {
+            chunk_sums[c] = sum_chunk(c);
+        }
+    }
+    else
+    {
+        // Each thread takes every num_threads-th chunk
+        std::vector<std::thread> threads;
+        threads.reserve(num_threads);
+        for (size_type t = 0; t != num_threads; ++t)
+        {
+            threads.emplace_back([&, t] {
+                for (size_type c = t; c < num_chunks; c += num_threads)
+                {
+                    chunk_sums[c] = sum_chunk(c);
+                }
+            });
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+    }
+    value_type total{0};
+    for (value_type const& s : chunk_sums)
+    {
+        total += s;
+    }
+
+    // Factor i^{n_Y} from the Y = iXZ terms
+    static value_type const i_pow[] = {{1, 0}, {0, 1}, {-1, 0}, {0, -1}};
+    return std::real(i_pow[popcount(x_mask & z_mask) % 4] * total);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Probability of measuring |1> on a qubit.
+ */
+auto StateVector::probability_one(size_type qubit) const -> real_type
+{
+    QIREE_EXPECT(qubit < num_qubits_);
+
+    size_type const mask = size_type(1) << qubit;
+    real_type result = 0;
+    for (size_type i = 0; i != amplitudes_.size(); ++i)
+    {
+        if (i & mask)
+        {
+            result += std::norm(amplitudes_[i]);
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Project a qubit onto a measured state and renormalize.
+ */
+void StateVector::collapse(size_type qubit, QState outcome)
+{
+    QIREE_EXPECT(qubit < num_qubits_);
+
+    size_type const mask = size_type(1) << qubit;
+    size_type const keep = (outcome == QState::one ? mask : 0);
+    real_type norm = 0;
+    for (size_type i = 0; i != amplitudes_.size(); ++i)
+    {
+        if ((i & mask) == keep)
+        {
+            norm += std::norm(amplitudes_[i]);
+        }
+        else
+        {
+            amplitudes_[i] = 0;
+        }
+    }
+    QIREE_VALIDATE(norm > 0,
+                   << "cannot collapse qubit " << qubit
+                   << " onto a state with zero probability");
+
+    real_type const scale = 1 / std::sqrt(norm);
+    for (auto& a : amplitudes_)
+    {
+        a *= scale;
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,113 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVector.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <complex>
+#include <initializer_list>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Dense state vector of an N-qubit register.
+ *
+ * Qubit \c i corresponds to bit \c i of the amplitude index (little endian).
+ * Gates are applied as dense \f$ 2^k \times 2^k \f$ row-major matrices
+ * on an ordered list of \em k qubits, where the first listed qubit is the
+ * least significant bit of the matrix row/column index. Every application
+ * sweeps the full state once, so callers should batch small gates (see
+ * \c GateFuser) rather than applying them one at a time.
+ *
+ * Single-qubit gates with any number of controls have a dedicated kernel
+ * that visits only the amplitudes whose control bits are all set, and Pauli
+ * exponentials on any number of qubits are applied in a single sweep. The
+ * expectation value of a Pauli string, and hence the exact probability of a
+ * joint Pauli measurement, is likewise a single (threaded) reduction.
+ */
+class StateVector
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using value_type = std::complex<double>;
+    using VecValue = std::vector<value_type>;
+    using real_type = double;
+    //!@}
+
+  public:
+    // Construct in the |0...0> state
+    explicit StateVector(size_type num_qubits);
+
+    // Reset to the |0...0> state
+    void reset();
+
+    // Change the number of qubits, keeping existing amplitudes
+    void resize(size_type num_qubits);
+
+    // Apply a dense matrix to an ordered list of qubits
+    void apply(size_type const* qubits,
+               size_type num_qubits,
+               value_type const* matrix);
+
+    // Apply a dense matrix to an ordered list of qubits
+    inline void apply(std::initializer_list<size_type> qubits,
+                      value_type const* matrix);
+
+    // Apply a 2x2 matrix to a qubit where all control qubits are set
+    void apply_controlled(size_type const* controls,
+                          size_type num_controls,
+                          size_type target,
+                          value_type const* matrix);
+
+    // Apply exp(i theta P) for a Pauli string given as X and Z bitmasks
+    void exp_pauli(size_type x_mask,
+                   size_type z_mask,
+                   real_type theta,
+                   size_type ctl_mask = 0);
+
+    // Expectation value of a Pauli string given as X and Z bitmasks
+    real_type expectation_pauli(size_type x_mask,
+                                size_type z_mask,
+                                size_type num_threads = 0) const;
+
+    // Probability of measuring |1> on a qubit
+    real_type probability_one(size_type qubit) const;
+
+    // Project a qubit onto a measured state and renormalize
+    void collapse(size_type qubit, QState outcome);
+
+    //!@{
+    //! \name Accessors
+    size_type num_qubits() const { return num_qubits_; }
+    size_type size() const { return amplitudes_.size(); }
+    VecValue const& amplitudes() const { return amplitudes_; }
+    VecValue& amplitudes() { return amplitudes_; }
+    //!@}
+
+  private:
+    size_type num_qubits_;
+    VecValue amplitudes_;
+};
+
+//---------------------------------------------------------------------------//
+// INLINE DEFINITIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Apply a dense matrix to an ordered list of qubits.
+ */
+void StateVector::apply(std::initializer_list<size_type> qubits,
+                        value_type const* matrix)
+{
+    return this->apply(qubits.begin(), qubits.size(), matrix);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,150 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/GateMatrices.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <complex>
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+//!@{
+//! \name Dense gate matrices
+//! Row-major; for two-qubit gates the first qubit is the low bit.
+using Complex = std::complex<double>;
+using Matrix2 = std::array<Complex, 4>;
+using Matrix4 = std::array<Complex, 16>;
+//!@}
+
+//---------------------------------------------------------------------------//
+// CONSTANT GATES
+//---------------------------------------------------------------------------//
+
+inline constexpr double sqrt_half = 0.70710678118654752440;
+inline constexpr Complex c0{0, 0};
+inline constexpr Complex c1{1, 0};
+inline constexpr Complex ci{0, 1};
+inline constexpr Complex cm1{-1, 0};
+inline constexpr Complex cmi{0, -1};
+
+inline constexpr Matrix2 h_gate{Complex{sqrt_half},
+                                Complex{sqrt_half},
+                                Complex{sqrt_half},
+                                Complex{-sqrt_half}};
+inline constexpr Matrix2 x_gate{c0, c1, c1, c0};
+inline constexpr Matrix2 y_gate{c0, cmi, ci, c0};
+inline constexpr Matrix2 z_gate{c1, c0, c0, cm1};
+inline constexpr Matrix2 s_gate{c1, c0, c0, ci};
+inline constexpr Matrix2 s_adj_gate{c1, c0, c0, cmi};
+inline constexpr Matrix2 t_gate{c1, c0, c0, Complex{sqrt_half, sqrt_half}};
+inline constexpr Matrix2 t_adj_gate{
+    c1, c0, c0, Complex{sqrt_half, -sqrt_half}};
+
+// Two-qubit gates with (control, target) ordering
+// clang-format off
+inline constexpr Matrix4 cx_gate{
+    c1, c0, c0, c0,
+    c0, c0, c0, c1,
+    c0, c0, c1, c0,
+    c0, c1, c0, c0};
+inline constexpr Matrix4 cy_gate{
+    c1, c0, c0, c0,
+    c0, c0, c0, cmi,
+    c0, c0, c1, c0,
+    c0, ci, c0, c0};
+inline constexpr Matrix4 cz_gate{
+    c1, c0, c0, c0,
+    c0, c1, c0, c0,
+    c0, c0, c1, c0,
+    c0, c0, c0, cm1};
+inline constexpr Matrix4 swap_gate{
+    c1, c0, c0, c0,
+    c0, c0, c1, c0,
+    c0, c1, c0, c0,
+    c0, c0, c0, c1};
+// clang-format on
+
+//---------------------------------------------------------------------------//
+// ROTATIONS
+//---------------------------------------------------------------------------//
+//! Phase rotation exp(-i theta/2)
+inline Complex half_phase(double theta)
+{
+    return {std::cos(theta / 2), -std::sin(theta / 2)};
+}
+
+inline Matrix2 rx_gate(double theta)
+{
+    double c = std::cos(theta / 2), s = std::sin(theta / 2);
+    return {Complex{c}, Complex{0, -s}, Complex{0, -s}, Complex{c}};
+}
+
+inline Matrix2 ry_gate(double theta)
+{
+    double c = std::cos(theta / 2), s = std::sin(theta / 2);
+    return {Complex{c}, Complex{-s}, Complex{s}, Complex{c}};
+}
+
+inline Matrix2 rz_gate(double theta)
+{
+    Complex p = half_phase(theta);
+    return {p, c0, c0, std::conj(p)};
+}
+
+//! Global phase exp(-i theta/2) (rotation about the identity)
+inline Matrix2 ri_gate(double theta)
+{
+    Complex p = half_phase(theta);
+    return {p, c0, c0, p};
+}
+
+// clang-format off
+inline Matrix4 rxx_gate(double theta)
+{
+    Complex c{std::cos(theta / 2)}, s{0, -std::sin(theta / 2)};
+    return {c,  c0, c0, s,
+            c0, c,  s,  c0,
+            c0, s,  c,  c0,
+            s,  c0, c0, c};
+}
+
+inline Matrix4 ryy_gate(double theta)
+{
+    Complex c{std::cos(theta / 2)}, s{0, std::sin(theta / 2)};
+    return {c,  c0, c0, s,
+            c0, c,  -s, c0,
+            c0, -s, c,  c0,
+            s,  c0, c0, c};
+}
+
+inline Matrix4 rzz_gate(double theta)
+{
+    Complex p = half_phase(theta);
+    Complex q = std::conj(p);
+    return {p,  c0, c0, c0,
+            c0, q,  c0, c0,
+            c0, c0, q,  c0,
+            c0, c0, c0, p};
+}
+
+//! Singly controlled version of a gate with (control, target) ordering
+inline Matrix4 controlled_gate(Matrix2 const& m)
+{
+    return {c1, c0, c0, c0,
+            c0, m[0], c0, m[1],
+            c0, c0, c1, c0,
+            c0, m[2], c0, m[3]};
+}
+// clang-format on
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,208 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/Svd.cc
+//---------------------------------------------------------------------------//
+#include "Svd.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace detail
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+using Complex = std::complex<double>;
+
+constexpr double jacobi_tolerance = 1e-15;
+constexpr int max_sweeps = 64;
+
+//---------------------------------------------------------------------------//
+/*!
+ * One-sided Jacobi SVD for a tall matrix stored column-major.
+ *
+ * On output the columns of \c w are orthogonal with norms equal to the
+ * singular values, and \c v (column-major, cols x cols) accumulates the
+ * rotations so that A V = W.
+ */
+void jacobi_columns(size_type rows,
+                    size_type cols,
+                    std::vector<Complex>* w,
+                    std::vector<Complex>* v)
+{
+    v->assign(cols * cols, Complex{});
+    for (size_type j = 0; j != cols; ++j)
+    {
+        (*v)[j * cols + j] = 1;
+    }
+
+    for (int sweep = 0; sweep != max_sweeps; ++sweep)
+    {
+        bool rotated = false;
+        for (size_type p = 0; p + 1 < cols; ++p)
+        {
+            Complex* wp = w->data() + p * rows;
+            for (size_type q = p + 1; q != cols; ++q)
+            {
+                Complex* wq = w->data() + q * rows;
+                double alpha = 0;
+                double beta = 0;
+                Complex gamma{};
+                for (size_type i = 0; i != rows; ++i)
+                {
+                    alpha += std::norm(wp[i]);
+                    beta += std::norm(wq[i]);
+                    gamma += std::conj(wp[i]) * wq[i];
+                }
+                double const abs_gamma = std::abs(gamma);
+                if (abs_gamma <= jacobi_tolerance * std::sqrt(alpha * beta))
+                {
+                    continue;
+                }
+                rotated = true;
+
+                // Remove the phase of the off-diagonal element, then apply a
+                // real rotation that diagonalizes the 2x2 Gram matrix
+                Complex const phase = std::conj(gamma) / abs_gamma;
+                double const zeta = (beta - alpha) / (2 * abs_gamma);
+                double const t = (zeta >= 0 ? 1.0 : -1.0)
+                                 / (std::abs(zeta) + std::hypot(1.0, zeta));
+                double const c = 1 / std::sqrt(1 + t * t);
+                double const s = c * t;
+
+                auto rotate = [&](Complex* x, Complex* y, size_type n) {
+                    for (size_type i = 0; i != n; ++i)
+                    {
+                        Complex const xi = x[i];
+                        Complex const yi = y[i] * phase;
+                        x[i] = c * xi - s * yi;
+                        y[i] = s * xi + c * yi;
+                    }
+                };
+                rotate(wp, wq, rows);
+                rotate(v->data() + p * cols, v->data() + q * cols, cols);
+            }
+        }
+        if (!rotated)
+            return;
+    }
+}
+
+//---------------------------------------------------------------------------//
+//! Decompose a tall (rows >= cols) row-major matrix
+SvdResult svd_tall(size_type rows, size_type cols, Complex const* a)
+{
+    // Copy to column-major and orthogonalize the columns
+    std::vector<Complex> w(rows * cols);
+    for (size_type i = 0; i != rows; ++i)
+    {
+        for (size_type j = 0; j != cols; ++j)
+        {
+            w[j * rows + i] = a[i * cols + j];
+        }
+    }
+    std::vector<Complex> v;
+    jacobi_columns(rows, cols, &w, &v);
+
+    std::vector<double> norms(cols);
+    for (size_type j = 0; j != cols; ++j)
+    {
+        double n = 0;
+        for (size_type i = 0; i != rows; ++i)
+        {
+            n += std::norm(w[j * rows + i]);
+        }
+        norms[j] = std::sqrt(n);
+    }
+    std::vector<size_type> order(cols);
+    std::iota(order.begin(), order.end(), size_type{0});
+    std::stable_sort(
+        order.begin(), order.end(), [&](size_type l, size_type r) {
+            return norms[l] > norms[r];
+        });
+
+    SvdResult result;
+    result.rank = cols;
+    result.u.assign(rows * cols, Complex{});
+    result.s.resize(cols);
+    result.vh.resize(cols * cols);
+    for (size_type k = 0; k != cols; ++k)
+    {
+        size_type const j = order[k];
+        double const sigma = norms[j];
+        result.s[k] = sigma;
+        if (sigma > 0)
+        {
+            for (size_type i = 0; i != rows; ++i)
+            {
+                result.u[i * cols + k] = w[j * rows + i] / sigma;
+            }
+        }
+        for (size_type c = 0; c != cols; ++c)
+        {
+            result.vh[k * cols + c] = std::conj(v[j * cols + c]);
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Decompose a dense row-major complex matrix.
+ *
+ * This uses one-sided (Hestenes) Jacobi rotations, which are simple and
+ * accurate for the small matrices that arise in tensor network updates.
+ * Left singular vectors for zero singular values are left as zero columns.
+ */
+SvdResult svd(size_type rows, size_type cols, Complex const* a)
+{
+    QIREE_EXPECT(rows > 0 && cols > 0);
+    if (rows >= cols)
+    {
+        return svd_tall(rows, cols, a);
+    }
+
+    // Decompose the conjugate transpose A^H = U' S V'^H, so A = V' S U'^H
+    std::vector<Complex> ah(cols * rows);
+    for (size_type i = 0; i != rows; ++i)
+    {
+        for (size_type j = 0; j != cols; ++j)
+        {
+            ah[j * rows + i] = std::conj(a[i * cols + j]);
+        }
+    }
+    SvdResult temp = svd_tall(cols, rows, ah.data());
+
+    SvdResult result;
+    result.rank = rows;
+    result.s = std::move(temp.s);
+    result.u.resize(rows * rows);
+    result.vh.resize(rows * cols);
+    for (size_type k = 0; k != rows; ++k)
+    {
+        for (size_type i = 0; i != rows; ++i)
+        {
+            result.u[i * rows + k] = std::conj(temp.vh[k * rows + i]);
+        }
+        for (size_type c = 0; c != cols; ++c)
+        {
+            result.vh[k * cols + c] = std::conj(temp.u[c * rows + k]);
+        }
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -0,0 +1,37 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/detail/Svd.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <complex>
+#include <vector>
+
+#include "qiree/Types.hh"
+
+namespace qiree
+{
+namespace detail
+{
+//---------------------------------------------------------------------------//
+//! Thin singular value decomposition A = U diag(s) V^H
+struct SvdResult
+{
+    using Complex = std::complex<double>;
+
+    size_type rank{0};  //!< Number of singular values, min(rows, cols)
+    std::vector<Complex> u;  //!< Row-major [rows x rank]
+    std::vector<double> s;  //!< Singular values in descending order
+    std::vector<Complex> vh;  //!< Row-major [rank x cols]
+};
+
+//---------------------------------------------------------------------------//
+// Decompose a dense row-major complex matrix
+SvdResult svd(size_type rows, size_type cols, std::complex<double> const* a);
+
+//---------------------------------------------------------------------------//
+}  // namespace detail
+}  // namespace qiree
@@ -8,9 +8,13 @@
 #include "XaccQuantum.hh"
 
 #include <algorithm>
+#include <exception>
 #include <iostream>
+#include <map>
+#include <numeric>
 #include <utility>
 #include <stdexcept>
+#include <thread>
 #include <xacc/xacc.hpp>
 
 #include "qiree/Assert.hh"
@@ -19,46 +23,178 @@ using xacc::constants::pi;
 
 namespace qiree
 {
+namespace
+{
 //---------------------------------------------------------------------------//
 /*!
- * Call initialize explicitly with args.
+ * Get the XACC instruction name for a recorded gate.
+ *
+ * Gates that this backend does not emit return null.
  */
-void XaccQuantum::xacc_init(std::vector<std::string> args)
+char const* xacc_name(GateOp op)
 {
-    xacc::Initialize(std::move(args));
+    switch (op)
+    {
+        // clang-format off
+        case GateOp::ccx: return "CCX";
+        case GateOp::cnot: return "CNOT";
+        case GateOp::cx: return "CX";
+        case GateOp::cy: return "CY";
+        case GateOp::cz: return "CZ";
+        case GateOp::h: return "H";
+        case GateOp::mz: return "Measure";
+        case GateOp::reset: return "Reset";
+        case GateOp::rx: return "Rx";
+        case GateOp::ry: return "Ry";
+        case GateOp::rz: return "Rz";
+        case GateOp::rzz: return "RZZ";
+        case GateOp::x: return "X";
+        case GateOp::y: return "Y";
+        case GateOp::z: return "Z";
+        default: return nullptr;
+        // clang-format on
+    }
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Construct with accelerator name and number of shots.
+ * Derive an independent accelerator seed for a worker.
+ *
+ * This uses the SplitMix64 finalizer so that consecutive workers get
+ * uncorrelated seeds, truncated to a positive \c int for XACC.
  */
-XaccQuantum::XaccQuantum(std::ostream& os,
-                         std::string const& accel_name,
-                         size_type shots)
-    : output_{os}
+int worker_seed(std::uint64_t seed, size_type worker)
 {
-    QIREE_VALIDATE(shots > 0, << "invalid number of shots " << shots);
+    std::uint64_t z = seed + 0x9e3779b97f4a7c15ull * (worker + 1);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+    z ^= z >> 31;
+    return static_cast<int>(z & 0x7fffffff);
+}
 
-    if (!xacc::isInitialized())
+//---------------------------------------------------------------------------//
+/*!
+ * Get the length of the longest measured bitstring.
+ */
+size_type max_width(std::map<std::string, int> const& counts)
+{
+    size_type result = 0;
+    for (auto const& bits_count : counts)
     {
-        // Perhaps XaccQuantum::initialize was already called?
-        xacc::Initialize();
-        // TODO: uninstall xacc signal handlers
+        result = std::max<size_type>(result, bits_count.first.size());
     }
-    QIREE_ASSERT(xacc::isInitialized());
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Call initialize explicitly with args and the plugins needed.
+ *
+ * This must be called before the first \c XaccQuantum is constructed. If
+ * any accelerators or IR providers are named, they are created immediately
+ * and no others may be used; see \c XaccSession .
+ */
+void XaccQuantum::xacc_init(std::vector<std::string> args,
+                            XaccSession::Plugins plugins)
+{
+    XaccSession::instance().initialize(std::move(args), std::move(plugins));
+}
 
-    // Tell XACC to throw exceptions rather than calling std::exit
-    xacc::setIsPyApi();
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with accelerator name and options.
+ */
+XaccQuantum::XaccQuantum(std::ostream& os,
+                         std::string const& accel_name,
+                         Options const& opts)
+    : batch_size_{opts.batch_size}
+    , per_shot_{opts.per_shot}
+    , print_buffer_{opts.output_format == ResultFormat::text}
+    , output_format_{opts.output_format}
+    , output_{&os}
+    , sink_{ResultSink::from_format(opts.output_format, os)}
+    , accel_name_{accel_name}
+    , cache_{opts.cache}
+{
+    size_type const shots = opts.shots;
+    QIREE_VALIDATE(shots > 0, << "invalid number of shots " << shots);
+    QIREE_VALIDATE(batch_size_ > 0,
+                   << "invalid batch size " << batch_size_);
+    QIREE_VALIDATE(opts.num_workers > 0,
+                   << "invalid number of workers " << opts.num_workers);
 
-    // Create accelerator
-    accelerator_ = xacc::getAccelerator(accel_name);
-    QIREE_VALIDATE(accelerator_, << "failed to create accelerator");
+    // Check out accelerators, initializing XACC if needed
+    auto& session = XaccSession::instance();
+    accelerator_ = session.acquire_accelerator(accel_name);
     accelerator_->updateConfiguration({{"shots", static_cast<int>(shots)}});
+
+    // Create worker accelerators that each run a share of the shots
+    size_type const num_workers = std::min(opts.num_workers, shots);
+    if (num_workers > 1)
+    {
+        workers_.reserve(num_workers);
+        for (size_type w = 0; w != num_workers; ++w)
+        {
+            auto accel = w == 0 ? accelerator_
+                                : session.acquire_accelerator(accel_name);
+            QIREE_VALIDATE(std::find(workers_.begin(), workers_.end(), accel)
+                               == workers_.end(),
+                           << "accelerator '" << accel_name
+                           << "' does not provide independent instances");
+            size_type worker_shots = shots / num_workers
+                                     + (w < shots % num_workers ? 1 : 0);
+            accel->updateConfiguration(
+                {{"shots", static_cast<int>(worker_shots)},
+                 {"seed", worker_seed(opts.seed, w)}});
+            workers_.push_back(std::move(accel));
+        }
+    }
     // TODO: bit order is accelerator-dependent?
     endian_ = Endianness::little;
 
     // Create providers
-    provider_ = xacc::getIRProvider("quantum");
+    provider_ = session.ir_provider("quantum");
+
+    // Create one prototype per gate kind to be cloned when building circuits
+    for (std::size_t i = 0; i != prototypes_.size(); ++i)
+    {
+        auto op = static_cast<GateOp>(i);
+        char const* name = xacc_name(op);
+        if (!name)
+            continue;
+
+        // Measurements have a qubit and a classical bit index
+        std::vector<std::size_t> bits(op == GateOp::mz ? 1 : num_args(op));
+        std::iota(bits.begin(), bits.end(), std::size_t{0});
+        std::vector<xacc::InstructionParameter> params;
+        if (op == GateOp::mz)
+        {
+            params.emplace_back(0);
+        }
+        else if (num_angles(op) > 0)
+        {
+            params.emplace_back(0.0);
+        }
+        prototypes_[i] = provider_->createInstruction(name, bits, params);
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Construct with accelerator name and number of shots.
+ */
+XaccQuantum::XaccQuantum(std::ostream& os,
+                         std::string const& accel_name,
+                         size_type shots)
+    : XaccQuantum{os, accel_name, [shots] {
+                      Options opts;
+                      opts.shots = shots;
+                      return opts;
+                  }()}
+{
 }
 
 //---------------------------------------------------------------------------//
@@ -69,11 +205,135 @@ XaccQuantum::XaccQuantum(std::ostream& os) : XaccQuantum{os, "qsim", 1} {}
 
 //---------------------------------------------------------------------------//
 /*!
- * Call finalize when xacc is destroyed.
+ * Execute all queued circuits and print their results.
+ *
+ * The circuits are submitted with a single accelerator call, which returns
+ * one child buffer per circuit in submission order.
+ */
+void XaccQuantum::flush()
+{
+    if (jobs_.empty())
+        return;
+
+    size_type num_qubits = 0;
+    std::vector<VecComposite> circuits;
+    circuits.reserve(jobs_.size());
+    for (auto const& job : jobs_)
+    {
+        num_qubits = std::max(num_qubits, job.attrs.required_num_qubits);
+        circuits.push_back(job.circuits);
+    }
+
+    std::vector<SPBuffer> children;
+    try
+    {
+        if (workers_.empty())
+        {
+            auto& session = XaccSession::instance();
+            auto buffer = session.acquire_buffer(num_qubits);
+            std::vector<SPComposite> batch;
+            batch.reserve(circuits.size());
+            for (auto const& copies : circuits)
+            {
+                batch.push_back(copies.front());
+            }
+            accelerator_->execute(buffer, batch);
+            children = buffer->getChildren();
+            session.release_buffer(std::move(buffer));
+        }
+        else
+        {
+            children = this->execute_workers(circuits, num_qubits);
+        }
+    }
+    catch (std::exception const& e)
+    {
+        std::string msg = std::string("Failed to execute XACC: ") + e.what();
+        for (auto const& job : jobs_)
+        {
+            sink_->begin(job.attrs);
+            sink_->error(msg);
+            sink_->end();
+        }
+        jobs_.clear();
+        return;
+    }
+
+    QIREE_VALIDATE(children.size() == jobs_.size(),
+                   << "accelerator returned " << children.size()
+                   << " result buffers for " << jobs_.size()
+                   << " batched circuits");
+    for (std::size_t i = 0; i != jobs_.size(); ++i)
+    {
+        auto const& job = jobs_[i];
+        if (print_buffer_)
+        {
+            children[i]->print(*output_);
+        }
+        sink_->begin(job.attrs);
+        this->tally_marginals(*children[i], job.attrs.required_num_qubits);
+        for (auto const& rec : job.records)
+        {
+            this->write_counts(rec.qubit,
+                               rec.label,
+                               rec.tag.empty() ? nullptr : rec.tag.c_str());
+        }
+        sink_->end();
+    }
+    jobs_.clear();
+    if (!workers_.empty())
+    {
+        // Merged buffers are not referenced by the accelerator
+        for (auto& child : children)
+        {
+            XaccSession::instance().release_buffer(std::move(child));
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Write the results of later executions to a different stream.
+ *
+ * This lets one instance, with its accelerators and circuit cache, serve a
+ * sequence of jobs that each have their own output. Queued executions must be
+ * flushed first. A result block left open by a failed execution is abandoned.
+ */
+void XaccQuantum::set_output(std::ostream& os)
+{
+    QIREE_EXPECT(jobs_.empty());
+    output_ = &os;
+    sink_ = ResultSink::from_format(output_format_, os);
+    sink_open_ = false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Run any queued executions and return accelerators and buffers to the
+ * session.
+ *
+ * XACC itself stays initialized until the program exits.
  */
 XaccQuantum::~XaccQuantum()
 {
-    xacc::Finalize();
+    try
+    {
+        this->flush();
+    }
+    catch (std::exception const& e)
+    {
+        // Destructors cannot throw: report and drop the remaining results
+        std::cerr << "error: failed to flush queued XACC executions: "
+                  << e.what() << std::endl;
+    }
+
+    auto& session = XaccSession::instance();
+    session.release_buffer(std::move(buffer_));
+    for (auto& accel : workers_)
+    {
+        session.release_accelerator(accel_name_, std::move(accel));
+    }
+    session.release_accelerator(accel_name_, std::move(accelerator_));
 }
 
 //---------------------------------------------------------------------------//
@@ -83,23 +343,100 @@ XaccQuantum::~XaccQuantum()
 void XaccQuantum::set_up(EntryPointAttrs const& attrs)
 {
     QIREE_EXPECT(!buffer_);
-    QIREE_VALIDATE(attrs.required_num_qubits > 0,
-                   << "input is not a quantum program");
 
-    buffer_ = xacc::qalloc(attrs.required_num_qubits);
-    cur_circuit_ = provider_->createComposite("quantum_circuit");
-    result_to_qubit_.resize(attrs.required_num_results);
+    buffer_ = XaccSession::instance().acquire_buffer(
+        attrs.required_num_qubits);
+    attrs_ = attrs;
+    tape_.set_up(attrs);
+    results_.reset(attrs.required_num_results);
+    result_to_qubit_.assign(attrs.required_num_results, Qubit{});
+    result_to_label_.assign(attrs.required_num_results, Qubit{});
     num_qubits_ = attrs.required_num_qubits;
+    executed_ = false;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available during an execution.
+ *
+ * Circuits address qubits by index, so only the buffer and the recorded
+ * attributes need to grow.
+ */
+void XaccQuantum::reserve_qubits(size_type num_qubits)
+{
+    if (num_qubits <= num_qubits_)
+        return;
+
+    num_qubits_ = num_qubits;
+    attrs_.required_num_qubits = num_qubits;
+    auto& session = XaccSession::instance();
+    session.release_buffer(std::move(buffer_));
+    buffer_ = session.acquire_buffer(num_qubits);
+    tape_.reserve_qubits(num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Label a result with the program's qubit.
+ *
+ * The counts are still read from the measured qubit; only the qubit written
+ * to the output changes.
+ */
+void XaccQuantum::label_result(Result r, Qubit q)
+{
+    QIREE_EXPECT(r.value < result_to_label_.size());
+    result_to_label_[r.value] = q;
 }
 
 //---------------------------------------------------------------------------//
 /*!
  * Complete an execution.
+ *
+ * In batch mode, the queued circuits are submitted once the batch is full.
  */
 void XaccQuantum::tear_down()
 {
-    cur_circuit_.reset();
-    buffer_.reset();
+    if (sink_open_)
+    {
+        sink_->end();
+        sink_open_ = false;
+    }
+    if (jobs_.size() >= batch_size_)
+    {
+        this->flush();
+    }
+    cur_circuits_.clear();
+    XaccSession::instance().release_buffer(std::move(buffer_));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Map a qubit to a new result.
+ *
+ * The result identifier comes from a pool so that results created by the
+ * program are recycled when it releases them.
+ */
+Result XaccQuantum::m(Qubit q)
+{
+    Result r = results_.allocate();
+    if (result_to_qubit_.size() < results_.size())
+    {
+        result_to_qubit_.resize(results_.size());
+        result_to_label_.resize(results_.size());
+    }
+    this->mz(q, r);
+    return r;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Map a qubit to a new result and reset it.
+ */
+Result XaccQuantum::mresetz(Qubit q)
+{
+    Result r = this->m(q);
+    this->reset(q);
+    return r;
 }
 
 //---------------------------------------------------------------------------//
@@ -112,7 +449,8 @@ void XaccQuantum::mz(Qubit q, Result r)
     QIREE_EXPECT(r.value < this->num_results());
 
     result_to_qubit_[r.value] = q;
-    this->add_instruction("Measure", {q}, static_cast<int>(r.value));
+    result_to_label_[r.value] = q;
+    tape_.mz(q, r);
 }
 
 //---------------------------------------------------------------------------//
@@ -139,7 +477,9 @@ else:                                             ; preds = %entry
 continue:                                         ; preds = %else, %then
  * \endcode
  *
- *
+ * XACC accelerators run the whole circuit at once, so the measured value is
+ * not available here. Dynamic circuits should be run with the native
+ * \c SimQuantum backend, which branches shots at mid-circuit measurements.
  */
 QState XaccQuantum::read_result(Result r)
 {
@@ -148,6 +488,30 @@ QState XaccQuantum::read_result(Result r)
     return QState::one;
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Compare two constant results.
+ *
+ * As with \c read_result , measured values are not available while the
+ * circuit is being built, so only the constant results can be compared.
+ */
+bool XaccQuantum::result_equal(Result a, Result b)
+{
+    QIREE_VALIDATE(ResultPool::is_constant(a) && ResultPool::is_constant(b),
+                   << "measured results cannot be compared while building an "
+                      "XACC circuit");
+    return results_.equal(a, b);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a result returned by m or mresetz.
+ */
+void XaccQuantum::result_update_reference_count(Result r, std::int32_t delta)
+{
+    results_.update_reference_count(r, delta);
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Initialize the execution environment, resetting qubits.
@@ -156,7 +520,7 @@ void XaccQuantum::initialize(OptionalCString env)
 {
     if (env)
     {
-        output_
+        *output_
             << "What's env for? No one knows! But here is some value: " << env
             << std::endl;
     }
@@ -165,18 +529,63 @@ void XaccQuantum::initialize(OptionalCString env)
 //---------------------------------------------------------------------------//
 /*!
  * Execute the circuit and read outputs.
+ *
+ * In batch mode the circuit is queued instead. Only the first array of an
+ * execution runs the circuit: later arrays record results of the same
+ * execution, within the same block of output.
  */
 void XaccQuantum::array_record_output(size_type, OptionalCString)
 {
+    if (executed_)
+        return;
+    executed_ = true;
+
+    // Reuse the circuit if this gate sequence was built before
+    if (auto const* cached = cache_.find(tape_))
+    {
+        cur_circuits_ = *cached;
+    }
+    else
+    {
+        // Workers run concurrently and may compile onto their circuit
+        cur_circuits_.clear();
+        for (size_type i = 0; i != this->num_workers(); ++i)
+        {
+            cur_circuits_.push_back(this->build_circuit());
+        }
+        cache_.insert(tape_, cur_circuits_);
+    }
+
+    if (batch_size_ > 1)
+    {
+        jobs_.push_back({cur_circuits_, attrs_, {}});
+        return;
+    }
+
+    sink_->begin(attrs_);
+    sink_open_ = true;
     try
     {
-        accelerator_->execute(buffer_, cur_circuit_);
+        if (workers_.empty())
+        {
+            accelerator_->execute(buffer_, cur_circuits_.front());
+        }
+        else
+        {
+            auto merged = this->execute_workers({cur_circuits_}, num_qubits_);
+            XaccSession::instance().release_buffer(std::move(buffer_));
+            buffer_ = std::move(merged.front());
+        }
     }
     catch (std::exception const& e)
     {
-        output_ << "Failed to execute XACC: " << e.what() << std::endl;
+        sink_->error(std::string("Failed to execute XACC: ") + e.what());
     }
-    buffer_->print(output_);
+    if (print_buffer_)
+    {
+        buffer_->print(*output_);
+    }
+    this->tally_marginals(*buffer_, num_qubits_);
 }
 
 //---------------------------------------------------------------------------//
@@ -186,19 +595,16 @@ void XaccQuantum::array_record_output(size_type, OptionalCString)
 void XaccQuantum::result_record_output(Result r, OptionalCString tag)
 {
     QIREE_EXPECT(r.value < this->num_results());
-    using BitOrder = xacc::AcceleratorBuffer::BitOrder;
 
     auto q = result_to_qubit_[r.value];
-
-    // Get a map of string ("0" and "1" ???) -> int
-    auto counts = buffer_->getMarginalCounts(
-        {static_cast<int>(q.value)},
-        endian_ == Endianness::little ? BitOrder::LSB : BitOrder::MSB);
-
-    // Print the result
-    output_ << "qubit " << q.value << " experiment " << (tag ? tag : "<null>")
-            << ": {0: " << counts["0"] << ", 1: " << counts["1"] << '}'
-            << std::endl;
+    auto label = result_to_label_[r.value];
+    if (batch_size_ > 1)
+    {
+        QIREE_EXPECT(!jobs_.empty());
+        jobs_.back().records.push_back({q, label, tag ? tag : ""});
+        return;
+    }
+    this->write_counts(q, label, tag);
 }
 
 //---------------------------------------------------------------------------//
@@ -215,51 +621,67 @@ void XaccQuantum::tuple_record_output(size_type, OptionalCString)
 //---------------------------------------------------------------------------//
 void XaccQuantum::ccx(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CCX", {q1, q2});
+    tape_.ccx(q1, q2);
 }
 void XaccQuantum::ccnot(Qubit q1, Qubit q2, Qubit q3)
 {
-    this->add_instruction("CCNOT", {q1, q2, q3});
+    // Standard decomposition into Clifford+T, since the tape only records
+    // gates in the QIS interface
+    this->h(q3);
+    this->cnot(q2, q3);
+    this->t_adj(q3);
+    this->cnot(q1, q3);
+    this->t(q3);
+    this->cnot(q2, q3);
+    this->t_adj(q3);
+    this->cnot(q1, q3);
+    this->t(q2);
+    this->t(q3);
+    this->h(q3);
+    this->cnot(q1, q2);
+    this->t(q1);
+    this->t_adj(q2);
+    this->cnot(q1, q2);
 }
 void XaccQuantum::cnot(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CNOT", {q1, q2});
+    tape_.cnot(q1, q2);
 }
 void XaccQuantum::cx(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CX", {q1, q2});
+    tape_.cx(q1, q2);
 }
 void XaccQuantum::cy(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CY", {q1, q2});
+    tape_.cy(q1, q2);
 }
 void XaccQuantum::cz(Qubit q1, Qubit q2)
 {
-    this->add_instruction("CZ", {q1, q2});
+    tape_.cz(q1, q2);
 }
 void XaccQuantum::h(Qubit q)
 {
-    this->add_instruction("H", q);
+    tape_.h(q);
 }
 void XaccQuantum::reset(Qubit q)
 {
-    this->add_instruction("Reset", q);
+    tape_.reset(q);
 }
 void XaccQuantum::rx(double angle, Qubit q)
 {
-    this->add_instruction("Rx", q, angle);
+    tape_.rx(angle, q);
 }
 void XaccQuantum::ry(double angle, Qubit q)
 {
-    this->add_instruction("Ry", q, angle);
+    tape_.ry(angle, q);
 }
 void XaccQuantum::rz(double angle, Qubit q)
 {
-    this->add_instruction("Rz", q, angle);
+    tape_.rz(angle, q);
 }
 void XaccQuantum::rzz(double angle, Qubit q1, Qubit q2)
 {
-    this->add_instruction("RZZ", {q1, q2}, angle);
+    tape_.rzz(angle, q1, q2);
 }
 void XaccQuantum::s(Qubit q)
 {
@@ -273,6 +695,7 @@ void XaccQuantum::swap(Qubit q1, Qubit q2)
 {
     // compile swap operation into cnots
     // Dan: we should check if backend can directly implement SWAP first
+    // (Wrap this backend in a VirtualSwap to relabel qubits instead.)
     this->cnot(q1, q2);
     this->cnot(q2, q1);
     this->cnot(q1, q2);
@@ -287,52 +710,361 @@ void XaccQuantum::t_adj(Qubit q)
 }
 void XaccQuantum::x(Qubit q)
 {
-    this->add_instruction("X", q);
+    tape_.x(q);
 }
 void XaccQuantum::y(Qubit q)
 {
-    this->add_instruction("Y", q);
+    tape_.y(q);
 }
 void XaccQuantum::z(Qubit q)
 {
-    this->add_instruction("Z", q);
+    tape_.z(q);
 }
 
 //---------------------------------------------------------------------------//
 // PRIVATE FUNCTIONS
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with a single qubit.
+ * Convert the recorded gates into an XACC circuit.
+ *
+ * Each instruction is cloned from the prototype for its gate kind and given
+ * its qubits and parameter, and the whole circuit is added at once.
+ */
+auto XaccQuantum::build_circuit() const -> SPComposite
+{
+    std::vector<std::shared_ptr<xacc::Instruction>> instructions;
+    instructions.reserve(tape_.size());
+    tape_.for_each([&](GateTape::Instruction const& inst) {
+        auto const& proto = prototypes_[static_cast<std::size_t>(inst.op)];
+        QIREE_ASSERT(proto);
+        auto instr = proto->clone();
+        if (inst.op == GateOp::mz)
+        {
+            QIREE_EXPECT(inst.args[0] < this->num_qubits());
+            instr->setBits({inst.args[0]});
+            xacc::InstructionParameter bit{static_cast<int>(inst.args[1])};
+            instr->setParameter(0, bit);
+        }
+        else
+        {
+            std::vector<std::size_t> bits(inst.args,
+                                          inst.args + num_args(inst.op));
+            for ([[maybe_unused]] auto q : bits)
+            {
+                QIREE_EXPECT(q < this->num_qubits());
+            }
+            instr->setBits(std::move(bits));
+            if (num_angles(inst.op) > 0)
+            {
+                xacc::InstructionParameter angle{inst.angles[0]};
+                instr->setParameter(0, angle);
+            }
+        }
+        instructions.push_back(std::move(instr));
+    });
+
+    auto result = provider_->createComposite("quantum_circuit");
+    result->addInstructions(instructions);
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Execute circuits on all workers and merge their counts.
+ *
+ * Each worker runs its own copy of every circuit with its share of the
+ * shots on its own thread and into its own buffer, then packs the outcomes
+ * into its own histogram shard. The shards of each circuit are merged into a
+ * single buffer holding the summed counts of all workers. Outcomes wider
+ * than a histogram key are kept as bitstrings and summed directly. The first
+ * exception thrown by a worker is rethrown once all have finished.
+ */
+auto XaccQuantum::execute_workers(std::vector<VecComposite> const& circuits,
+                                  size_type num_qubits)
+    -> std::vector<SPBuffer>
+{
+    QIREE_EXPECT(!workers_.empty());
+    QIREE_EXPECT(!circuits.empty());
+
+    size_type const num_workers = workers_.size();
+    std::vector<ShardedHistogram> counts;
+    counts.reserve(circuits.size());
+    for (std::size_t i = 0; i != circuits.size(); ++i)
+    {
+        counts.emplace_back(num_workers);
+    }
+    std::vector<size_type> widths(num_workers * circuits.size(), 0);
+    std::vector<MapCounts> wide(num_workers * circuits.size());
+    std::vector<std::exception_ptr> errors(num_workers);
+
+    std::vector<std::thread> threads;
+    threads.reserve(num_workers);
+    for (std::size_t w = 0; w != num_workers; ++w)
+    {
+        threads.emplace_back([&, w] {
+            try
+            {
+                auto& session = XaccSession::instance();
+                auto buffer = session.acquire_buffer(num_qubits);
+                std::vector<SPBuffer> results;
+                if (circuits.size() == 1)
+                {
+                    workers_[w]->execute(buffer, circuits.front()[w]);
+                    results = {buffer};
+                }
+                else
+                {
+                    std::vector<SPComposite> mine;
+                    mine.reserve(circuits.size());
+                    for (auto const& copies : circuits)
+                    {
+                        mine.push_back(copies[w]);
+                    }
+                    workers_[w]->execute(buffer, mine);
+                    results = buffer->getChildren();
+                }
+                QIREE_VALIDATE(results.size() == circuits.size(),
+                               << "accelerator returned " << results.size()
+                               << " result buffers for " << circuits.size()
+                               << " circuits");
+                for (std::size_t i = 0; i != circuits.size(); ++i)
+                {
+                    auto bits = results[i]->getMeasurementCounts();
+                    size_type const width = max_width(bits);
+                    widths[i * num_workers + w] = width;
+                    if (width <= Histogram::max_bits)
+                    {
+                        counts[i].shard(w) = this->pack_counts(bits);
+                    }
+                    else
+                    {
+                        wide[i * num_workers + w] = std::move(bits);
+                    }
+                }
+                results.clear();
+                session.release_buffer(std::move(buffer));
+            }
+            catch (...)
+            {
+                errors[w] = std::current_exception();
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+    for (auto const& e : errors)
+    {
+        if (e)
+        {
+            std::rethrow_exception(e);
+        }
+    }
+
+    // Merge the shards of each circuit
+    std::vector<SPBuffer> merged(circuits.size());
+    for (std::size_t i = 0; i != circuits.size(); ++i)
+    {
+        auto const width_begin = widths.begin() + i * num_workers;
+        size_type const width
+            = *std::max_element(width_begin, width_begin + num_workers);
+        merged[i] = XaccSession::instance().acquire_buffer(num_qubits);
+        if (width <= Histogram::max_bits)
+        {
+            merged[i]->setMeasurements(
+                this->unpack_counts(std::move(counts[i]).merge(), width));
+            continue;
+        }
+
+        // Too wide to pack: add up the bitstrings of every worker
+        MapCounts total;
+        for (size_type w = 0; w != num_workers; ++w)
+        {
+            size_type const j = i * num_workers + w;
+            if (widths[j] <= Histogram::max_bits)
+            {
+                wide[j] = this->unpack_counts(counts[i].shard(w), widths[j]);
+            }
+            for (auto const& [bits, count] : wide[j])
+            {
+                total[bits] += count;
+            }
+        }
+        merged[i]->setMeasurements(std::move(total));
+    }
+    return merged;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Pack measured bitstrings into a histogram.
+ *
+ * Bit \em q of each key is the outcome of qubit \em q (character
+ * \c size-1-q for little-endian bit order, matching \c getMarginalCounts
+ * with \c BitOrder::LSB). The bitstrings must fit in a key.
  */
-template<class... Ts>
-void XaccQuantum::add_instruction(std::string s, Qubit q, Ts... args)
+Histogram XaccQuantum::pack_counts(MapCounts const& counts) const
 {
-    return this->add_instruction(std::move(s), {q}, std::forward<Ts>(args)...);
+    Histogram result(counts.size());
+    for (auto const& [bits, count] : counts)
+    {
+        QIREE_EXPECT(bits.size() <= Histogram::max_bits);
+        Histogram::key_type key = 0;
+        for (std::size_t i = 0; i != bits.size(); ++i)
+        {
+            std::size_t const pos = (endian_ == Endianness::little
+                                         ? bits.size() - 1 - i
+                                         : i);
+            if (bits[pos] == '1')
+            {
+                key |= Histogram::key_type(1) << i;
+            }
+        }
+        result.add(key, static_cast<size_type>(count));
+    }
+    return result;
 }
 
 //---------------------------------------------------------------------------//
 /*!
- * Add an instruction with multiple qubits.
+ * Convert packed outcomes back to XACC bitstrings.
  */
-template<class... Ts>
-void XaccQuantum::add_instruction(std::string s,
-                                  std::initializer_list<Qubit> qs,
-                                  Ts... args)
-{
-    // Transform opaque qubit types into raw integer indices
-    std::vector<std::size_t> q_indices(qs.size());
-    std::transform(qs.begin(), qs.end(), q_indices.begin(), [this](Qubit q) {
-        QIREE_EXPECT(q.value < this->num_qubits());
-        return q.value;
+auto XaccQuantum::unpack_counts(Histogram const& counts, size_type width) const
+    -> MapCounts
+{
+    MapCounts result;
+    counts.for_each([&](Histogram::key_type key, size_type count) {
+        std::string bits(width, '0');
+        for (size_type i = 0; i != width; ++i)
+        {
+            if ((key >> i) & 1)
+            {
+                std::size_t const pos = (endian_ == Endianness::little
+                                             ? width - 1 - i
+                                             : i);
+                bits[pos] = '1';
+            }
+        }
+        result.emplace(std::move(bits), static_cast<int>(count));
     });
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tabulate the counts of every qubit in one pass over the results.
+ *
+ * The measured bitstrings are packed into a histogram whose marginals give
+ * the counts of all qubits at once. This replaces one full scan of the
+ * measurement counts per recorded result. Bitstrings too wide to pack are
+ * tallied directly instead.
+ *
+ * If per-shot output is enabled, each outcome is also appended \em count
+ * times to the packed shot records, which are passed to the result sink.
+ */
+void XaccQuantum::tally_marginals(xacc::AcceleratorBuffer& buffer,
+                                  size_type num_qubits)
+{
+    auto const bits = buffer.getMeasurementCounts();
+    size_type const width = max_width(bits);
+    if (width > Histogram::max_bits)
+    {
+        return this->tally_wide(bits, width, num_qubits);
+    }
+
+    Histogram const counts = this->pack_counts(bits);
+    marginals_ = counts.marginals(std::max(width, num_qubits));
+
+    if (!per_shot_)
+        return;
+
+    // Expand the histogram into contiguous bit-packed shots
+    size_type const total = counts.total();
+    shot_words_.assign(num_shot_words(total, width), 0);
+    size_type pos = 0;
+    for (auto [key, count] : counts.sorted())
+    {
+        for (size_type s = 0; s != count; ++s)
+        {
+            for (size_type b = 0; b != width; ++b, ++pos)
+            {
+                if ((key >> b) & 1)
+                {
+                    shot_words_[pos / 64] |= std::uint64_t(1) << (pos % 64);
+                }
+            }
+        }
+    }
+    sink_->shots(total, width, shot_words_.data());
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Tabulate outcomes too wide to pack, one bit at a time.
+ *
+ * This is still a single pass over the distinct outcomes, but it visits
+ * every bit of each. Per-shot records are written in the order of the
+ * bitstrings rather than of their packed keys.
+ */
+void XaccQuantum::tally_wide(MapCounts const& counts,
+                             size_type width,
+                             size_type num_qubits)
+{
+    marginals_.assign(std::max(width, num_qubits), {0, 0});
+    size_type total = 0;
+    for (auto const& [bits, count] : counts)
+    {
+        for (std::size_t i = 0; i != bits.size(); ++i)
+        {
+            std::size_t const pos = (endian_ == Endianness::little
+                                         ? bits.size() - 1 - i
+                                         : i);
+            if (bits[pos] == '1')
+            {
+                marginals_[i][1] += count;
+            }
+        }
+        total += count;
+    }
+    for (auto& m : marginals_)
+    {
+        m[0] = total - m[1];
+    }
+
+    if (!per_shot_)
+        return;
 
-    // Create the instruction
-    using VecInstr = std::vector<xacc::InstructionParameter>;
-    auto instr = provider_->createInstruction(
-        std::move(s), q_indices, VecInstr{std::forward<Ts>(args)...});
+    shot_words_.assign(num_shot_words(total, width), 0);
+    size_type pos = 0;
+    for (auto const& [bits, count] : counts)
+    {
+        for (int s = 0; s != count; ++s)
+        {
+            for (size_type b = 0; b != width; ++b, ++pos)
+            {
+                std::size_t const i = (endian_ == Endianness::little
+                                           ? bits.size() - 1 - b
+                                           : b);
+                if (b < bits.size() && bits[i] == '1')
+                {
+                    shot_words_[pos / 64] |= std::uint64_t(1) << (pos % 64);
+                }
+            }
+        }
+    }
+    sink_->shots(total, width, shot_words_.data());
+}
 
-    // Add to current quantum circuit
-    cur_circuit_->addInstruction(std::move(instr));
+//---------------------------------------------------------------------------//
+/*!
+ * Write the tabulated counts of a measured qubit under its label.
+ */
+void XaccQuantum::write_counts(Qubit q, Qubit label, OptionalCString tag)
+{
+    QIREE_EXPECT(q.value < marginals_.size());
+    auto const& counts = marginals_[q.value];
+    sink_->record(label, tag, counts[0], counts[1]);
 }
 
 //---------------------------------------------------------------------------//
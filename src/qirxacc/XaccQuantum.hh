@@ -7,22 +7,33 @@
 //---------------------------------------------------------------------------//
 #pragma once
 
-#include <initializer_list>
+#include <array>
+#include <cstdint>
+#include <map>
 #include <memory>
 #include <ostream>
+#include <string>
 #include <vector>
 
+#include "qiree/CircuitCache.hh"
+#include "qiree/GateTape.hh"
+#include "qiree/Histogram.hh"
 #include "qiree/Macros.hh"
 #include "qiree/QuantumNotImpl.hh"
+#include "qiree/ResultPool.hh"
+#include "qiree/ResultSink.hh"
 #include "qiree/RuntimeInterface.hh"
 #include "qiree/Types.hh"
 
+#include "XaccSession.hh"
+
 namespace xacc
 {
 class AcceleratorBuffer;
 class Accelerator;
 class IRProvider;
 class CompositeInstruction;
+class Instruction;
 }  // namespace xacc
 
 namespace qiree
@@ -30,13 +41,81 @@ namespace qiree
 //---------------------------------------------------------------------------//
 /*!
  * Translate instructions from QIR to XACC and execute them on read.
+ *
+ * Gates are recorded on a compact \c GateTape while the program runs, so
+ * building a circuit costs no heap allocation per gate. When the results are
+ * needed, the tape is converted to an XACC circuit in a single pass by
+ * cloning a cached prototype instruction for each gate kind, rather than
+ * creating each instruction by name through the IR provider.
+ *
+ * Built circuits are cached by their gate sequence, so executing the same
+ * program again only repeats the accelerator execution. The same composite
+ * object is passed to the accelerator each time, so any compilation that the
+ * accelerator stores on it is reused as well. Each accelerator instance gets
+ * its own copy of the circuit so that concurrent workers never share one.
+ *
+ * In batch mode (\c Options::batch_size greater than one), executions are
+ * queued instead of run immediately: each \c array_record_output adds the
+ * circuit to the queue and each \c result_record_output remembers what to
+ * print. When the queue is full, or when \c flush is called, all queued
+ * circuits are submitted in a single call to the accelerator, and each child
+ * buffer is printed with its own execution's result records. Executions still
+ * queued when the instance is destroyed are flushed then, so callers must
+ * call \c flush first if the output stream does not outlive the instance.
+ *
+ * Result counts are written through a \c ResultSink in the format given by
+ * \c Options::output_format . The raw XACC buffer is only printed for the
+ * text format, and each shot's measured bits are passed to the sink if
+ * \c Options::per_shot is set (XACC returns a histogram, so shots with the
+ * same outcome are adjacent).
+ *
+ * With \c Options::num_workers greater than one, the shots are split across
+ * that many independent accelerator instances, each with its own seed, which
+ * run the same circuit on separate threads. Their counts are merged into a
+ * single buffer before any output is written, so the split is invisible to
+ * \c result_record_output . The accelerator must create a new instance each
+ * time it is requested.
+ *
+ * XACC initialization, accelerators, the IR provider, and result buffers are
+ * obtained from the process-wide \c XaccSession and returned to it on
+ * destruction, so later instances with the same accelerator reuse them
+ * rather than reinitializing the framework.
  */
 class XaccQuantum final : virtual public QuantumNotImpl,
                           virtual public RuntimeInterface
 {
   public:
-    // Call XACC initialize explicitly with args
-    static void xacc_init(std::vector<std::string> args);
+    //!@{
+    //! \name Type aliases
+    using SPBuffer = std::shared_ptr<xacc::AcceleratorBuffer>;
+    using SPComposite = std::shared_ptr<xacc::CompositeInstruction>;
+    using VecComposite = std::vector<SPComposite>;
+    using MapCounts = std::map<std::string, int>;
+    using CacheOptions = CircuitCache<VecComposite>::Options;
+    using CacheCounters = CircuitCache<VecComposite>::Counters;
+    //!@}
+
+    //! Construction options
+    struct Options
+    {
+        size_type shots{1};  //!< Number of shots per execution
+        CacheOptions cache;  //!< Circuit cache size and eviction policy
+        size_type batch_size{1};  //!< Executions per accelerator call
+        ResultFormat output_format{ResultFormat::text};  //!< Result output
+        bool per_shot{false};  //!< Write bit-packed records of every shot
+        size_type num_workers{1};  //!< Accelerator instances sharing shots
+        std::uint64_t seed{0};  //!< Seed from which worker seeds are derived
+    };
+
+  public:
+    // Call XACC initialize explicitly with args and the plugins needed
+    static void xacc_init(std::vector<std::string> args,
+                          XaccSession::Plugins plugins = {});
+
+    // Construct with accelerator name and options
+    XaccQuantum(std::ostream& os,
+                std::string const& accel_name,
+                Options const& opts);
 
     // Construct with accelerator name and number of shots
     XaccQuantum(std::ostream& os,
@@ -46,15 +125,27 @@ class XaccQuantum final : virtual public QuantumNotImpl,
     // Construct with simulator
     explicit XaccQuantum(std::ostream& os);
 
-    // Call finalize when xacc is destroyed.
+    // Return accelerators and buffers to the session
     ~XaccQuantum();
 
     QIREE_DELETE_COPY_MOVE(XaccQuantum);
 
+    // Execute all queued circuits and print their results
+    void flush();
+
+    // Write the results of later executions to a different stream
+    void set_output(std::ostream& os);
+
     //!@{
     //! \name Accessors
-    size_type num_results() const { return result_to_qubit_.size(); }
+    size_type num_results() const { return results_.size(); }
     size_type num_qubits() const { return num_qubits_; }
+    CacheCounters const& cache_counters() const { return cache_.counters(); }
+    size_type num_queued() const { return jobs_.size(); }
+    size_type num_workers() const
+    {
+        return workers_.empty() ? 1 : workers_.size();
+    }
     //!@}
 
     //!@{
@@ -65,6 +156,18 @@ class XaccQuantum final : virtual public QuantumNotImpl,
     // Complete an execution
     void tear_down() override;
 
+    // Make more qubits available during an execution
+    void reserve_qubits(size_type num_qubits) override;
+
+    // Label a result with the program's qubit
+    void label_result(Result, Qubit) final;
+
+    // Map a qubit to a new result
+    Result m(Qubit) final;
+
+    // Map a qubit to a new result and reset it
+    Result mresetz(Qubit) final;
+
     // Map a qubit to a result index
     void mz(Qubit, Result) final;
 
@@ -85,6 +188,18 @@ class XaccQuantum final : virtual public QuantumNotImpl,
 
     // No one uses tuples??
     void tuple_record_output(size_type, OptionalCString) final;
+
+    // Get a constant result that reads as |0>
+    Result result_get_zero() final { return ResultPool::zero(); }
+
+    // Get a constant result that reads as |1>
+    Result result_get_one() final { return ResultPool::one(); }
+
+    // Compare two constant results
+    bool result_equal(Result, Result) final;
+
+    // Change the reference count of a result returned by m or mresetz
+    void result_update_reference_count(Result, std::int32_t delta) final;
     //!@}
 
     //!@{
@@ -119,28 +234,88 @@ class XaccQuantum final : virtual public QuantumNotImpl,
         big
     };
 
+    //! Output to print once a queued execution completes
+    struct QueuedRecord
+    {
+        Qubit qubit;
+        Qubit label;
+        std::string tag;
+    };
+
+    //! Execution waiting to be submitted in a batch
+    struct QueuedJob
+    {
+        VecComposite circuits;
+        EntryPointAttrs attrs;
+        std::vector<QueuedRecord> records;
+    };
+
     //// DATA ////
 
+    EntryPointAttrs attrs_;
     size_type num_qubits_{};
+    ResultPool results_;
     std::vector<Qubit> result_to_qubit_;
+    std::vector<Qubit> result_to_label_;
     Endianness endian_;
+    size_type batch_size_;
+    bool per_shot_;
+    bool print_buffer_;
+
+    // Measured [zero, one] counts for each qubit of the last execution
+    Histogram::VecMarginal marginals_;
 
-    std::ostream& output_;
-    std::shared_ptr<xacc::AcceleratorBuffer> buffer_;
+    // Bit-packed outcomes of every shot of the last execution
+    std::vector<std::uint64_t> shot_words_;
+
+    ResultFormat output_format_;
+    std::ostream* output_;
+    std::unique_ptr<ResultSink> sink_;
+    bool sink_open_{false};
+
+    // Whether the current execution's circuit was already run or queued
+    bool executed_{false};
+
+    SPBuffer buffer_;
+    std::string accel_name_;
     std::shared_ptr<xacc::Accelerator> accelerator_;
+    std::vector<std::shared_ptr<xacc::Accelerator>> workers_;
     std::shared_ptr<xacc::IRProvider> provider_;
-    std::shared_ptr<xacc::CompositeInstruction> cur_circuit_;
+    VecComposite cur_circuits_;  // One copy per accelerator instance
+
+    GateTape tape_;
+    CircuitCache<VecComposite> cache_;
+    std::vector<QueuedJob> jobs_;
+    std::array<std::shared_ptr<xacc::Instruction>,
+               static_cast<std::size_t>(GateOp::size_)>
+        prototypes_;
 
     //// HELPER FUNCTIONS ////
 
-    // Add an instruction with a single qubit
-    template<class... Ts>
-    void add_instruction(std::string s, Qubit q, Ts... args);
+    // Convert the recorded gates into an XACC circuit
+    SPComposite build_circuit() const;
+
+    // Execute circuits on all workers and merge their counts
+    std::vector<SPBuffer> execute_workers(
+        std::vector<VecComposite> const& circuits, size_type num_qubits);
+
+    // Pack measured bitstrings into a histogram
+    Histogram pack_counts(MapCounts const& counts) const;
+
+    // Convert packed outcomes back to XACC bitstrings
+    MapCounts unpack_counts(Histogram const& counts, size_type width) const;
+
+    // Tabulate the counts of every qubit in one pass over the results
+    void tally_marginals(xacc::AcceleratorBuffer& buffer,
+                         size_type num_qubits);
+
+    // Tabulate outcomes too wide to pack, one bit at a time
+    void tally_wide(MapCounts const& counts,
+                    size_type width,
+                    size_type num_qubits);
 
-    // Add an instruction with multiple qubits
-    template<class... Ts>
-    void
-    add_instruction(std::string s, std::initializer_list<Qubit> qs, Ts... args);
+    // Write the tabulated counts of a measured qubit under its label
+    void write_counts(Qubit q, Qubit label, OptionalCString tag);
 };
 
 //---------------------------------------------------------------------------//
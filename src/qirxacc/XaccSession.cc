@@ -0,0 +1,361 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirxacc/XaccSession.cc
+//---------------------------------------------------------------------------//
+#include "XaccSession.hh"
+
+#include <algorithm>
+#include <sstream>
+#include <utility>
+#include <xacc/xacc.hpp>
+
+#include "qiree/Assert.hh"
+
+namespace qiree
+{
+namespace
+{
+//---------------------------------------------------------------------------//
+//! Whether a plugin is allowed by a list of needed names
+bool is_enabled(std::vector<std::string> const& names, std::string const& name)
+{
+    return names.empty()
+           || std::find(names.begin(), names.end(), name) != names.end();
+}
+
+//---------------------------------------------------------------------------//
+//! Join plugin names for an error message
+std::string join(std::vector<std::string> const& names)
+{
+    std::ostringstream os;
+    for (auto const& name : names)
+    {
+        os << (&name == names.data() ? "" : ", ") << name;
+    }
+    return os.str();
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace
+
+//---------------------------------------------------------------------------//
+/*!
+ * Access the process-wide session.
+ *
+ * The session is created on first use, after XACC's own static data, so it
+ * is destroyed (and finalizes XACC) before that data at exit.
+ */
+XaccSession& XaccSession::instance()
+{
+    static XaccSession session;
+    return session;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Finalize XACC if this session initialized it.
+ *
+ * A background initialization is allowed to complete, and pooled objects
+ * are released first so that none outlive the framework.
+ */
+XaccSession::~XaccSession()
+{
+    if (started_.valid())
+    {
+        started_.wait();
+    }
+    idle_buffers_.clear();
+    lent_buffers_.clear();
+    providers_.clear();
+    idle_accelerators_.clear();
+    if (owns_xacc_ && xacc::isInitialized())
+    {
+        xacc::Finalize();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize XACC with command-line arguments and needed plugins.
+ *
+ * This must be called before any other use of XACC, since the arguments
+ * would otherwise be ignored.
+ */
+void XaccSession::initialize(VecString args, Plugins plugins)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    QIREE_VALIDATE(!started_.valid() && !xacc::isInitialized(),
+                   << "cannot apply XACC arguments: XACC is already "
+                      "initialized");
+    plugins_ = std::move(plugins);
+    this->initialize_impl(&args);
+    this->create_plugins();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize XACC with default arguments if needed.
+ */
+void XaccSession::initialize()
+{
+    this->wait();
+    std::lock_guard<std::mutex> lock{mutex_};
+    this->initialize_impl(nullptr);
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize XACC on a background thread.
+ *
+ * The call returns immediately. Errors during initialization are rethrown by
+ * the next call that needs XACC.
+ */
+void XaccSession::start(VecString args, Plugins plugins)
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    QIREE_VALIDATE(!started_.valid() && !xacc::isInitialized(),
+                   << "cannot apply XACC arguments: XACC is already "
+                      "initialized");
+    plugins_ = std::move(plugins);
+    auto init = [this, args = std::move(args)] {
+        std::lock_guard<std::mutex> lock{mutex_};
+        this->initialize_impl(&args);
+        this->create_plugins();
+    };
+    started_ = std::async(std::launch::async, std::move(init)).share();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Wait for a background initialization to complete.
+ *
+ * This rethrows any error raised while initializing. It returns immediately
+ * if \c start was never called.
+ */
+void XaccSession::wait() const
+{
+    std::shared_future<void> started;
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        started = started_;
+    }
+    if (started.valid())
+    {
+        started.get();
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check out an accelerator, creating it if none is idle.
+ *
+ * The accelerator belongs to the caller until it is released; a new one is
+ * created for every concurrent user. (Some accelerators return a shared
+ * instance from XACC regardless, which callers needing independent
+ * instances must check.)
+ */
+auto XaccSession::acquire_accelerator(std::string const& name)
+    -> SPAccelerator
+{
+    this->wait();
+    std::lock_guard<std::mutex> lock{mutex_};
+    this->initialize_impl(nullptr);
+    QIREE_VALIDATE(is_enabled(plugins_.accelerators, name),
+                   << "accelerator '" << name
+                   << "' was not enabled (enabled: "
+                   << join(plugins_.accelerators) << ")");
+
+    auto& idle = idle_accelerators_[name];
+    if (!idle.empty())
+    {
+        SPAccelerator result = std::move(idle.back());
+        idle.pop_back();
+        ++counters_.accelerators_reused;
+        return result;
+    }
+
+    SPAccelerator result = xacc::getAccelerator(name);
+    QIREE_VALIDATE(result, << "failed to create accelerator '" << name << "'");
+    ++counters_.accelerators_created;
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Return an accelerator for reuse.
+ */
+void XaccSession::release_accelerator(std::string const& name,
+                                      SPAccelerator accel)
+{
+    if (!accel)
+        return;
+
+    std::lock_guard<std::mutex> lock{mutex_};
+    auto& idle = idle_accelerators_[name];
+    if (std::find(idle.begin(), idle.end(), accel) == idle.end())
+    {
+        idle.push_back(std::move(accel));
+    }
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a shared IR provider.
+ */
+auto XaccSession::ir_provider(std::string const& name) -> SPProvider
+{
+    this->wait();
+    std::lock_guard<std::mutex> lock{mutex_};
+    this->initialize_impl(nullptr);
+    QIREE_VALIDATE(is_enabled(plugins_.ir_providers, name),
+                   << "IR provider '" << name
+                   << "' was not enabled (enabled: "
+                   << join(plugins_.ir_providers) << ")");
+
+    auto& result = providers_[name];
+    if (!result)
+    {
+        result = xacc::getIRProvider(name);
+        QIREE_VALIDATE(result,
+                       << "failed to create IR provider '" << name << "'");
+    }
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Check out an empty buffer with the given number of qubits.
+ */
+auto XaccSession::acquire_buffer(size_type num_qubits) -> SPBuffer
+{
+    this->wait();
+    std::lock_guard<std::mutex> lock{mutex_};
+    this->initialize_impl(nullptr);
+
+    auto& idle = idle_buffers_[num_qubits];
+    if (!idle.empty())
+    {
+        SPBuffer result = std::move(idle.back());
+        idle.pop_back();
+        ++counters_.buffers_reused;
+        lent_buffers_.insert(result.get());
+        return result;
+    }
+
+    ++counters_.buffers_created;
+    SPBuffer result = xacc::qalloc(static_cast<int>(num_qubits));
+    lent_buffers_.insert(result.get());
+    return result;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Return a buffer for reuse.
+ *
+ * The caller must not use the buffer afterward. The measurements are
+ * cleared here. Only buffers checked out from the session are pooled, each
+ * at most once, so releasing a buffer twice or releasing one that XACC
+ * created elsewhere is harmless. (The reference count cannot tell whether a
+ * buffer is still in use, because XACC keeps its own reference to every
+ * buffer it allocates.) A buffer whose child buffers could not be cleared
+ * is dropped.
+ */
+void XaccSession::release_buffer(SPBuffer buffer)
+{
+    if (!buffer)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock{mutex_};
+        if (lent_buffers_.erase(buffer.get()) == 0)
+            return;
+    }
+
+    buffer->resetBuffer();
+    if (!buffer->getChildren().empty())
+        return;
+
+    auto const num_qubits = static_cast<size_type>(buffer->size());
+    std::lock_guard<std::mutex> lock{mutex_};
+    idle_buffers_[num_qubits].push_back(std::move(buffer));
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Number of objects created and reused.
+ */
+auto XaccSession::counters() const -> Counters
+{
+    std::lock_guard<std::mutex> lock{mutex_};
+    return counters_;
+}
+
+//---------------------------------------------------------------------------//
+// PRIVATE FUNCTIONS
+//---------------------------------------------------------------------------//
+/*!
+ * Initialize XACC while holding the lock.
+ *
+ * XACC may also have been initialized outside the session, in which case it
+ * is left for its owner to finalize.
+ */
+void XaccSession::initialize_impl(VecString const* args)
+{
+    if (!xacc::isInitialized())
+    {
+        if (args)
+        {
+            xacc::Initialize(*args);
+        }
+        else
+        {
+            xacc::Initialize();
+        }
+        owns_xacc_ = true;
+        // TODO: uninstall xacc signal handlers
+    }
+    QIREE_ASSERT(xacc::isInitialized());
+
+    // Tell XACC to throw exceptions rather than calling std::exit
+    xacc::setIsPyApi();
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Create the needed plugins while holding the lock.
+ *
+ * Each named accelerator is created once and left idle for its first user,
+ * so a misspelled name fails at startup rather than at the first execution.
+ */
+void XaccSession::create_plugins()
+{
+    for (auto const& name : plugins_.accelerators)
+    {
+        auto& idle = idle_accelerators_[name];
+        if (!idle.empty())
+            continue;
+
+        SPAccelerator accel = xacc::getAccelerator(name);
+        QIREE_VALIDATE(accel,
+                       << "failed to create accelerator '" << name << "'");
+        ++counters_.accelerators_created;
+        idle.push_back(std::move(accel));
+    }
+    for (auto const& name : plugins_.ir_providers)
+    {
+        auto& provider = providers_[name];
+        if (!provider)
+        {
+            provider = xacc::getIRProvider(name);
+            QIREE_VALIDATE(provider,
+                           << "failed to create IR provider '" << name
+                           << "'");
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
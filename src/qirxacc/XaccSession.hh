@@ -0,0 +1,154 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirxacc/XaccSession.hh
+//---------------------------------------------------------------------------//
+#pragma once
+
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "qiree/Macros.hh"
+#include "qiree/Types.hh"
+
+namespace xacc
+{
+class AcceleratorBuffer;
+class Accelerator;
+class IRProvider;
+}  // namespace xacc
+
+namespace qiree
+{
+//---------------------------------------------------------------------------//
+/*!
+ * Own the XACC framework for the lifetime of the process.
+ *
+ * XACC is initialized on first use and finalized when the program exits,
+ * rather than by each \c XaccQuantum , so creating and destroying several
+ * instances in one process pays for the plugin loading only once. The
+ * session also keeps the objects that are expensive to recreate:
+ *
+ * - Accelerators are checked out by name and returned when their user is
+ *   done with them. A returned accelerator keeps its initialization (and
+ *   any connection or compiled state) and is handed to the next user of the
+ *   same name, who must set the configuration it needs, such as the number
+ *   of shots.
+ * - IR providers are stateless and shared by all users.
+ * - Result buffers are pooled by number of qubits. A returned buffer is
+ *   cleared and reused by the next execution of the same width, instead of
+ *   allocating (and registering with XACC) a new one every time. The session
+ *   tracks which buffers it has lent out, since XACC holds a reference to
+ *   each allocated buffer.
+ *
+ * XACC loads every installed plugin library when it is initialized, which
+ * can take seconds. To keep this off the critical path, \c start begins the
+ * initialization on a background thread so the caller can parse and compile
+ * its program in the meantime; every other member function waits for it to
+ * finish. The \c Plugins passed at initialization name the accelerators and
+ * IR providers the process needs: those are created up front (on the
+ * background thread when started asynchronously), and any other is rejected
+ * rather than initialized on demand. Empty lists allow any plugin to be
+ * created when first requested.
+ *
+ * All member functions are thread safe.
+ */
+class XaccSession
+{
+  public:
+    //!@{
+    //! \name Type aliases
+    using SPAccelerator = std::shared_ptr<xacc::Accelerator>;
+    using SPBuffer = std::shared_ptr<xacc::AcceleratorBuffer>;
+    using SPProvider = std::shared_ptr<xacc::IRProvider>;
+    using VecString = std::vector<std::string>;
+    //!@}
+
+    //! Plugins needed by the process
+    struct Plugins
+    {
+        VecString accelerators;  //!< Accelerator names (empty: any)
+        VecString ir_providers;  //!< IR provider names (empty: any)
+    };
+
+    //! Number of objects created and reused over the session
+    struct Counters
+    {
+        size_type accelerators_created{0};
+        size_type accelerators_reused{0};
+        size_type buffers_created{0};
+        size_type buffers_reused{0};
+    };
+
+  public:
+    // Access the process-wide session
+    static XaccSession& instance();
+
+    // Finalize XACC if this session initialized it
+    ~XaccSession();
+
+    QIREE_DELETE_COPY_MOVE(XaccSession);
+
+    // Initialize XACC with command-line arguments and needed plugins
+    void initialize(VecString args, Plugins plugins = {});
+
+    // Initialize XACC with default arguments if needed
+    void initialize();
+
+    // Initialize XACC on a background thread
+    void start(VecString args, Plugins plugins);
+
+    // Wait for a background initialization to complete
+    void wait() const;
+
+    // Check out an accelerator, creating it if none is idle
+    SPAccelerator acquire_accelerator(std::string const& name);
+
+    // Return an accelerator for reuse
+    void release_accelerator(std::string const& name, SPAccelerator accel);
+
+    // Get a shared IR provider
+    SPProvider ir_provider(std::string const& name);
+
+    // Check out an empty buffer with the given number of qubits
+    SPBuffer acquire_buffer(size_type num_qubits);
+
+    // Return a buffer for reuse
+    void release_buffer(SPBuffer buffer);
+
+    // Number of objects created and reused
+    Counters counters() const;
+
+  private:
+    //// DATA ////
+
+    mutable std::mutex mutex_;
+    bool owns_xacc_{false};
+    Plugins plugins_;
+    std::shared_future<void> started_;
+    std::map<std::string, std::vector<SPAccelerator>> idle_accelerators_;
+    std::map<std::string, SPProvider> providers_;
+    std::map<size_type, std::vector<SPBuffer>> idle_buffers_;
+    std::set<xacc::AcceleratorBuffer const*> lent_buffers_;
+    Counters counters_;
+
+    //// HELPER FUNCTIONS ////
+
+    XaccSession() = default;
+
+    // Initialize XACC while holding the lock
+    void initialize_impl(VecString const* args);
+
+    // Create the needed plugins while holding the lock
+    void create_plugins();
+};
+
+//---------------------------------------------------------------------------//
+}  // namespace qiree
@@ -0,0 +1,100 @@
+; ModuleID = 'arrays'
+source_filename = "arrays"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+%Tuple = type opaque
+%String = type opaque
+
+define void @main() #0 {
+entry:
+  ; Store qubits 0 and 1 in an array and loop over it
+  %ctls = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 2)
+  %p0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %ctls, i64 0)
+  %q0 = bitcast i8* %p0 to %Qubit**
+  store %Qubit* null, %Qubit** %q0
+  %p1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %ctls, i64 1)
+  %q1 = bitcast i8* %p1 to %Qubit**
+  store %Qubit* inttoptr (i64 1 to %Qubit*), %Qubit** %q1
+  %n = call i64 @__quantum__rt__array_get_size_1d(%Array* %ctls)
+  br label %loop
+
+loop:                                             ; preds = %loop, %entry
+  %i = phi i64 [ 0, %entry ], [ %next, %loop ]
+  %p = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %ctls, i64 %i)
+  %qp = bitcast i8* %p to %Qubit**
+  %q = load %Qubit*, %Qubit** %qp
+  call void @__quantum__qis__h__body(%Qubit* %q)
+  %next = add i64 %i, 1
+  %done = icmp eq i64 %next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:                                             ; preds = %loop
+  ; Pass a tuple of (angle, qubit) to a controlled rotation
+  %tup = call %Tuple* @__quantum__rt__tuple_create(i64 16)
+  %args = bitcast %Tuple* %tup to { double, %Qubit* }*
+  %angle = getelementptr { double, %Qubit* }, { double, %Qubit* }* %args, i32 0, i32 0
+  store double 5.000000e-01, double* %angle
+  %target = getelementptr { double, %Qubit* }, { double, %Qubit* }* %args, i32 0, i32 1
+  store %Qubit* inttoptr (i64 2 to %Qubit*), %Qubit** %target
+  call void @__quantum__qis__rx__ctl(%Array* %ctls, %Tuple* %tup)
+  call void @__quantum__rt__tuple_update_reference_count(%Tuple* %tup, i32 -1)
+  call void @__quantum__rt__array_update_reference_count(%Array* %ctls, i32 -1)
+
+  ; Leak a string: it is released at the end of the execution
+  %str = call %String* @__quantum__rt__string_create(i8* getelementptr inbounds ([6 x i8], [6 x i8]* @hello, i32 0, i32 0))
+  %len = call i32 @__quantum__rt__string_get_length(%String* %str)
+  %ok = icmp eq i32 %len, 5
+  br i1 %ok, label %measure, label %fail
+
+fail:                                             ; preds = %exit
+  call void @__quantum__rt__fail(%String* %str)
+  unreachable
+
+measure:                                          ; preds = %exit
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 2 to %Qubit*), %Result* null)
+  call void @__quantum__rt__array_record_output(i64 1, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  ret void
+}
+
+@hello = internal constant [6 x i8] c"hello\00"
+
+declare %Array* @__quantum__rt__array_create_1d(i32, i64)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare i64 @__quantum__rt__array_get_size_1d(%Array*)
+
+declare void @__quantum__rt__array_update_reference_count(%Array*, i32)
+
+declare %Tuple* @__quantum__rt__tuple_create(i64)
+
+declare void @__quantum__rt__tuple_update_reference_count(%Tuple*, i32)
+
+declare %String* @__quantum__rt__string_create(i8*)
+
+declare i32 @__quantum__rt__string_get_length(%String*)
+
+declare void @__quantum__rt__fail(%String*)
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__rx__ctl(%Array*, %Tuple*)
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="3" "required_num_results"="1" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
@@ -0,0 +1,132 @@
+; ModuleID = 'assert'
+source_filename = "assert"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+%Tuple = type opaque
+%String = type opaque
+
+@msg = internal constant [7 x i8] c"assert\00"
+
+define void @main() #0 {
+entry:
+  ; Bell state (|00> + |11>)/sqrt(2)
+  call void @__quantum__qis__h__body(%Qubit* null)
+  call void @__quantum__qis__cnot__body(%Qubit* null, %Qubit* inttoptr (i64 1 to %Qubit*))
+  %msg = call %String* @__quantum__rt__string_create(i8* getelementptr inbounds ([7 x i8], [7 x i8]* @msg, i32 0, i32 0))
+  %zero = call %Result* @__quantum__rt__result_get_zero()
+  %one = call %Result* @__quantum__rt__result_get_one()
+  %q01 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 2)
+  %q010 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q01, i64 0)
+  %q010p = bitcast i8* %q010 to %Qubit**
+  store %Qubit* null, %Qubit** %q010p
+  %q011 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q01, i64 1)
+  %q011p = bitcast i8* %q011 to %Qubit**
+  store %Qubit* inttoptr (i64 1 to %Qubit*), %Qubit** %q011p
+  %q0 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %q00 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q0, i64 0)
+  %q00p = bitcast i8* %q00 to %Qubit**
+  store %Qubit* null, %Qubit** %q00p
+
+  ; ZZ and XX are +1, so always measure Zero
+  %zz = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 2)
+  %zz0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %zz, i64 0)
+  %zz0p = bitcast i8* %zz0 to i2*
+  store i2 -2, i2* %zz0p
+  %zz1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %zz, i64 1)
+  %zz1p = bitcast i8* %zz1 to i2*
+  store i2 -2, i2* %zz1p
+  call void @__quantum__qis__assertmeasurementprobability__body(%Array* %zz, %Array* %q01, %Result* %zero, double 1.000000e+00, %String* %msg, double 1.000000e-10)
+  %xx = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 2)
+  %xx0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %xx, i64 0)
+  %xx0p = bitcast i8* %xx0 to i2*
+  store i2 1, i2* %xx0p
+  %xx1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %xx, i64 1)
+  %xx1p = bitcast i8* %xx1 to i2*
+  store i2 1, i2* %xx1p
+  call void @__quantum__qis__assertmeasurementprobability__body(%Array* %xx, %Array* %q01, %Result* %one, double 0.000000e+00, %String* %msg, double 1.000000e-10)
+
+  ; Each qubit alone is uniformly random
+  %z = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 1)
+  %z0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %z, i64 0)
+  %z0p = bitcast i8* %z0 to i2*
+  store i2 -2, i2* %z0p
+  call void @__quantum__qis__assertmeasurementprobability__body(%Array* %z, %Array* %q0, %Result* %zero, double 5.000000e-01, %String* %msg, double 1.000000e-10)
+  %x = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 1)
+  %x0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %x, i64 0)
+  %x0p = bitcast i8* %x0 to i2*
+  store i2 1, i2* %x0p
+  call void @__quantum__qis__assertmeasurementprobability__body(%Array* %x, %Array* %q0, %Result* %one, double 5.000000e-01, %String* %msg, double 1.000000e-10)
+
+  ; YY is -1, checked through the controlled form, which ignores controls
+  %yy = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 2)
+  %yy0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %yy, i64 0)
+  %yy0p = bitcast i8* %yy0 to i2*
+  store i2 -1, i2* %yy0p
+  %yy1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %yy, i64 1)
+  %yy1p = bitcast i8* %yy1 to i2*
+  store i2 -1, i2* %yy1p
+  %q2 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %q20 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q2, i64 0)
+  %q20p = bitcast i8* %q20 to %Qubit**
+  store %Qubit* inttoptr (i64 2 to %Qubit*), %Qubit** %q20p
+  %tup = call %Tuple* @__quantum__rt__tuple_create(i64 48)
+  %args = bitcast %Tuple* %tup to { %Array*, %Array*, %Result*, double, %String*, double }*
+  %a0 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 0
+  store %Array* %yy, %Array** %a0
+  %a1 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 1
+  store %Array* %q01, %Array** %a1
+  %a2 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 2
+  store %Result* %one, %Result** %a2
+  %a3 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 3
+  store double 1.000000e+00, double* %a3
+  %a4 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 4
+  store %String* %msg, %String** %a4
+  %a5 = getelementptr { %Array*, %Array*, %Result*, double, %String*, double }, { %Array*, %Array*, %Result*, double, %String*, double }* %args, i32 0, i32 5
+  store double 1.000000e-10, double* %a5
+  call void @__quantum__qis__assertmeasurementprobability__ctl(%Array* %q2, %Tuple* %tup)
+
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 1 to %Qubit*), %Result* inttoptr (i64 1 to %Result*))
+  call void @__quantum__rt__array_record_output(i64 2, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 1 to %Result*), i8* null)
+  ret void
+}
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__cnot__body(%Qubit*, %Qubit*)
+
+declare void @__quantum__qis__assertmeasurementprobability__body(%Array*, %Array*, %Result*, double, %String*, double)
+
+declare void @__quantum__qis__assertmeasurementprobability__ctl(%Array*, %Tuple*)
+
+declare %Array* @__quantum__rt__array_create_1d(i32, i64)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare %Tuple* @__quantum__rt__tuple_create(i64)
+
+declare %String* @__quantum__rt__string_create(i8*)
+
+declare %Result* @__quantum__rt__result_get_zero()
+
+declare %Result* @__quantum__rt__result_get_one()
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="3" "required_num_results"="2" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
@@ -0,0 +1,60 @@
+; ModuleID = 'assert_fail'
+source_filename = "assert_fail"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+%Tuple = type opaque
+%String = type opaque
+
+@msg = internal constant [7 x i8] c"assert\00"
+
+define void @main() #0 {
+entry:
+  ; Qubit 0 is in |+>, not |0>
+  call void @__quantum__qis__h__body(%Qubit* null)
+  %msg = call %String* @__quantum__rt__string_create(i8* getelementptr inbounds ([7 x i8], [7 x i8]* @msg, i32 0, i32 0))
+  %zero = call %Result* @__quantum__rt__result_get_zero()
+  %q0 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %q00 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q0, i64 0)
+  %q00p = bitcast i8* %q00 to %Qubit**
+  store %Qubit* null, %Qubit** %q00p
+  %z = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 1)
+  %z0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %z, i64 0)
+  %z0p = bitcast i8* %z0 to i2*
+  store i2 -2, i2* %z0p
+  call void @__quantum__qis__assertmeasurementprobability__body(%Array* %z, %Array* %q0, %Result* %zero, double 1.000000e+00, %String* %msg, double 1.000000e-02)
+
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__rt__array_record_output(i64 1, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  ret void
+}
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__assertmeasurementprobability__body(%Array*, %Array*, %Result*, double, %String*, double)
+
+declare %Array* @__quantum__rt__array_create_1d(i32, i64)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare %String* @__quantum__rt__string_create(i8*)
+
+declare %Result* @__quantum__rt__result_get_zero()
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="1" "required_num_results"="1" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
@@ -0,0 +1,96 @@
+; ModuleID = 'controlled'
+source_filename = "controlled"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+%Tuple = type opaque
+
+define void @main() #0 {
+entry:
+  call void @__quantum__qis__x__body(%Qubit* null)
+  call void @__quantum__qis__x__body(%Qubit* inttoptr (i64 1 to %Qubit*))
+
+  ; Toffoli on qubit 2 with controls 0 and 1
+  %c01 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 2)
+  %p0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %c01, i64 0)
+  %q0 = bitcast i8* %p0 to %Qubit**
+  store %Qubit* null, %Qubit** %q0
+  %p1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %c01, i64 1)
+  %q1 = bitcast i8* %p1 to %Qubit**
+  store %Qubit* inttoptr (i64 1 to %Qubit*), %Qubit** %q1
+  call void @__quantum__qis__x__ctl(%Array* %c01, %Qubit* inttoptr (i64 2 to %Qubit*))
+
+  ; Phase kickback from a triply controlled Z flips qubit 3
+  %c012 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %p2 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %c012, i64 0)
+  %q2 = bitcast i8* %p2 to %Qubit**
+  store %Qubit* inttoptr (i64 2 to %Qubit*), %Qubit** %q2
+  %c3 = call %Array* @__quantum__rt__array_concatenate(%Array* %c01, %Array* %c012)
+  call void @__quantum__qis__h__body(%Qubit* inttoptr (i64 3 to %Qubit*))
+  call void @__quantum__qis__z__ctl(%Array* %c3, %Qubit* inttoptr (i64 3 to %Qubit*))
+  call void @__quantum__qis__h__body(%Qubit* inttoptr (i64 3 to %Qubit*))
+
+  ; Controlled Y rotation by pi takes qubit 2 back to |0>
+  %tup = call %Tuple* @__quantum__rt__tuple_create(i64 24)
+  %args = bitcast %Tuple* %tup to { i2, double, %Qubit* }*
+  %pauli = getelementptr { i2, double, %Qubit* }, { i2, double, %Qubit* }* %args, i32 0, i32 0
+  store i2 -1, i2* %pauli
+  %angle = getelementptr { i2, double, %Qubit* }, { i2, double, %Qubit* }* %args, i32 0, i32 1
+  store double 0x400921FB54442D18, double* %angle
+  %target = getelementptr { i2, double, %Qubit* }, { i2, double, %Qubit* }* %args, i32 0, i32 2
+  store %Qubit* inttoptr (i64 2 to %Qubit*), %Qubit** %target
+  call void @__quantum__qis__r__ctl(%Array* %c01, %Tuple* %tup)
+
+  ; Singly controlled X flips qubit 1
+  %c = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %pc = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %c, i64 0)
+  %qc = bitcast i8* %pc to %Qubit**
+  store %Qubit* inttoptr (i64 3 to %Qubit*), %Qubit** %qc
+  call void @__quantum__qis__x__ctl(%Array* %c, %Qubit* inttoptr (i64 1 to %Qubit*))
+
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 1 to %Qubit*), %Result* inttoptr (i64 1 to %Result*))
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 2 to %Qubit*), %Result* inttoptr (i64 2 to %Result*))
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 3 to %Qubit*), %Result* inttoptr (i64 3 to %Result*))
+  call void @__quantum__rt__array_record_output(i64 4, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 1 to %Result*), i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 2 to %Result*), i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 3 to %Result*), i8* null)
+  ret void
+}
+
+declare void @__quantum__qis__x__body(%Qubit*)
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__x__ctl(%Array*, %Qubit*)
+
+declare void @__quantum__qis__z__ctl(%Array*, %Qubit*)
+
+declare void @__quantum__qis__r__ctl(%Array*, %Tuple*)
+
+declare %Array* @__quantum__rt__array_create_1d(i32, i64)
+
+declare %Array* @__quantum__rt__array_concatenate(%Array*, %Array*)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare %Tuple* @__quantum__rt__tuple_create(i64)
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="4" "required_num_results"="4" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
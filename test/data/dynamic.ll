@@ -0,0 +1,59 @@
+; ModuleID = 'dynamic'
+source_filename = "dynamic"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+
+define void @main() #0 {
+entry:
+  %a = call %Qubit* @__quantum__rt__qubit_allocate()
+  call void @__quantum__qis__h__body(%Qubit* %a)
+  %pair = call %Array* @__quantum__rt__qubit_allocate_array(i64 2)
+  %p1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %pair, i64 1)
+  %q1p = bitcast i8* %p1 to %Qubit**
+  %q1 = load %Qubit*, %Qubit** %q1p
+  call void @__quantum__qis__cnot__body(%Qubit* %a, %Qubit* %q1)
+  call void @__quantum__qis__mz__body(%Qubit* %q1, %Result* null)
+  call void @__quantum__rt__qubit_release_array(%Array* %pair)
+  ; Reuses a released qubit without growing
+  %b = call %Qubit* @__quantum__rt__qubit_allocate()
+  call void @__quantum__qis__x__body(%Qubit* %b)
+  call void @__quantum__rt__qubit_release(%Qubit* %b)
+  call void @__quantum__rt__qubit_release(%Qubit* %a)
+  call void @__quantum__rt__array_record_output(i64 1, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  ret void
+}
+
+declare %Qubit* @__quantum__rt__qubit_allocate()
+
+declare %Array* @__quantum__rt__qubit_allocate_array(i64)
+
+declare void @__quantum__rt__qubit_release(%Qubit*)
+
+declare void @__quantum__rt__qubit_release_array(%Array*)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__cnot__body(%Qubit*, %Qubit*)
+
+declare void @__quantum__qis__x__body(%Qubit*)
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="0" "required_num_results"="1" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 true}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
@@ -0,0 +1,63 @@
+; ModuleID = 'math'
+source_filename = "math"
+
+%Qubit = type opaque
+%Result = type opaque
+
+define void @main() #0 {
+entry:
+  %sin = call double @__quantum__qis__sin__body(double 5.000000e-01)
+  call void @__quantum__qis__rx__body(double %sin, %Qubit* null)
+  %atan = call double @__quantum__qis__arctan2__body(double 1.000000e+00, double 1.000000e+00)
+  call void @__quantum__qis__rx__body(double %atan, %Qubit* null)
+  %nan = call double @__quantum__qis__nan__body()
+  %isnan = call i1 @__quantum__qis__isnan__body(double %nan)
+  br i1 %isnan, label %then, label %continue
+
+then:                                             ; preds = %entry
+  call void @__quantum__qis__h__body(%Qubit* null)
+  br label %continue
+
+continue:                                         ; preds = %then, %entry
+  %n = call i64 @__quantum__qis__drawrandomint__body(i64 3, i64 3)
+  %nd = sitofp i64 %n to double
+  call void @__quantum__qis__rx__body(double %nd, %Qubit* null)
+  %d = call double @__quantum__qis__drawrandomdouble__body(double 2.000000e+00, double 2.000000e+00)
+  call void @__quantum__qis__rx__body(double %d, %Qubit* null)
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__rt__array_record_output(i64 1, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  ret void
+}
+
+declare double @__quantum__qis__sin__body(double)
+
+declare double @__quantum__qis__arctan2__body(double, double)
+
+declare double @__quantum__qis__nan__body()
+
+declare i1 @__quantum__qis__isnan__body(double)
+
+declare i64 @__quantum__qis__drawrandomint__body(i64, i64)
+
+declare double @__quantum__qis__drawrandomdouble__body(double, double)
+
+declare void @__quantum__qis__rx__body(double, %Qubit*)
+
+declare void @__quantum__qis__h__body(%Qubit*)
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="1" "required_num_results"="1" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
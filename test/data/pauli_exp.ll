@@ -0,0 +1,104 @@
+; ModuleID = 'pauli_exp'
+source_filename = "pauli_exp"
+
+%Qubit = type opaque
+%Result = type opaque
+%Array = type opaque
+%Tuple = type opaque
+
+define void @main() #0 {
+entry:
+  ; exp(i pi/2 X) = iX flips qubit 0
+  %px = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 1)
+  %px0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %px, i64 0)
+  %px0p = bitcast i8* %px0 to i2*
+  store i2 1, i2* %px0p
+  %q0 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %q00 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q0, i64 0)
+  %q00p = bitcast i8* %q00 to %Qubit**
+  store %Qubit* null, %Qubit** %q00p
+  call void @__quantum__qis__exp__body(%Array* %px, double 0x3FF921FB54442D18, %Array* %q0)
+
+  ; Controlled on qubit 0, exp(i pi/2 YY) takes |00> to |11>
+  %pyy = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 2)
+  %py0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %pyy, i64 0)
+  %py0p = bitcast i8* %py0 to i2*
+  store i2 -1, i2* %py0p
+  %py1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %pyy, i64 1)
+  %py1p = bitcast i8* %py1 to i2*
+  store i2 -1, i2* %py1p
+  %q12 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 2)
+  %q120 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q12, i64 0)
+  %q120p = bitcast i8* %q120 to %Qubit**
+  store %Qubit* inttoptr (i64 1 to %Qubit*), %Qubit** %q120p
+  %q121 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q12, i64 1)
+  %q121p = bitcast i8* %q121 to %Qubit**
+  store %Qubit* inttoptr (i64 2 to %Qubit*), %Qubit** %q121p
+  %tup = call %Tuple* @__quantum__rt__tuple_create(i64 24)
+  %args = bitcast %Tuple* %tup to { %Array*, double, %Array* }*
+  %a0 = getelementptr { %Array*, double, %Array* }, { %Array*, double, %Array* }* %args, i32 0, i32 0
+  store %Array* %pyy, %Array** %a0
+  %a1 = getelementptr { %Array*, double, %Array* }, { %Array*, double, %Array* }* %args, i32 0, i32 1
+  store double 0x3FF921FB54442D18, double* %a1
+  %a2 = getelementptr { %Array*, double, %Array* }, { %Array*, double, %Array* }* %args, i32 0, i32 2
+  store %Array* %q12, %Array** %a2
+  call void @__quantum__qis__exp__ctl(%Array* %q0, %Tuple* %tup)
+
+  ; A ZZ rotation only changes phases
+  %pzz = call %Array* @__quantum__rt__array_create_1d(i32 1, i64 2)
+  %pz0 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %pzz, i64 0)
+  %pz0p = bitcast i8* %pz0 to i2*
+  store i2 -2, i2* %pz0p
+  %pz1 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %pzz, i64 1)
+  %pz1p = bitcast i8* %pz1 to i2*
+  store i2 -2, i2* %pz1p
+  call void @__quantum__qis__exp__adj(%Array* %pzz, double 3.000000e-01, %Array* %q12)
+
+  ; Controlled on qubit 3 (in |0>), nothing happens
+  %q3 = call %Array* @__quantum__rt__array_create_1d(i32 8, i64 1)
+  %q30 = call i8* @__quantum__rt__array_get_element_ptr_1d(%Array* %q3, i64 0)
+  %q30p = bitcast i8* %q30 to %Qubit**
+  store %Qubit* inttoptr (i64 3 to %Qubit*), %Qubit** %q30p
+  call void @__quantum__qis__exp__ctladj(%Array* %q3, %Tuple* %tup)
+
+  call void @__quantum__qis__mz__body(%Qubit* null, %Result* null)
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 1 to %Qubit*), %Result* inttoptr (i64 1 to %Result*))
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 2 to %Qubit*), %Result* inttoptr (i64 2 to %Result*))
+  call void @__quantum__qis__mz__body(%Qubit* inttoptr (i64 3 to %Qubit*), %Result* inttoptr (i64 3 to %Result*))
+  call void @__quantum__rt__array_record_output(i64 4, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* null, i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 1 to %Result*), i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 2 to %Result*), i8* null)
+  call void @__quantum__rt__result_record_output(%Result* inttoptr (i64 3 to %Result*), i8* null)
+  ret void
+}
+
+declare void @__quantum__qis__exp__body(%Array*, double, %Array*)
+
+declare void @__quantum__qis__exp__adj(%Array*, double, %Array*)
+
+declare void @__quantum__qis__exp__ctl(%Array*, %Tuple*)
+
+declare void @__quantum__qis__exp__ctladj(%Array*, %Tuple*)
+
+declare %Array* @__quantum__rt__array_create_1d(i32, i64)
+
+declare i8* @__quantum__rt__array_get_element_ptr_1d(%Array*, i64)
+
+declare %Tuple* @__quantum__rt__tuple_create(i64)
+
+declare void @__quantum__qis__mz__body(%Qubit*, %Result* writeonly) #1
+
+declare void @__quantum__rt__array_record_output(i64, i8*)
+
+declare void @__quantum__rt__result_record_output(%Result*, i8*)
+
+attributes #0 = { "entry_point" "output_labeling_schema" "qir_profiles"="adaptive_profile" "required_num_qubits"="4" "required_num_results"="4" }
+attributes #1 = { "irreversible" }
+
+!llvm.module.flags = !{!0, !1, !2, !3}
+
+!0 = !{i32 1, !"qir_major_version", i32 1}
+!1 = !{i32 7, !"qir_minor_version", i32 0}
+!2 = !{i32 1, !"dynamic_qubit_management", i1 false}
+!3 = !{i32 1, !"dynamic_result_management", i1 false}
@@ -0,0 +1,80 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Arena.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/Arena.hh"
+
+#include <cstdint>
+#include <cstring>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ArenaTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ArenaTest, reuse)
+{
+    Arena arena(Arena::Options{1024});
+    void* a = arena.allocate(24);
+    void* b = arena.allocate(32);
+    void* c = arena.allocate(100);
+    EXPECT_EQ(3, arena.num_live());
+    EXPECT_EQ(1024, arena.bytes_reserved());
+    for (void* p : {a, b, c})
+    {
+        EXPECT_EQ(0, reinterpret_cast<std::uintptr_t>(p) % 16);
+    }
+    std::memset(c, 1, 100);
+
+    // Released blocks are handed out again for the same size class
+    arena.deallocate(a, 24);
+    EXPECT_EQ(a, arena.allocate(20));
+    arena.deallocate(c, 100);
+    EXPECT_EQ(c, arena.allocate(128));
+
+    // Repeated create/release cycles do not grow the arena
+    for (int i = 0; i != 1000; ++i)
+    {
+        void* p = arena.allocate(200);
+        arena.deallocate(p, 200);
+    }
+    EXPECT_EQ(1024, arena.bytes_reserved());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ArenaTest, clear)
+{
+    Arena arena(Arena::Options{1024});
+    void* first = arena.allocate(64);
+    for (int i = 0; i != 40; ++i)
+    {
+        arena.allocate(64);
+    }
+    void* big = arena.allocate(1000);
+    std::memset(big, 0, 1000);
+    EXPECT_EQ(42, arena.num_live());
+    EXPECT_EQ(4 * 1024, arena.bytes_reserved());
+
+    // Dedicated chunks are freed and standard chunks are reused
+    arena.clear();
+    EXPECT_EQ(0, arena.num_live());
+    EXPECT_EQ(3 * 1024, arena.bytes_reserved());
+    EXPECT_EQ(first, arena.allocate(64));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
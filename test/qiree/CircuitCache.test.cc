@@ -0,0 +1,127 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/CircuitCache.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/CircuitCache.hh"
+
+#include <string>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class CircuitCacheTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    //! Record a one-gate circuit distinguished by its rotation angle
+    static GateTape make_tape(double angle)
+    {
+        GateTape tape;
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = 2;
+        tape.set_up(attrs);
+        tape.h(Qubit{0});
+        tape.rx(angle, Qubit{1});
+        tape.tear_down();
+        return tape;
+    }
+
+    using Cache = CircuitCache<std::string>;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitCacheTest, hash)
+{
+    auto a = make_tape(0.5);
+    auto b = make_tape(0.5);
+    auto c = make_tape(0.25);
+    EXPECT_EQ(a.hash(), b.hash());
+    EXPECT_TRUE(a.same_instructions(b));
+    EXPECT_NE(a.hash(), c.hash());
+    EXPECT_FALSE(a.same_instructions(c));
+
+    // Different opcodes with the same arguments
+    GateTape d;
+    d.x(Qubit{0});
+    GateTape e;
+    e.y(Qubit{0});
+    EXPECT_NE(d.hash(), e.hash());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitCacheTest, lru)
+{
+    Cache::Options opts;
+    opts.capacity = 2;
+    opts.eviction = CacheEviction::lru;
+    Cache cache{opts};
+
+    auto a = make_tape(1);
+    auto b = make_tape(2);
+    auto c = make_tape(3);
+    EXPECT_EQ(nullptr, cache.find(a));
+    cache.insert(a, "a");
+    cache.insert(b, "b");
+    ASSERT_NE(nullptr, cache.find(a));
+    EXPECT_EQ("a", *cache.find(a));
+
+    // 'b' is least recently used
+    cache.insert(c, "c");
+    EXPECT_EQ(2, cache.size());
+    EXPECT_EQ(nullptr, cache.find(b));
+    EXPECT_NE(nullptr, cache.find(a));
+    EXPECT_NE(nullptr, cache.find(c));
+
+    auto const& counters = cache.counters();
+    EXPECT_EQ(4, counters.hits);
+    EXPECT_EQ(2, counters.misses);
+    EXPECT_EQ(1, counters.evictions);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitCacheTest, fifo)
+{
+    Cache::Options opts;
+    opts.capacity = 2;
+    opts.eviction = CacheEviction::fifo;
+    Cache cache{opts};
+
+    auto a = make_tape(1);
+    auto b = make_tape(2);
+    auto c = make_tape(3);
+    cache.insert(a, "a");
+    cache.insert(b, "b");
+    EXPECT_NE(nullptr, cache.find(a));
+
+    // 'a' is oldest despite being used
+    cache.insert(c, "c");
+    EXPECT_EQ(nullptr, cache.find(a));
+    EXPECT_NE(nullptr, cache.find(b));
+    EXPECT_NE(nullptr, cache.find(c));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(CircuitCacheTest, disabled)
+{
+    Cache::Options opts;
+    opts.capacity = 0;
+    Cache cache{opts};
+
+    auto a = make_tape(1);
+    cache.insert(a, "a");
+    EXPECT_EQ(0, cache.size());
+    EXPECT_EQ(nullptr, cache.find(a));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,160 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/DaemonProtocol.test.cc
+//---------------------------------------------------------------------------//
+#include "DaemonProtocol.hh"
+
+#include <cstdint>
+#include <string>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "qiree/Assert.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace app
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class DaemonProtocolTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        ASSERT_EQ(0, ::socketpair(AF_UNIX, SOCK_STREAM, 0, fds_));
+    }
+
+    void TearDown() override
+    {
+        for (int fd : fds_)
+        {
+            if (fd >= 0)
+            {
+                ::close(fd);
+            }
+        }
+    }
+
+    //! Write raw bytes to the client end
+    void write_raw(std::string const& s)
+    {
+        ASSERT_EQ(static_cast<ssize_t>(s.size()),
+                  ::write(client(), s.data(), s.size()));
+    }
+
+    int client() const { return fds_[0]; }
+    int server() const { return fds_[1]; }
+
+    int fds_[2]{-1, -1};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(DaemonProtocolTest, frames)
+{
+    write_frame(client(), "hello");
+    write_frame(client(), "");
+    std::string frame;
+    EXPECT_TRUE(read_frame(server(), &frame));
+    EXPECT_EQ("hello", frame);
+    EXPECT_TRUE(read_frame(server(), &frame));
+    EXPECT_EQ("", frame);
+
+    // End of stream between frames
+    ::shutdown(client(), SHUT_WR);
+    EXPECT_FALSE(read_frame(server(), &frame));
+}
+
+TEST_F(DaemonProtocolTest, truncated)
+{
+    std::uint32_t size = 10;
+    write_raw(std::string(reinterpret_cast<char const*>(&size), sizeof(size))
+              + "abc");
+    ::shutdown(client(), SHUT_WR);
+    std::string frame;
+    EXPECT_THROW(read_frame(server(), &frame), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DaemonProtocolTest, request)
+{
+    DaemonRequest sent;
+    sent.backend = "mps";
+    sent.shots = 1000;
+    sent.seed = 12345678901234ull;
+    sent.output_format = ResultFormat::jsonl;
+    sent.peephole = true;
+    sent.json = true;
+    sent.module = std::string("BC\xc0\xde\0binary", 11);
+    write_request(client(), sent);
+
+    DaemonRequest received;
+    ASSERT_TRUE(read_request(server(), &received));
+    EXPECT_EQ("", received.error);
+    EXPECT_EQ("mps", received.backend);
+    EXPECT_EQ(1000, received.shots);
+    EXPECT_EQ(12345678901234ull, received.seed);
+    EXPECT_EQ(ResultFormat::jsonl, received.output_format);
+    EXPECT_TRUE(received.peephole);
+    EXPECT_FALSE(received.virtual_swap);
+    EXPECT_TRUE(received.json);
+    EXPECT_EQ(sent.module, received.module);
+
+    ::shutdown(client(), SHUT_WR);
+    EXPECT_FALSE(read_request(server(), &received));
+}
+
+TEST_F(DaemonProtocolTest, bad_options)
+{
+    // Invalid options are reported but leave the stream usable
+    write_frame(client(), "shots=abc\nbogus=1\njson=1\n");
+    write_frame(client(), "module");
+    write_frame(client(), "shots=7\n");
+    write_frame(client(), "module");
+
+    DaemonRequest received;
+    ASSERT_TRUE(read_request(server(), &received));
+    EXPECT_NE(std::string::npos, received.error.find("'shots'"))
+        << received.error;
+    EXPECT_TRUE(received.json);
+
+    ASSERT_TRUE(read_request(server(), &received));
+    EXPECT_EQ("", received.error);
+    EXPECT_EQ(7, received.shots);
+    EXPECT_FALSE(received.json);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(DaemonProtocolTest, replies)
+{
+    write_reply(server(), {true, "qubit 0: {0: 1}\n"}, false);
+    write_reply(server(), {false, "bad \"input\""}, false);
+    write_reply(server(), {true, "a\nb"}, true);
+    write_reply(server(), {false, "tab\there"}, true);
+
+    DaemonReply reply = read_reply(client());
+    EXPECT_TRUE(reply.ok);
+    EXPECT_EQ("qubit 0: {0: 1}\n", reply.output);
+    reply = read_reply(client());
+    EXPECT_FALSE(reply.ok);
+    EXPECT_EQ("bad \"input\"", reply.output);
+
+    EXPECT_EQ("{\"status\":\"ok\",\"output\":\"a\\nb\"}\n",
+              read_json_reply(client()));
+    EXPECT_EQ("{\"status\":\"error\",\"output\":\"tab\\there\"}\n",
+              read_json_reply(client()));
+
+    ::shutdown(server(), SHUT_WR);
+    EXPECT_THROW(read_reply(client()), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace app
+}  // namespace qiree
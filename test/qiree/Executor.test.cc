@@ -10,6 +10,7 @@
 #include "QuantumTestImpl.hh"
 #include "qiree/Assert.hh"
 #include "qiree/Module.hh"
+#include "qiree/PhiloxMath.hh"
 #include "qiree_test.hh"
 
 namespace qiree
@@ -69,6 +70,23 @@ tear_down
               result.commands.str());
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, arrays)
+{
+    auto result = this->run("arrays.ll");
+    EXPECT_EQ(R"(
+set_up(q=3, r=1)
+h(Q{0})
+h(Q{1})
+TODO: rx.ctl
+mz(Q{2},R{0})
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+}
+
 //---------------------------------------------------------------------------//
 TEST_F(ExecutorTest, bell)
 {
@@ -87,6 +105,58 @@ tear_down
               result.commands.str());
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, math)
+{
+    Executor execute(Module(this->test_data_path("math.ll")));
+    EXPECT_TRUE(execute.draws_random_numbers());
+
+    {
+        // Random draws require a math interface
+        TestResult tr;
+        QuantumTestImpl quantum_impl(&tr);
+        ResultTestImpl result_impl(&tr);
+        EXPECT_THROW(execute(quantum_impl, result_impl), RuntimeError);
+    }
+
+    TestResult tr;
+    QuantumTestImpl quantum_impl(&tr);
+    ResultTestImpl result_impl(&tr);
+    PhiloxMath math(12345);
+    execute(quantum_impl, result_impl, math);
+    EXPECT_EQ(R"(
+set_up(q=1, r=1)
+rx(0.479426, Q{0})
+rx(0.785398, Q{0})
+h(Q{0})
+rx(3, Q{0})
+rx(2, Q{0})
+mz(Q{0},R{0})
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              tr.commands.str());
+    EXPECT_EQ(2, math.num_calls());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, results)
+{
+    auto result = this->run("results.ll");
+    EXPECT_EQ(R"(
+set_up(q=1, r=1)
+mz(Q{0},R{0})
+result_get_one
+result_equal(R{0}, R{1})
+result_update_reference_count(R{1}, -1)
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+}
+
 //---------------------------------------------------------------------------//
 TEST_F(ExecutorTest, rotation)
 {
@@ -138,6 +208,29 @@ tear_down
     // cout << result.commands.str();
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ExecutorTest, dynamic)
+{
+    auto result = this->run("dynamic.ll");
+    EXPECT_EQ(R"(
+set_up(q=0, r=1)
+reserve_qubits(1)
+h(Q{0})
+reserve_qubits(3)
+cnot(Q{0}, Q{2})
+mz(Q{2},R{0})
+TODO: reset.body
+TODO: reset.body
+TODO: x.body
+TODO: reset.body
+TODO: reset.body
+array_record_output(1)
+result_record_output(R{0})
+tear_down
+)",
+              result.commands.str());
+}
+
 //---------------------------------------------------------------------------//
 TEST_F(ExecutorTest, loop)
 {
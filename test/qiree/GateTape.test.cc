@@ -0,0 +1,114 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/GateTape.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/GateTape.hh"
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class GateTapeTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(GateTapeTest, record_and_replay)
+{
+    Executor execute{Module{this->test_data_path("pyqir_several_gates.ll")}};
+
+    TestResult runtime_result;
+    ResultTestImpl runtime_impl(&runtime_result);
+    GateTape tape;
+    execute(tape, runtime_impl);
+
+    EXPECT_EQ(4, tape.attrs().required_num_qubits);
+    EXPECT_EQ(17, tape.size());
+    EXPECT_EQ(3, tape.angles().size());
+
+    TestResult tr;
+    QuantumTestImpl quantum_impl(&tr);
+    quantum_impl.set_up(tape.attrs());
+    tape.replay(quantum_impl);
+    quantum_impl.tear_down();
+
+    EXPECT_EQ(R"(
+set_up(q=4, r=4)
+h(Q{0})
+cnot(Q{0}, Q{1})
+TODO: cz.body
+rx(0.523599, Q{1})
+ry(1.047, Q{2})
+rz(1.571, Q{3})
+s(Q{0})
+TODO: s.adj
+TODO: t.body
+TODO: t.adj
+TODO: x.body
+TODO: y.body
+TODO: z.body
+mz(Q{0},R{0})
+mz(Q{1},R{1})
+mz(Q{2},R{2})
+mz(Q{3},R{3})
+tear_down
+)",
+              tr.commands.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(GateTapeTest, round_trip)
+{
+    using Q = Qubit;
+
+    GateTape orig;
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 3;
+    attrs.required_num_results = 1;
+    orig.set_up(attrs);
+    orig.h(Q{0});
+    orig.r(Pauli::y, 0.25, Q{2});
+    orig.r_adj(Pauli::z, 0.5, Q{1});
+    orig.rxx(1.5, Q{0}, Q{2});
+    orig.swap(Q{2}, Q{1});
+    orig.reset(Q{1});
+    orig.t_adj(Q{0});
+    orig.mz(Q{2}, Result{0});
+    orig.tear_down();
+
+    GateTape copy;
+    copy.set_up(orig.attrs());
+    orig.replay(copy);
+    EXPECT_EQ(orig.ops(), copy.ops());
+    EXPECT_EQ(orig.args(), copy.args());
+    EXPECT_EQ(orig.angles(), copy.angles());
+
+    std::vector<std::string> names;
+    orig.for_each([&names](GateTape::Instruction const& inst) {
+        names.push_back(to_cstring(inst.op));
+    });
+    std::vector<std::string> const expected_names
+        = {"h", "r", "r_adj", "rxx", "swap", "reset", "t_adj", "mz"};
+    EXPECT_EQ(expected_names, names);
+
+    // Recording again starts from an empty tape
+    copy.set_up(attrs);
+    EXPECT_TRUE(copy.empty());
+    EXPECT_TRUE(copy.angles().empty());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,127 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/Histogram.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/Histogram.hh"
+
+#include <thread>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class HistogramTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramTest, add_and_find)
+{
+    Histogram hist;
+    EXPECT_TRUE(hist.empty());
+    EXPECT_EQ(0, hist[123]);
+
+    // Enough keys to rehash several times
+    for (std::uint64_t k = 0; k != 1000; ++k)
+    {
+        hist.add(k * 0x10000, k % 3 + 1);
+    }
+    hist.add(0, 10);
+    hist.add(5, 0);
+
+    EXPECT_EQ(1000, hist.size());
+    EXPECT_EQ(11, hist[0]);
+    EXPECT_EQ(2, hist[0x10000]);
+    EXPECT_EQ(1, hist[999 * 0x10000]);
+    EXPECT_EQ(0, hist[5]);
+    EXPECT_EQ(2009, hist.total());
+
+    auto sorted = hist.sorted();
+    ASSERT_EQ(1000, sorted.size());
+    EXPECT_EQ(0, sorted.front().first);
+    EXPECT_EQ(999 * 0x10000, sorted.back().first);
+
+    hist.clear();
+    EXPECT_TRUE(hist.empty());
+    EXPECT_EQ(0, hist.total());
+    EXPECT_EQ(0, hist[0]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramTest, marginals)
+{
+    Histogram hist(4);
+    hist.add(0b00, 5);
+    hist.add(0b01, 3);
+    hist.add(0b11, 2);
+
+    auto m = hist.marginals(3);
+    ASSERT_EQ(3, m.size());
+    EXPECT_EQ(5, m[0][0]);
+    EXPECT_EQ(5, m[0][1]);
+    EXPECT_EQ(8, m[1][0]);
+    EXPECT_EQ(2, m[1][1]);
+    EXPECT_EQ(10, m[2][0]);
+    EXPECT_EQ(0, m[2][1]);
+
+    // Bits past the key width are zero
+    hist.add(Histogram::key_type(1) << 63, 1);
+    m = hist.marginals(100);
+    ASSERT_EQ(100, m.size());
+    EXPECT_EQ(5, m[0][1]);
+    EXPECT_EQ(1, m[63][1]);
+    EXPECT_EQ(11, m[99][0]);
+    EXPECT_EQ(0, m[99][1]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(HistogramTest, sharded)
+{
+    constexpr size_type num_threads = 4;
+    ShardedHistogram shards(num_threads);
+    std::vector<std::thread> threads;
+    for (size_type t = 0; t != num_threads; ++t)
+    {
+        threads.emplace_back([&shards, t] {
+            Histogram& hist = shards.shard(t);
+            for (std::uint64_t i = 0; i != 10000; ++i)
+            {
+                hist.add((i * 7 + t) % 64);
+            }
+        });
+    }
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    Histogram expected;
+    for (size_type t = 0; t != num_threads; ++t)
+    {
+        for (std::uint64_t i = 0; i != 10000; ++i)
+        {
+            expected.add((i * 7 + t) % 64);
+        }
+    }
+
+    Histogram merged = std::move(shards).merge();
+    EXPECT_EQ(40000, merged.total());
+    EXPECT_EQ(64, merged.size());
+    EXPECT_EQ(expected, merged);
+
+    expected.add(3);
+    EXPECT_NE(expected, merged);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -7,6 +7,11 @@
 //---------------------------------------------------------------------------//
 #include "qiree/Module.hh"
 
+#include <fstream>
+#include <future>
+#include <sstream>
+
+#include "qiree/Assert.hh"
 #include "qiree_test.hh"
 
 namespace qiree
@@ -109,6 +114,46 @@ TEST_F(ModuleTest, several_gates)
     EXPECT_FALSE(flags.dynamic_result_management);
 }
 
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, threaded)
+{
+    // Each module has its own context, so they can be parsed concurrently
+    auto load = [this](char const* filename) {
+        return std::async(std::launch::async,
+                          [path = this->test_data_path(filename)] {
+                              return Module{path};
+                          });
+    };
+    auto bell = load("bell.ll");
+    auto several = load("pyqir_several_gates.ll");
+
+    Module m = bell.get();
+    EXPECT_EQ(2, m.load_entry_point_attrs().required_num_qubits);
+
+    // Replacing a module releases the old one before its context
+    m = several.get();
+    EXPECT_EQ(4, m.load_entry_point_attrs().required_num_qubits);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ModuleTest, from_buffer)
+{
+    std::string contents;
+    {
+        std::ifstream infile(this->test_data_path("bell.ll"));
+        ASSERT_TRUE(infile);
+        std::ostringstream os;
+        os << infile.rdbuf();
+        contents = os.str();
+    }
+
+    Module m = Module::from_buffer(contents, "bell");
+    EXPECT_TRUE(m);
+    EXPECT_EQ(2, m.load_entry_point_attrs().required_num_qubits);
+
+    EXPECT_THROW(Module::from_buffer("not IR", "garbage"), RuntimeError);
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
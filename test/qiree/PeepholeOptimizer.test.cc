@@ -0,0 +1,180 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PeepholeOptimizer.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/PeepholeOptimizer.hh"
+
+#include <string>
+#include <vector>
+
+#include "QuantumTestImpl.hh"
+#include "qiree/Executor.hh"
+#include "qiree/GateTape.hh"
+#include "qiree/Module.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class PeepholeOptimizerTest : public ::qiree::test::Test
+{
+  protected:
+    using Q = Qubit;
+
+    void SetUp() override
+    {
+        attrs_.required_num_qubits = 3;
+        attrs_.required_num_results = 3;
+    }
+
+    //! Get the names of the recorded gates with their qubits
+    static std::vector<std::string> names(GateTape const& tape)
+    {
+        std::vector<std::string> result;
+        tape.for_each([&result](GateTape::Instruction const& inst) {
+            std::string s = to_cstring(inst.op);
+            for (int i = 0; i != num_args(inst.op); ++i)
+            {
+                s += ' ';
+                s += std::to_string(inst.args[i]);
+            }
+            result.push_back(std::move(s));
+        });
+        return result;
+    }
+
+    EntryPointAttrs attrs_;
+    GateTape tape_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(PeepholeOptimizerTest, cancel_pairs)
+{
+    PeepholeOptimizer opt(tape_);
+    opt.set_up(attrs_);
+    opt.h(Q{0});
+    opt.h(Q{0});
+    opt.s(Q{1});
+    opt.s_adj(Q{1});
+    opt.cnot(Q{0}, Q{2});
+    opt.cx(Q{0}, Q{2});
+    opt.cz(Q{1}, Q{2});
+    opt.cz(Q{2}, Q{1});
+    // Not inverses: different direction
+    opt.cnot(Q{0}, Q{1});
+    opt.cnot(Q{1}, Q{0});
+    opt.t(Q{2});
+    EXPECT_EQ(3, opt.num_pending());
+    opt.tear_down();
+
+    std::vector<std::string> const expected = {"cnot 0 1", "cnot 1 0", "t 2"};
+    EXPECT_EQ(expected, names(tape_));
+    EXPECT_EQ(11, opt.counters().gates);
+    EXPECT_EQ(8, opt.counters().removed);
+    EXPECT_EQ(4, opt.counters().cancelled);
+    EXPECT_EQ(0, opt.num_pending());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PeepholeOptimizerTest, merge_rotations)
+{
+    PeepholeOptimizer opt(tape_);
+    opt.set_up(attrs_);
+    opt.rz(0.25, Q{0});
+    opt.rz(0.5, Q{0});
+    opt.rz(1.0, Q{0});
+    opt.rx(0.5, Q{1});
+    opt.rx(-0.5, Q{1});
+    opt.r(Pauli::y, 0.5, Q{2});
+    opt.r_adj(Pauli::y, 0.25, Q{2});
+    opt.rzz(0.5, Q{0}, Q{1});
+    opt.rzz(0.5, Q{1}, Q{0});
+    opt.tear_down();
+
+    std::vector<std::string> const expected = {"rz 0", "r 3 2", "rzz 0 1"};
+    EXPECT_EQ(expected, names(tape_));
+    std::vector<double> const expected_angles = {1.75, 0.25, 1.0};
+    EXPECT_EQ(expected_angles, tape_.angles());
+    EXPECT_EQ(5, opt.counters().merged);
+    EXPECT_EQ(6, opt.counters().removed);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PeepholeOptimizerTest, commute_through_controls)
+{
+    PeepholeOptimizer opt(tape_);
+    opt.set_up(attrs_);
+    // Diagonal gates pass the control; X passes the target
+    opt.t(Q{0});
+    opt.x(Q{1});
+    opt.cnot(Q{0}, Q{1});
+    opt.t_adj(Q{0});
+    opt.x(Q{1});
+    // Z does not pass the target; H does not pass anything
+    opt.z(Q{2});
+    opt.cnot(Q{0}, Q{2});
+    opt.z(Q{2});
+    opt.h(Q{0});
+    opt.cnot(Q{0}, Q{1});
+    opt.h(Q{0});
+    opt.tear_down();
+
+    std::vector<std::string> const expected = {"cnot 0 1",
+                                               "z 2",
+                                               "cnot 0 2",
+                                               "z 2",
+                                               "h 0",
+                                               "cnot 0 1",
+                                               "h 0"};
+    EXPECT_EQ(expected, names(tape_));
+    EXPECT_EQ(4, opt.counters().removed);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PeepholeOptimizerTest, flush_at_measurement)
+{
+    PeepholeOptimizer::Options opts;
+    opts.window = 2;
+    PeepholeOptimizer opt(tape_, opts);
+    opt.set_up(attrs_);
+    opt.x(Q{0});
+    opt.mz(Q{0}, Result{0});
+    opt.x(Q{0});
+    // Bounded window: the first y is applied before the second arrives
+    opt.y(Q{1});
+    opt.h(Q{2});
+    opt.z(Q{2});
+    opt.y(Q{1});
+    opt.tear_down();
+
+    std::vector<std::string> const expected
+        = {"x 0", "mz 0 0", "x 0", "y 1", "h 2", "z 2", "y 1"};
+    EXPECT_EQ(expected, names(tape_));
+    EXPECT_EQ(0, opt.counters().removed);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PeepholeOptimizerTest, execute)
+{
+    Executor execute{Module{this->test_data_path("pyqir_several_gates.ll")}};
+
+    TestResult tr;
+    ResultTestImpl runtime(&tr);
+    PeepholeOptimizer opt(tape_);
+    execute(opt, runtime);
+
+    // No redundancy in this program
+    EXPECT_EQ(17, tape_.size());
+    EXPECT_EQ(13, opt.counters().gates);
+    EXPECT_EQ(0, opt.counters().removed);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,116 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/PhiloxMath.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/PhiloxMath.hh"
+
+#include <limits>
+#include <vector>
+
+#include "qiree/Assert.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class PhiloxMathTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(PhiloxMathTest, philox)
+{
+    // Known-answer vectors from the Random123 distribution
+    {
+        Philox4x32 philox(0);
+        auto result = philox({0, 0, 0, 0});
+        EXPECT_EQ(0x6627e8d5u, result[0]);
+        EXPECT_EQ(0xe169c58du, result[1]);
+        EXPECT_EQ(0xbc57ac4cu, result[2]);
+        EXPECT_EQ(0x9b00dbd8u, result[3]);
+    }
+    {
+        Philox4x32 philox(0xffffffffffffffffull);
+        auto result
+            = philox({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff});
+        EXPECT_EQ(0x408f276du, result[0]);
+        EXPECT_EQ(0x41c83b0eu, result[1]);
+        EXPECT_EQ(0xa20bc7c6u, result[2]);
+        EXPECT_EQ(0x6d5451fdu, result[3]);
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PhiloxMathTest, reproducible)
+{
+    auto draw_shot = [](PhiloxMath& math, size_type shot) {
+        math.start_shot(shot);
+        std::vector<double> result;
+        for (int i = 0; i != 4; ++i)
+        {
+            result.push_back(math.drawrandomdouble(0, 1));
+            result.push_back(double(math.drawrandomint(-10, 10)));
+        }
+        return result;
+    };
+
+    PhiloxMath math(20240101);
+    auto shot0 = draw_shot(math, 0);
+    auto shot1 = draw_shot(math, 1);
+    EXPECT_EQ(8, math.num_calls());
+    EXPECT_NE(shot0, shot1);
+
+    // Shots give the same values in any order and with any instance
+    PhiloxMath other(20240101);
+    EXPECT_EQ(shot1, draw_shot(other, 1));
+    EXPECT_EQ(shot0, draw_shot(other, 0));
+
+    // A different seed gives different values
+    PhiloxMath reseeded(20240102);
+    EXPECT_NE(shot0, draw_shot(reseeded, 0));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(PhiloxMathTest, ranges)
+{
+    PhiloxMath math(1);
+    int counts[3] = {0, 0, 0};
+    double sum = 0;
+    constexpr int num_draws = 30000;
+    for (int i = 0; i != num_draws; ++i)
+    {
+        auto n = math.drawrandomint(-1, 1);
+        ASSERT_TRUE(n >= -1 && n <= 1) << n;
+        ++counts[n + 1];
+
+        double x = math.drawrandomdouble(-2, 3);
+        ASSERT_TRUE(x >= -2 && x <= 3) << x;
+        sum += x;
+    }
+    for (int c : counts)
+    {
+        EXPECT_NEAR(num_draws / 3, c, 500);
+    }
+    EXPECT_NEAR(0.5, sum / num_draws, 0.05);
+
+    // Degenerate and full ranges
+    EXPECT_EQ(7, math.drawrandomint(7, 7));
+    EXPECT_EQ(2.5, math.drawrandomdouble(2.5, 2.5));
+    using limits = std::numeric_limits<std::int64_t>;
+    math.drawrandomint(limits::min(), limits::max());
+
+    EXPECT_THROW(math.drawrandomint(1, 0), RuntimeError);
+    EXPECT_THROW(math.drawrandomdouble(1, 0), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -38,6 +38,17 @@ void QuantumTestImpl::set_up(EntryPointAttrs const& attrs)
                   << ")\n";
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Make more qubits available.
+ */
+void QuantumTestImpl::reserve_qubits(size_type num_qubits)
+{
+    EXPECT_GT(num_qubits, num_qubits_);
+    num_qubits_ = num_qubits;
+    tr_->commands << "reserve_qubits(" << num_qubits << ")\n";
+}
+
 //---------------------------------------------------------------------------//
 /*!
  * Complete an execution.
@@ -321,6 +332,47 @@ void ResultTestImpl::tuple_record_output(size_type s, OptionalCString tag)
     tr_->commands << ")\n";
 }
 
+//---------------------------------------------------------------------------//
+/*!
+ * Get a constant result that reads as |0>.
+ */
+Result ResultTestImpl::result_get_zero()
+{
+    tr_->commands << "result_get_zero\n";
+    return Result{0};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Get a constant result that reads as |1>.
+ */
+Result ResultTestImpl::result_get_one()
+{
+    tr_->commands << "result_get_one\n";
+    return Result{1};
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Compare two results by identity.
+ */
+bool ResultTestImpl::result_equal(Result a, Result b)
+{
+    tr_->commands << "result_equal(" << a << ", " << b << ")\n";
+    return a.value == b.value;
+}
+
+//---------------------------------------------------------------------------//
+/*!
+ * Change the reference count of a result.
+ */
+void ResultTestImpl::result_update_reference_count(Result r,
+                                                   std::int32_t delta)
+{
+    tr_->commands << "result_update_reference_count(" << r << ", " << delta
+                  << ")\n";
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
@@ -38,6 +38,9 @@ class QuantumTestImpl final : public QuantumInterface
     //! Complete an execution
     void tear_down() final;
 
+    //! Make more qubits available
+    void reserve_qubits(size_type num_qubits) final;
+
     //// Measurements ////
 
     // Measure the qubit and store in the result.
@@ -131,6 +134,14 @@ class ResultTestImpl final : public RuntimeInterface
     // No one uses tuples??
     void tuple_record_output(size_type, OptionalCString tag) final;
 
+    //!@{
+    //! \name Results
+    Result result_get_zero() final;
+    Result result_get_one() final;
+    bool result_equal(Result, Result) final;
+    void result_update_reference_count(Result, std::int32_t delta) final;
+    //!@}
+
   private:
     TestResult* tr_;
 };
@@ -0,0 +1,59 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/QubitAllocator.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/QubitAllocator.hh"
+
+#include "qiree/Assert.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class QubitAllocatorTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(QubitAllocatorTest, reuse)
+{
+    QubitAllocator alloc;
+    alloc.reset(2);
+    EXPECT_EQ(2, alloc.high_water());
+
+    Qubit a = alloc.allocate();
+    Qubit b = alloc.allocate();
+    EXPECT_EQ(2, a.value);
+    EXPECT_EQ(3, b.value);
+    EXPECT_EQ(4, alloc.high_water());
+
+    // Released indices are reused before the high-water mark grows
+    alloc.release(a);
+    EXPECT_EQ(1, alloc.num_live());
+    EXPECT_EQ(2, alloc.allocate().value);
+    EXPECT_EQ(4, alloc.allocate().value);
+    EXPECT_EQ(5, alloc.high_water());
+    EXPECT_EQ(3, alloc.num_live());
+
+    // Static and unallocated qubits cannot be released
+    EXPECT_THROW(alloc.release(Qubit{0}), RuntimeError);
+    EXPECT_THROW(alloc.release(Qubit{5}), RuntimeError);
+    alloc.release(b);
+    EXPECT_THROW(alloc.release(b), RuntimeError);
+
+    alloc.reset(0);
+    EXPECT_EQ(0, alloc.high_water());
+    EXPECT_EQ(0, alloc.allocate().value);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,84 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultPool.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ResultPool.hh"
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ResultPoolTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultPoolTest, outcomes)
+{
+    ResultPool pool;
+    pool.reset(100);
+    EXPECT_EQ(100, pool.size());
+    for (size_type i = 0; i < 100; i += 3)
+    {
+        pool.set(Result{i}, QState::one);
+    }
+    pool.set(Result{99}, QState::one);
+    pool.set(Result{99}, QState::zero);
+    EXPECT_EQ(QState::one, pool[Result{0}]);
+    EXPECT_EQ(QState::zero, pool[Result{1}]);
+    EXPECT_EQ(QState::one, pool[Result{66}]);
+    EXPECT_EQ(QState::zero, pool[Result{99}]);
+
+    // Constants
+    EXPECT_EQ(QState::zero, pool[ResultPool::zero()]);
+    EXPECT_EQ(QState::one, pool[ResultPool::one()]);
+    EXPECT_TRUE(pool.equal(Result{3}, ResultPool::one()));
+    EXPECT_FALSE(pool.equal(Result{4}, ResultPool::one()));
+
+    // Outcomes are cleared on reset
+    pool.reset(100);
+    EXPECT_EQ(QState::zero, pool[Result{0}]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultPoolTest, recycle)
+{
+    ResultPool pool;
+    pool.reset(2);
+    Result a = pool.allocate();
+    Result b = pool.allocate();
+    EXPECT_EQ(2, a.value);
+    EXPECT_EQ(3, b.value);
+    EXPECT_EQ(4, pool.size());
+    pool.set(a, QState::one);
+
+    // Released results are reused and start in |0>
+    pool.update_reference_count(a, 1);
+    pool.update_reference_count(a, -2);
+    EXPECT_EQ(1, pool.num_live());
+    Result c = pool.allocate();
+    EXPECT_EQ(a.value, c.value);
+    EXPECT_EQ(QState::zero, pool[c]);
+    EXPECT_EQ(4, pool.size());
+
+    // Static and constant results are not counted
+    pool.update_reference_count(Result{0}, -1);
+    pool.update_reference_count(ResultPool::one(), -1);
+    EXPECT_EQ(QState::one, pool[ResultPool::one()]);
+
+    pool.update_reference_count(b, -1);
+    EXPECT_THROW(pool.update_reference_count(b, -1), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,141 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/ResultSink.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/ResultSink.hh"
+
+#include <sstream>
+
+#include "qiree/Assert.hh"
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class ResultSinkTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        labeled_.required_num_qubits = 2;
+        labeled_.required_num_results = 2;
+        labeled_.output_labeling_schema = "labeled";
+        labeled_.qir_profiles = "base_profile";
+
+        unlabeled_ = labeled_;
+        unlabeled_.output_labeling_schema.clear();
+    }
+
+    EntryPointAttrs labeled_;
+    EntryPointAttrs unlabeled_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultSinkTest, format_names)
+{
+    EXPECT_EQ(ResultFormat::text, to_result_format("text"));
+    EXPECT_EQ(ResultFormat::jsonl, to_result_format("jsonl"));
+    EXPECT_EQ(ResultFormat::binary, to_result_format("binary"));
+    EXPECT_THROW(to_result_format("xml"), RuntimeError);
+    EXPECT_STREQ("jsonl", to_cstring(ResultFormat::jsonl));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultSinkTest, text)
+{
+    std::ostringstream os;
+    auto sink = ResultSink::from_format(ResultFormat::text, os);
+    sink->begin(unlabeled_);
+    sink->record(Qubit{0}, nullptr, 3, 7);
+    sink->record(Qubit{1}, "r1", 10, 0);
+    // Nothing is written until the execution ends
+    EXPECT_EQ("", os.str());
+    sink->end();
+
+    EXPECT_EQ(R"(qubit 0 experiment <null>: {0: 3, 1: 7}
+qubit 1 experiment r1: {0: 10, 1: 0}
+)",
+              os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultSinkTest, jsonl)
+{
+    std::ostringstream os;
+    JsonResultSink sink(os);
+
+    sink.begin(labeled_);
+    sink.record(Qubit{0}, "r\"0", 3, 7);
+    std::uint64_t const words[] = {0xb4};
+    sink.shots(4, 2, words);
+    sink.end();
+
+    sink.begin(unlabeled_);
+    sink.record(Qubit{1}, "r1", 10, 0);
+    sink.error("oh no");
+    sink.end();
+
+    EXPECT_EQ(
+        R"({"type":"begin","schema":"labeled","profiles":"base_profile"}
+{"type":"result","qubit":0,"tag":"r\"0","counts":[3,7]}
+{"type":"shots","num_shots":4,"num_bits":2,"words":["b4"]}
+{"type":"end"}
+{"type":"begin","schema":"","profiles":"base_profile"}
+{"type":"result","qubit":1,"counts":[10,0]}
+{"type":"error","message":"oh no"}
+{"type":"end"}
+)",
+        os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(ResultSinkTest, binary)
+{
+    std::ostringstream os;
+    BinaryResultSink sink(os);
+
+    sink.begin(labeled_);
+    sink.record(Qubit{1}, "ab", 2, 0x0102);
+    std::uint64_t const words[] = {0xffu};
+    sink.shots(8, 1, words);
+    sink.end();
+
+    sink.begin(unlabeled_);
+    sink.record(Qubit{0}, "ab", 0, 0);
+    sink.end();
+
+    std::string const expected = std::string("QIRR\x01\0\0\0", 8)
+                                 // Begin
+                                 + std::string("B\x07\0\0\0", 5) + "labeled"
+                                 + std::string("\x0c\0\0\0", 4)
+                                 + "base_profile"
+                                 // Record
+                                 + std::string("R\x01\0\0\0\0\0\0\0", 9)
+                                 + std::string("\x02\0\0\0\0\0\0\0", 8)
+                                 + std::string("\x02\x01\0\0\0\0\0\0", 8)
+                                 + std::string("\x02\0\0\0", 4) + "ab"
+                                 // Shots
+                                 + std::string("S\x08\0\0\0\0\0\0\0", 9)
+                                 + std::string("\x01\0\0\0", 4)
+                                 + std::string("\xff\0\0\0\0\0\0\0", 8)
+                                 + "E"
+                                 // Second execution: no header or tag
+                                 + std::string("B\0\0\0\0", 5)
+                                 + std::string("\x0c\0\0\0", 4)
+                                 + "base_profile"
+                                 + std::string("R\0\0\0\0\0\0\0\0", 9)
+                                 + std::string(16, '\0')
+                                 + std::string("\0\0\0\0", 4) + "E";
+    EXPECT_EQ(expected, os.str());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,106 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/RuntimeObjects.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/RuntimeObjects.hh"
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class RuntimeObjectsTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    RuntimeObjects objects_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(RuntimeObjectsTest, arrays)
+{
+    Array a = objects_.array_create(sizeof(Qubit), 3);
+    ASSERT_NE(0, a.value);
+    EXPECT_EQ(3, RuntimeObjects::array_size(a));
+    EXPECT_EQ(8, RuntimeObjects::array_elem_size(a));
+    for (size_type i = 0; i != 3; ++i)
+    {
+        EXPECT_EQ(0, RuntimeObjects::array_get<Qubit>(a, i).value);
+        *static_cast<std::uintptr_t*>(RuntimeObjects::array_element(a, i))
+            = 10 + i;
+    }
+    EXPECT_EQ(12, RuntimeObjects::array_get<Qubit>(a, 2).value);
+    EXPECT_THROW(RuntimeObjects::array_element(a, 3), RuntimeError);
+
+    // Unaliased copies share the array; forced copies do not
+    EXPECT_EQ(a.value, objects_.array_copy(a, false).value);
+    Array b = objects_.array_copy(a, true);
+    EXPECT_NE(a.value, b.value);
+    EXPECT_EQ(11, RuntimeObjects::array_get<Qubit>(b, 1).value);
+    RuntimeObjects::update_alias_count(a, 1);
+    Array c = objects_.array_copy(a, false);
+    EXPECT_NE(a.value, c.value);
+    RuntimeObjects::update_alias_count(a, -1);
+
+    Array d = objects_.array_concatenate(a, b);
+    EXPECT_EQ(6, RuntimeObjects::array_size(d));
+    EXPECT_EQ(10, RuntimeObjects::array_get<Qubit>(d, 3).value);
+    EXPECT_EQ(4, objects_.num_live());
+
+    // Release all references
+    objects_.update_reference_count(a, -2);
+    for (Array arr : {b, c, d})
+    {
+        objects_.update_reference_count(arr, -1);
+    }
+    EXPECT_EQ(0, objects_.num_live());
+    objects_.update_reference_count(Array{}, -1);
+
+    Array e = objects_.array_create(4, 2);
+    EXPECT_THROW(objects_.update_reference_count(e, -2), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(RuntimeObjectsTest, tuples)
+{
+    Tuple t = objects_.tuple_create(2 * sizeof(double));
+    auto* values = reinterpret_cast<double*>(t.value);
+    EXPECT_EQ(0.0, values[1]);
+    values[0] = 1.5;
+    values[1] = 2.5;
+
+    Tuple u = objects_.tuple_copy(t, true);
+    EXPECT_EQ(2.5, reinterpret_cast<double*>(u.value)[1]);
+    EXPECT_EQ(t.value, objects_.tuple_copy(t, false).value);
+
+    objects_.update_reference_count(t, -2);
+    objects_.update_reference_count(u, -1);
+    EXPECT_EQ(0, objects_.num_live());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(RuntimeObjectsTest, strings)
+{
+    String hello = objects_.string_create("hello ");
+    String world = objects_.string_create("world");
+    String both = objects_.string_concatenate(hello, world);
+    EXPECT_EQ("hello world", RuntimeObjects::string_view(both));
+    EXPECT_EQ('\0', RuntimeObjects::string_view(both).data()[11]);
+    EXPECT_EQ("", RuntimeObjects::string_view(objects_.string_create("")));
+
+    // Leaked objects are released together
+    EXPECT_EQ(4, objects_.num_live());
+    objects_.clear();
+    EXPECT_EQ(0, objects_.num_live());
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,114 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qiree/VirtualSwap.test.cc
+//---------------------------------------------------------------------------//
+#include "qiree/VirtualSwap.hh"
+
+#include <string>
+#include <vector>
+
+#include "qiree/GateTape.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class VirtualSwapTest : public ::qiree::test::Test
+{
+  protected:
+    using Q = Qubit;
+
+    void SetUp() override
+    {
+        attrs_.required_num_qubits = 3;
+        attrs_.required_num_results = 2;
+    }
+
+    //! Get the names of the recorded gates with their arguments
+    std::vector<std::string> names() const
+    {
+        std::vector<std::string> result;
+        tape_.for_each([&result](GateTape::Instruction const& inst) {
+            std::string s = to_cstring(inst.op);
+            for (int i = 0; i != num_args(inst.op); ++i)
+            {
+                s += ' ';
+                s += std::to_string(inst.args[i]);
+            }
+            result.push_back(std::move(s));
+        });
+        return result;
+    }
+
+    EntryPointAttrs attrs_;
+    GateTape tape_;
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(VirtualSwapTest, relabel)
+{
+    VirtualSwap vswap(tape_);
+    vswap.set_up(attrs_);
+    vswap.h(Q{0});
+    vswap.swap(Q{0}, Q{2});
+    vswap.cnot(Q{2}, Q{1});
+    vswap.swap(Q{1}, Q{2});
+    vswap.rx(0.5, Q{1});
+    vswap.r(Pauli::z, 0.25, Q{2});
+    EXPECT_EQ(2, vswap.physical(Q{0}).value);
+    EXPECT_EQ(0, vswap.physical(Q{1}).value);
+    EXPECT_EQ(1, vswap.physical(Q{2}).value);
+    vswap.mz(Q{1}, Result{0});
+    vswap.mz(Q{2}, Result{1});
+    vswap.tear_down();
+
+    std::vector<std::string> const expected = {"h 0",
+                                               "cnot 0 1",
+                                               "rx 0",
+                                               "r 2 1",
+                                               "mz 0 0",
+                                               "mz 1 1"};
+    EXPECT_EQ(expected, names());
+    EXPECT_EQ(2, vswap.counters().relabeled);
+    EXPECT_EQ(0, vswap.counters().applied);
+
+    // A new execution starts from the identity
+    vswap.set_up(attrs_);
+    vswap.x(Q{2});
+    EXPECT_EQ(2, vswap.physical(Q{2}).value);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(VirtualSwapTest, restore)
+{
+    VirtualSwap vswap(tape_);
+    vswap.set_up(attrs_);
+    // Cycle 0 -> 1 -> 2 -> 0
+    vswap.swap(Q{0}, Q{1});
+    vswap.swap(Q{1}, Q{2});
+    EXPECT_EQ(1, vswap.physical(Q{0}).value);
+    EXPECT_EQ(2, vswap.physical(Q{1}).value);
+    EXPECT_EQ(0, vswap.physical(Q{2}).value);
+
+    vswap.restore();
+    for (size_type i = 0; i != 3; ++i)
+    {
+        EXPECT_EQ(i, vswap.physical(Q{i}).value);
+    }
+    vswap.tear_down();
+
+    // Two real swaps take the state back to the program's layout
+    std::vector<std::string> const expected = {"swap 0 1", "swap 1 2"};
+    EXPECT_EQ(expected, names());
+    EXPECT_EQ(2, vswap.counters().applied);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,165 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/GateFuser.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/GateFuser.hh"
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+using value_type = StateVector::value_type;
+using VecValue = std::vector<value_type>;
+
+class GateFuserTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    //! Random single-qubit unitary Rz(a) Ry(b) Rz(c)
+    VecValue random_single()
+    {
+        std::uniform_real_distribution<double> angle(0, 6.28);
+        double a = angle(rng_), b = angle(rng_), c = angle(rng_);
+        value_type const ea = std::polar(1.0, a / 2);
+        value_type const ec = std::polar(1.0, c / 2);
+        double const cb = std::cos(b / 2), sb = std::sin(b / 2);
+        return {std::conj(ea * ec) * cb,
+                -std::conj(ea) * ec * sb,
+                ea * std::conj(ec) * sb,
+                ea * ec * cb};
+    }
+
+    //! Permutation matrix that XORs the high bit with the AND of the others
+    static VecValue toffoli(size_type num_qubits)
+    {
+        size_type const dim = size_type(1) << num_qubits;
+        size_type const ctrl = (dim >> 1) - 1;
+        VecValue result(dim * dim);
+        for (size_type c = 0; c != dim; ++c)
+        {
+            size_type r = (c & ctrl) == ctrl ? c ^ (dim >> 1) : c;
+            result[r * dim + c] = 1;
+        }
+        return result;
+    }
+
+    //! Prepare a nontrivial initial state
+    static void randomize(StateVector* state)
+    {
+        std::mt19937 rng(12345u);
+        std::normal_distribution<double> sample;
+        double norm = 0;
+        for (auto& a : state->amplitudes())
+        {
+            a = {sample(rng), sample(rng)};
+            norm += std::norm(a);
+        }
+        for (auto& a : state->amplitudes())
+        {
+            a /= std::sqrt(norm);
+        }
+    }
+
+    std::mt19937 rng_{20240501u};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFuserTest, matches_unfused)
+{
+    constexpr size_type num_qubits = 6;
+    StateVector expected(num_qubits);
+    StateVector actual(num_qubits);
+    randomize(&expected);
+    randomize(&actual);
+
+    GateFuser fuse(&actual);
+    std::uniform_int_distribution<size_type> sample_qubit(0, num_qubits - 1);
+    std::uniform_int_distribution<int> sample_kind(0, 9);
+    for (int i = 0; i < 200; ++i)
+    {
+        size_type q[4];
+        q[0] = sample_qubit(rng_);
+        do
+        {
+            q[1] = sample_qubit(rng_);
+        } while (q[1] == q[0]);
+        do
+        {
+            q[2] = sample_qubit(rng_);
+        } while (q[2] == q[0] || q[2] == q[1]);
+        do
+        {
+            q[3] = sample_qubit(rng_);
+        } while (q[3] == q[0] || q[3] == q[1] || q[3] == q[2]);
+
+        int kind = sample_kind(rng_);
+        size_type n = kind < 6 ? 1 : kind < 8 ? 2 : kind < 9 ? 3 : 4;
+        VecValue m = (n == 1 ? random_single() : toffoli(n));
+        expected.apply(q, n, m.data());
+        fuse.apply(q, n, m.data());
+
+        if (i % 50 == 0)
+        {
+            // Partial flush as done for a measurement
+            fuse.flush(q[0]);
+        }
+    }
+    fuse.flush();
+    EXPECT_EQ(0, fuse.num_pending());
+
+    for (size_type i = 0; i != expected.size(); ++i)
+    {
+        EXPECT_NEAR(expected.amplitudes()[i].real(),
+                    actual.amplitudes()[i].real(),
+                    1e-12);
+        EXPECT_NEAR(expected.amplitudes()[i].imag(),
+                    actual.amplitudes()[i].imag(),
+                    1e-12);
+    }
+
+    auto const& counters = fuse.counters();
+    EXPECT_EQ(200, counters.gates);
+    EXPECT_LT(counters.sweeps, counters.gates / 2);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(GateFuserTest, single_qubit_runs)
+{
+    StateVector state(3);
+    GateFuser fuse(&state);
+    for (int i = 0; i < 10; ++i)
+    {
+        for (size_type q = 0; q != 3; ++q)
+        {
+            auto m = this->random_single();
+            fuse.apply({q}, m.data());
+        }
+    }
+    // Each qubit has its own pending block, but they share a single sweep
+    EXPECT_EQ(3, fuse.num_pending());
+    fuse.flush();
+    EXPECT_EQ(30, fuse.counters().gates);
+    EXPECT_EQ(1, fuse.counters().sweeps);
+
+    double norm = 0;
+    for (auto const& a : state.amplitudes())
+    {
+        norm += std::norm(a);
+    }
+    EXPECT_NEAR(1.0, norm, 1e-12);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
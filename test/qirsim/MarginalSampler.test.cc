@@ -0,0 +1,74 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MarginalSampler.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/MarginalSampler.hh"
+
+#include <cmath>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class MarginalSamplerTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override
+    {
+        // Three-qubit state: |000> (p=0.5), |011> (p=0.25), |101> (p=0.25)
+        auto& amps = state_.amplitudes();
+        amps[0b000] = std::sqrt(0.5);
+        amps[0b011] = {0, 0.5};
+        amps[0b101] = -0.5;
+    }
+
+    StateVector state_{3};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(MarginalSamplerTest, dense)
+{
+    // Measure qubits 2 and 1 (key bit 0 is qubit 2)
+    MarginalSampler::Options opts;
+    opts.num_threads = 4;
+    opts.chunk_size = 1000;
+    MarginalSampler sample(state_, {2, 1}, opts);
+    EXPECT_TRUE(sample.dense());
+
+    auto counts = sample(100000, 12345);
+    EXPECT_EQ(3, counts.size());
+    EXPECT_NEAR(0.5, counts[0b00] / 1e5, 0.01);
+    EXPECT_NEAR(0.25, counts[0b10] / 1e5, 0.01);
+    EXPECT_NEAR(0.25, counts[0b01] / 1e5, 0.01);
+
+    // Results are independent of the number of threads
+    opts.num_threads = 1;
+    MarginalSampler serial(state_, {2, 1}, opts);
+    EXPECT_EQ(counts, serial(100000, 12345));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MarginalSamplerTest, prefix_sum)
+{
+    MarginalSampler::Options opts;
+    opts.max_dense_qubits = 0;
+    opts.num_threads = 3;
+    MarginalSampler sample(state_, {0}, opts);
+    EXPECT_FALSE(sample.dense());
+
+    auto counts = sample(50000, 1);
+    EXPECT_EQ(2, counts.size());
+    EXPECT_NEAR(0.5, counts[1] / 5e4, 0.01);
+    EXPECT_EQ(50000, counts[0] + counts[1]);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
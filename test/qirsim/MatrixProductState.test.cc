@@ -0,0 +1,196 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MatrixProductState.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/MatrixProductState.hh"
+
+#include <numeric>
+#include <random>
+
+#include "qiree/Assert.hh"
+#include "qirsim/StateVector.hh"
+#include "qirsim/detail/GateMatrices.hh"
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+class MatrixProductStateTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    static MatrixProductState::Options exact()
+    {
+        MatrixProductState::Options opts;
+        opts.truncation_threshold = 0;
+        return opts;
+    }
+
+    std::mt19937 rng_{20240501u};
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(MatrixProductStateTest, matches_state_vector)
+{
+    constexpr size_type num_qubits = 7;
+    StateVector expected(num_qubits);
+    MatrixProductState actual(num_qubits, exact());
+
+    std::uniform_int_distribution<size_type> sample_qubit(0, num_qubits - 1);
+    std::uniform_real_distribution<double> sample_angle(0, 6.28);
+    std::uniform_int_distribution<int> sample_kind(0, 5);
+    for (int i = 0; i < 120; ++i)
+    {
+        size_type q1 = sample_qubit(rng_);
+        size_type q2;
+        do
+        {
+            q2 = sample_qubit(rng_);
+        } while (q2 == q1);
+        double angle = sample_angle(rng_);
+
+        switch (sample_kind(rng_))
+        {
+            case 0: {
+                auto m = detail::rx_gate(angle);
+                expected.apply({q1}, m.data());
+                actual.apply(m.data(), q1);
+                break;
+            }
+            case 1: {
+                auto m = detail::ry_gate(angle);
+                expected.apply({q1}, m.data());
+                actual.apply(m.data(), q1);
+                break;
+            }
+            case 2:
+                expected.apply({q1}, detail::t_gate.data());
+                actual.apply(detail::t_gate.data(), q1);
+                break;
+            case 3:
+                expected.apply({q1, q2}, detail::cx_gate.data());
+                actual.apply(detail::cx_gate.data(), q1, q2);
+                break;
+            case 4: {
+                auto m = detail::rxx_gate(angle);
+                expected.apply({q1, q2}, m.data());
+                actual.apply(m.data(), q1, q2);
+                break;
+            }
+            case 5: {
+                auto m = detail::ryy_gate(angle);
+                expected.apply({q1, q2}, m.data());
+                actual.apply(m.data(), q1, q2);
+                break;
+            }
+        }
+    }
+    EXPECT_LT(actual.truncation_error(), 1e-12);
+
+    for (size_type q = 0; q != num_qubits; ++q)
+    {
+        EXPECT_NEAR(
+            expected.probability_one(q), actual.probability_one(q), 1e-10)
+            << "qubit " << q;
+    }
+
+    // Collapse and compare conditional probabilities
+    QState outcome = expected.probability_one(3) > 0.5 ? QState::one
+                                                       : QState::zero;
+    expected.collapse(3, outcome);
+    actual.collapse(3, outcome);
+    for (size_type q = 0; q != num_qubits; ++q)
+    {
+        EXPECT_NEAR(
+            expected.probability_one(q), actual.probability_one(q), 1e-10)
+            << "qubit " << q;
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MatrixProductStateTest, routing)
+{
+    MatrixProductState mps(6);
+    mps.apply(detail::x_gate.data(), 0);
+    mps.apply(detail::cx_gate.data(), 0, 5);
+    EXPECT_DOUBLE_EQ(1, mps.probability_one(0));
+    EXPECT_DOUBLE_EQ(1, mps.probability_one(5));
+    for (size_type q : {1, 2, 3})
+    {
+        EXPECT_DOUBLE_EQ(0, mps.probability_one(q));
+    }
+    // Control was routed next to the target and left there
+    EXPECT_EQ(4, mps.site(0));
+    EXPECT_EQ(5, mps.site(5));
+    EXPECT_EQ(0, mps.site(1));
+
+    mps.reset();
+    EXPECT_EQ(0, mps.site(0));
+    EXPECT_DOUBLE_EQ(0, mps.probability_one(5));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MatrixProductStateTest, ghz)
+{
+    constexpr size_type num_qubits = 80;
+    MatrixProductState mps(num_qubits);
+    mps.apply(detail::h_gate.data(), 0);
+    for (size_type q = 0; q + 1 != num_qubits; ++q)
+    {
+        mps.apply(detail::cx_gate.data(), q, q + 1);
+    }
+    EXPECT_EQ(2, mps.max_bond_dimension());
+    EXPECT_LT(mps.truncation_error(), 1e-12);
+    EXPECT_NEAR(0.5, mps.probability_one(40), 1e-12);
+
+    auto counts = mps.sample({0, 40, 79}, 1000, 12345);
+    EXPECT_EQ(2, counts.size());
+    EXPECT_EQ(1000, counts[0b000] + counts[0b111]);
+    EXPECT_LT(400, counts[0b000]);
+    EXPECT_LT(400, counts[0b111]);
+
+    // All qubits can be sampled together as marginals, but not as keys
+    MatrixProductState::VecQubit all(num_qubits);
+    std::iota(all.begin(), all.end(), size_type{0});
+    EXPECT_THROW(mps.sample(all, 10, 12345), RuntimeError);
+    auto marginals = mps.sample_marginals(all, 1000, 12345);
+    ASSERT_EQ(num_qubits, marginals.size());
+    EXPECT_EQ(1000, marginals[0][0] + marginals[0][1]);
+    for (auto const& m : marginals)
+    {
+        EXPECT_EQ(marginals[0], m);
+    }
+    // Same shots as the joint sample
+    auto marginals3 = mps.sample_marginals({0, 40, 79}, 1000, 12345);
+    EXPECT_EQ(counts[0b111], marginals3[0][1]);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MatrixProductStateTest, truncation)
+{
+    MatrixProductState::Options opts;
+    opts.max_bond = 1;
+    MatrixProductState mps(2, opts);
+    mps.apply(detail::h_gate.data(), 0);
+    mps.apply(detail::cx_gate.data(), 0, 1);
+
+    // Half the Bell state's weight is discarded
+    EXPECT_NEAR(0.5, mps.truncation_error(), 1e-12);
+    EXPECT_EQ(1, mps.max_bond_dimension());
+
+    // The remaining product state is normalized and correlated
+    double p0 = mps.probability_one(0);
+    EXPECT_NEAR(p0, mps.probability_one(1), 1e-12);
+    EXPECT_TRUE(p0 < 1e-12 || p0 > 1 - 1e-12) << p0;
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,194 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/MpsQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/MpsQuantum.hh"
+
+#include <regex>
+#include <sstream>
+
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/Types.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class MpsQuantumTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    std::string run(std::string const& filename, size_type shots)
+    {
+        Executor execute{Module{this->test_data_path(filename)}};
+        std::ostringstream os;
+        MpsQuantum sim(os, shots, 12345);
+        while (sim.remaining_shots() > 0)
+        {
+            execute(sim, sim);
+        }
+        num_executions_ = sim.num_executions();
+        return os.str();
+    }
+
+    size_type num_executions_{0};
+
+    static EntryPointAttrs make_attrs(size_type qubits, size_type results)
+    {
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = qubits;
+        attrs.required_num_results = results;
+        return attrs;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, deterministic)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    MpsQuantum sim{os};
+    sim.set_up(make_attrs(4, 2));
+    // |0000> -> |1001> with a long-range gate
+    sim.h(Q{0});
+    sim.rz(pi, Q{0});
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{3});
+    sim.mz(Q{0}, R{0});
+    sim.mz(Q{3}, R{1});
+    EXPECT_EQ(QState::one, sim.read_result(R{0}));
+    EXPECT_EQ(QState::one, sim.read_result(R{1}));
+    sim.result_record_output(R{1}, "a");
+    sim.tear_down();
+
+    EXPECT_EQ(0, sim.remaining_shots());
+    EXPECT_LT(sim.truncation_error(), 1e-12);
+    EXPECT_EQ(1, sim.max_bond_dimension());
+    EXPECT_EQ("qubit 3 experiment a: {0: 0, 1: 1}\n", os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, reused_deferred_results)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    MpsQuantum sim{os, 10, 12345};
+    sim.set_up(make_attrs(4, 1));
+    sim.x(Q{1});
+    sim.x(Q{2});
+
+    // A released result is recycled while its measurement is deferred
+    R a = sim.m(Q{0});
+    sim.result_update_reference_count(a, -1);
+    R b = sim.m(Q{1});
+    EXPECT_EQ(a.value, b.value);
+
+    // A static result is measured again
+    sim.mz(Q{3}, R{0});
+    sim.mz(Q{2}, R{0});
+
+    sim.array_record_output(2, nullptr);
+    sim.result_record_output(b, nullptr);
+    sim.result_record_output(R{0}, nullptr);
+    sim.tear_down();
+    EXPECT_EQ(
+        "qubit 1 experiment <null>: {0: 0, 1: 10}\n"
+        "qubit 2 experiment <null>: {0: 0, 1: 10}\n",
+        os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, wide_ghz)
+{
+    // More measured qubits than fit in a histogram key
+    constexpr size_type num_qubits = 80;
+    std::ostringstream os;
+    MpsQuantum sim(os, 200, 12345);
+    sim.set_up(make_attrs(num_qubits, num_qubits));
+    sim.h(Qubit{0});
+    for (size_type q = 0; q + 1 != num_qubits; ++q)
+    {
+        sim.cnot(Qubit{q}, Qubit{q + 1});
+    }
+    for (size_type q = 0; q != num_qubits; ++q)
+    {
+        sim.mz(Qubit{q}, Result{q});
+    }
+    for (size_type q = 0; q != num_qubits; ++q)
+    {
+        sim.result_record_output(Result{q}, nullptr);
+    }
+    sim.tear_down();
+    EXPECT_EQ(0, sim.remaining_shots());
+    EXPECT_EQ(1, sim.num_executions());
+
+    // Every qubit has the same counts as the first
+    std::istringstream is(os.str());
+    std::string first;
+    std::getline(is, first);
+    std::smatch m;
+    ASSERT_TRUE(std::regex_match(
+        first, m, std::regex(R"(qubit 0 experiment <null>: (.*))")))
+        << first;
+    std::string const counts = m[1];
+    EXPECT_NE("{0: 200, 1: 0}", counts);
+    EXPECT_NE("{0: 0, 1: 200}", counts);
+    std::string line;
+    size_type num_lines = 1;
+    for (; std::getline(is, line); ++num_lines)
+    {
+        EXPECT_EQ("qubit " + std::to_string(num_lines)
+                      + " experiment <null>: " + counts,
+                  line);
+    }
+    EXPECT_EQ(num_qubits, num_lines);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, bell)
+{
+    auto result = this->run("bell.ll", 200);
+    std::smatch m;
+    std::regex const re(R"(qubit 0 experiment <null>: \{0: (\d+), 1: (\d+)\}
+qubit 1 experiment <null>: \{0: (\d+), 1: (\d+)\}
+)");
+    ASSERT_TRUE(std::regex_match(result, m, re)) << result;
+    // Outcomes are perfectly correlated
+    EXPECT_EQ(m[1], m[3]);
+    EXPECT_EQ(m[2], m[4]);
+    EXPECT_EQ(200, std::stoi(m[1]) + std::stoi(m[2]));
+    EXPECT_LT(50, std::stoi(m[1]));
+    EXPECT_LT(50, std::stoi(m[2]));
+
+    // All shots are drawn from a single final state
+    EXPECT_EQ(1, num_executions_);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(MpsQuantumTest, teleport)
+{
+    // Teleported state is |0>
+    auto result = this->run("teleport.ll", 100);
+    EXPECT_NE(std::string::npos,
+              result.find("qubit 2 experiment <null>: {0: 100, 1: 0}"))
+        << result;
+    // Feedback requires one execution per shot
+    EXPECT_EQ(100, num_executions_);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -0,0 +1,372 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/SimQuantum.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/SimQuantum.hh"
+
+#include <optional>
+#include <regex>
+#include <sstream>
+
+#include "qiree/Executor.hh"
+#include "qiree/Module.hh"
+#include "qiree/RuntimeObjects.hh"
+#include "qiree/Types.hh"
+#include "qiree/VirtualSwap.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+constexpr double pi = 3.141592653589793;
+
+class SimQuantumTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    std::string run(std::string const& filename,
+                    size_type shots,
+                    bool branch_shots = true,
+                    bool virtual_swap = false)
+    {
+        Executor execute{Module{this->test_data_path(filename)}};
+        std::ostringstream os;
+        SimQuantum::Options opts;
+        opts.shots = shots;
+        opts.seed = 12345;
+        opts.branch_shots = branch_shots;
+        SimQuantum sim(os, opts);
+        QuantumInterface* quantum = &sim;
+        std::optional<VirtualSwap> vswap;
+        if (virtual_swap)
+        {
+            vswap.emplace(sim);
+            quantum = &*vswap;
+        }
+        while (sim.remaining_shots() > 0)
+        {
+            execute(*quantum, sim);
+        }
+        num_executions_ = sim.num_executions();
+        return os.str();
+    }
+
+    size_type num_executions_{0};
+
+    static EntryPointAttrs make_attrs(size_type qubits, size_type results)
+    {
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = qubits;
+        attrs.required_num_results = results;
+        return attrs;
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, deterministic)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    SimQuantum sim{os};
+    sim.set_up(make_attrs(3, 3));
+    // |000> -> |110> through a mix of fused gates
+    sim.h(Q{0});
+    sim.rz(pi, Q{0});
+    sim.h(Q{0});
+    sim.cnot(Q{0}, Q{1});
+    sim.s(Q{2});
+    sim.s_adj(Q{2});
+    sim.mz(Q{0}, R{0});
+    sim.mz(Q{1}, R{1});
+    sim.mz(Q{2}, R{2});
+    EXPECT_EQ(QState::one, sim.read_result(R{0}));
+    EXPECT_EQ(QState::one, sim.read_result(R{1}));
+    EXPECT_EQ(QState::zero, sim.read_result(R{2}));
+    sim.array_record_output(3, nullptr);
+    sim.result_record_output(R{0}, "a");
+    sim.result_record_output(R{2}, "b");
+    EXPECT_EQ(6, sim.fusion_counters().gates);
+    EXPECT_EQ(2, sim.fusion_counters().sweeps);
+    sim.tear_down();
+
+    EXPECT_EQ(0, sim.remaining_shots());
+    EXPECT_EQ(R"(qubit 0 experiment a: {0: 0, 1: 1}
+qubit 2 experiment b: {0: 1, 1: 0}
+)",
+              os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, dynamic_results)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    SimQuantum sim{os};
+    sim.set_up(make_attrs(2, 1));
+    sim.x(Q{0});
+    R a = sim.m(Q{0});
+    EXPECT_EQ(1, a.value);
+    EXPECT_TRUE(sim.result_equal(a, sim.result_get_one()));
+    EXPECT_FALSE(sim.result_equal(a, sim.result_get_zero()));
+
+    R b = sim.mresetz(Q{0});
+    EXPECT_EQ(2, b.value);
+    EXPECT_EQ(QState::one, sim.read_result(b));
+
+    // Released results are recycled
+    sim.result_update_reference_count(a, -1);
+    R c = sim.m(Q{0});
+    EXPECT_EQ(a.value, c.value);
+    EXPECT_EQ(QState::zero, sim.read_result(c));
+    EXPECT_FALSE(sim.result_equal(b, c));
+
+    sim.mz(Q{1}, R{0});
+    sim.array_record_output(1, nullptr);
+    sim.result_record_output(b, nullptr);
+    sim.tear_down();
+    EXPECT_EQ("qubit 0 experiment <null>: {0: 0, 1: 1}\n", os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, reused_deferred_results)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    SimQuantum::Options opts;
+    opts.shots = 10;
+    SimQuantum sim{os, opts};
+    sim.set_up(make_attrs(4, 1));
+    sim.x(Q{1});
+    sim.x(Q{2});
+
+    // A released result is recycled while its measurement is deferred
+    R a = sim.m(Q{0});
+    sim.result_update_reference_count(a, -1);
+    R b = sim.m(Q{1});
+    EXPECT_EQ(a.value, b.value);
+
+    // A static result is measured again
+    sim.mz(Q{3}, R{0});
+    sim.mz(Q{2}, R{0});
+
+    sim.array_record_output(2, nullptr);
+    sim.result_record_output(b, nullptr);
+    sim.result_record_output(R{0}, nullptr);
+    sim.tear_down();
+    EXPECT_EQ(
+        "qubit 1 experiment <null>: {0: 0, 1: 10}\n"
+        "qubit 2 experiment <null>: {0: 0, 1: 10}\n",
+        os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, bell)
+{
+    auto result = this->run("bell.ll", 200);
+    std::smatch m;
+    std::regex const re(R"(qubit 0 experiment <null>: \{0: (\d+), 1: (\d+)\}
+qubit 1 experiment <null>: \{0: (\d+), 1: (\d+)\}
+)");
+    ASSERT_TRUE(std::regex_match(result, m, re)) << result;
+    // Outcomes are perfectly correlated
+    EXPECT_EQ(m[1], m[3]);
+    EXPECT_EQ(m[2], m[4]);
+    EXPECT_EQ(200, std::stoi(m[1]) + std::stoi(m[2]));
+    EXPECT_LT(50, std::stoi(m[1]));
+    EXPECT_LT(50, std::stoi(m[2]));
+
+    // All shots are drawn from a single final state
+    EXPECT_EQ(1, num_executions_);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, controlled)
+{
+    auto result = this->run("controlled.ll", 100);
+    EXPECT_EQ(R"(qubit 0 experiment <null>: {0: 0, 1: 100}
+qubit 1 experiment <null>: {0: 100, 1: 0}
+qubit 2 experiment <null>: {0: 100, 1: 0}
+qubit 3 experiment <null>: {0: 0, 1: 100}
+)",
+              result);
+    EXPECT_EQ(1, num_executions_);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, pauli_exp)
+{
+    auto result = this->run("pauli_exp.ll", 100);
+    EXPECT_EQ(R"(qubit 0 experiment <null>: {0: 0, 1: 100}
+qubit 1 experiment <null>: {0: 0, 1: 100}
+qubit 2 experiment <null>: {0: 0, 1: 100}
+qubit 3 experiment <null>: {0: 100, 1: 0}
+)",
+              result);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, assertions)
+{
+    auto result = this->run("assert.ll", 1000);
+    EXPECT_EQ(1, num_executions_);
+    EXPECT_EQ(R"(qubit 0 experiment <null>: {0: 496, 1: 504}
+qubit 1 experiment <null>: {0: 496, 1: 504}
+)",
+              result);
+
+    EXPECT_THROW(this->run("assert_fail.ll", 10), RuntimeError);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, assert_after_deferred)
+{
+    RuntimeObjects objects;
+    Array paulis = objects.array_create(sizeof(pauli_type), 1);
+    *static_cast<pauli_type*>(RuntimeObjects::array_element(paulis, 0))
+        = static_cast<pauli_type>(Pauli::z);
+    Array qubits = objects.array_create(sizeof(Qubit), 1);
+    *static_cast<Qubit*>(RuntimeObjects::array_element(qubits, 0))
+        = Qubit{1};
+
+    std::ostringstream os;
+    SimQuantum sim{os};
+    sim.set_up(make_attrs(2, 1));
+    sim.h(Qubit{0});
+    sim.cnot(Qubit{0}, Qubit{1});
+    sim.assertmeasurementprobability(
+        paulis, qubits, sim.result_get_zero(), 0.5, String{}, 1e-10);
+
+    // Measuring one half of the Bell pair determines the other
+    sim.mz(Qubit{0}, Result{0});
+    EXPECT_THROW(
+        sim.assertmeasurementprobability(
+            paulis, qubits, sim.result_get_zero(), 0.5, String{}, 1e-10),
+        RuntimeError);
+    QState const expected = sim.read_result(Result{0});
+    sim.assertmeasurementprobability(
+        paulis,
+        qubits,
+        expected == QState::zero ? sim.result_get_zero()
+                                 : sim.result_get_one(),
+        1.0,
+        String{},
+        1e-10);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, several_gates)
+{
+    auto result = this->run("pyqir_several_gates.ll", 10000);
+    EXPECT_EQ(1, num_executions_);
+
+    std::smatch m;
+    std::regex const re(R"(qubit 1 experiment <null>: \{0: (\d+), 1: (\d+)\})");
+    ASSERT_TRUE(std::regex_search(result, m, re)) << result;
+    EXPECT_EQ(10000, std::stoi(m[1]) + std::stoi(m[2]));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, teleport)
+{
+    // Teleported state is |0>
+    auto result = this->run("teleport.ll", 100);
+    EXPECT_NE(std::string::npos,
+              result.find("qubit 2 experiment <null>: {0: 100, 1: 0}"))
+        << result;
+    // Feedback requires one execution per measurement history
+    EXPECT_LE(num_executions_, 4);
+
+    // Without branching, each shot is executed separately
+    result = this->run("teleport.ll", 100, /* branch_shots = */ false);
+    EXPECT_NE(std::string::npos,
+              result.find("qubit 2 experiment <null>: {0: 100, 1: 0}"))
+        << result;
+    EXPECT_EQ(100, num_executions_);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, virtual_swap)
+{
+    // Results are labeled by the program's qubits, not the relabeled ones
+    auto result = this->run("swap.ll", 100);
+    EXPECT_NE(std::string::npos,
+              result.find("qubit 2 experiment <null>: {0: 0, 1: 100}"))
+        << result;
+    EXPECT_EQ(result, this->run("swap.ll", 100, true, /* vswap = */ true));
+    EXPECT_EQ(this->run("teleport.ll", 100),
+              this->run("teleport.ll", 100, true, /* vswap = */ true));
+
+    // Dynamically allocated results are labeled too
+    std::ostringstream os;
+    SimQuantum sim{os};
+    VirtualSwap vswap{sim};
+    vswap.set_up(make_attrs(2, 1));
+    vswap.x(Qubit{0});
+    vswap.swap(Qubit{0}, Qubit{1});
+    Result a = vswap.m(Qubit{1});
+    Result b = vswap.mresetz(Qubit{0});
+    EXPECT_EQ(QState::one, vswap.read_result(a));
+    EXPECT_EQ(QState::zero, vswap.read_result(b));
+    sim.array_record_output(2, nullptr);
+    sim.result_record_output(a, nullptr);
+    sim.result_record_output(b, nullptr);
+    vswap.tear_down();
+    EXPECT_EQ(
+        "qubit 1 experiment <null>: {0: 0, 1: 1}\n"
+        "qubit 0 experiment <null>: {0: 1, 1: 0}\n",
+        os.str());
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(SimQuantumTest, branching)
+{
+    using Q = Qubit;
+    using R = Result;
+
+    std::ostringstream os;
+    SimQuantum sim{os, 1000, 12345};
+    size_type num_executions = 0;
+    while (sim.remaining_shots() > 0)
+    {
+        sim.set_up(make_attrs(2, 2));
+        sim.h(Q{0});
+        sim.mz(Q{0}, R{0});
+        if (sim.read_result(R{0}) == QState::one)
+        {
+            sim.x(Q{1});
+        }
+        sim.h(Q{0});
+        sim.mz(Q{1}, R{1});
+        sim.result_record_output(R{1}, "b");
+        sim.tear_down();
+        ++num_executions;
+    }
+    // One execution per outcome of the mid-circuit measurement
+    EXPECT_EQ(2, num_executions);
+    EXPECT_EQ(0, sim.num_pending_branches());
+
+    std::smatch m;
+    std::string const result = os.str();
+    std::regex const re(R"(qubit 1 experiment b: \{0: (\d+), 1: (\d+)\}
+)");
+    ASSERT_TRUE(std::regex_match(result, m, re)) << result;
+    EXPECT_EQ(1000, std::stoi(m[1]) + std::stoi(m[2]));
+    EXPECT_LT(400, std::stoi(m[1]));
+    EXPECT_LT(400, std::stoi(m[2]));
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
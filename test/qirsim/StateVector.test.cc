@@ -0,0 +1,306 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirsim/StateVector.test.cc
+//---------------------------------------------------------------------------//
+#include "qirsim/StateVector.hh"
+
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+using value_type = StateVector::value_type;
+using VecValue = std::vector<value_type>;
+constexpr double pi = 3.141592653589793;
+
+class StateVectorTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    //! Dense matrix on (controls..., target) for a controlled 2x2 gate
+    static VecValue dense_controlled(size_type num_controls, VecValue const& m)
+    {
+        size_type const dim = size_type(2) << num_controls;
+        size_type const ctrl = (dim >> 1) - 1;
+        VecValue result(dim * dim);
+        for (size_type c = 0; c != dim; ++c)
+        {
+            if ((c & ctrl) != ctrl)
+            {
+                result[c * dim + c] = 1;
+                continue;
+            }
+            size_type const col_bit = c >> num_controls;
+            for (size_type row_bit : {0, 1})
+            {
+                size_type const r = (c & ctrl) | (row_bit << num_controls);
+                result[r * dim + c] = m[row_bit * 2 + col_bit];
+            }
+        }
+        return result;
+    }
+
+    //! Dense exp(i theta P) on (controls..., Pauli qubits...)
+    static VecValue dense_exp(size_type num_controls,
+                              std::string const& paulis,
+                              double theta)
+    {
+        size_type const num_qubits = num_controls + paulis.size();
+        size_type const dim = size_type(1) << num_qubits;
+        size_type const ctrl = (size_type(1) << num_controls) - 1;
+        VecValue result(dim * dim);
+        for (size_type c = 0; c != dim; ++c)
+        {
+            if ((c & ctrl) != ctrl)
+            {
+                result[c * dim + c] = 1;
+                continue;
+            }
+            // Apply cos(theta) + i sin(theta) P one qubit at a time
+            size_type r = c;
+            value_type p{0, std::sin(theta)};
+            for (size_type j = 0; j != paulis.size(); ++j)
+            {
+                size_type const bit = size_type(1) << (num_controls + j);
+                bool const set = c & bit;
+                switch (paulis[j])
+                {
+                    case 'X':
+                        r ^= bit;
+                        break;
+                    case 'Y':
+                        r ^= bit;
+                        p *= set ? value_type{0, -1} : value_type{0, 1};
+                        break;
+                    case 'Z':
+                        p *= set ? -1 : 1;
+                        break;
+                }
+            }
+            result[c * dim + c] += std::cos(theta);
+            result[r * dim + c] += p;
+        }
+        return result;
+    }
+
+    //! Prepare a nontrivial initial state
+    static void randomize(StateVector* state)
+    {
+        std::mt19937 rng(12345u);
+        std::normal_distribution<double> sample;
+        double norm = 0;
+        for (auto& a : state->amplitudes())
+        {
+            a = {sample(rng), sample(rng)};
+            norm += std::norm(a);
+        }
+        for (auto& a : state->amplitudes())
+        {
+            a /= std::sqrt(norm);
+        }
+    }
+};
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorTest, controlled)
+{
+    constexpr size_type num_qubits = 6;
+    value_type const i{0, 1};
+    std::vector<VecValue> const matrices{
+        {0, 1, 1, 0},  // X
+        {1, 0, 0, i},  // S (phase only)
+        {i, 0, 0, -i},  // diagonal
+        {0.6, -0.8, 0.8, 0.6},  // general
+    };
+    std::vector<std::vector<size_type>> const qubit_lists{
+        {3, 1},  // one control, target 1
+        {0, 5, 2},
+        {4, 0, 2, 3},
+        {5, 4, 3, 2, 1},
+    };
+
+    for (auto const& m : matrices)
+    {
+        for (auto const& qubits : qubit_lists)
+        {
+            StateVector expected(num_qubits);
+            StateVector actual(num_qubits);
+            randomize(&expected);
+            randomize(&actual);
+
+            size_type const num_controls = qubits.size() - 1;
+            auto dense = dense_controlled(num_controls, m);
+            expected.apply(qubits.data(), qubits.size(), dense.data());
+            actual.apply_controlled(
+                qubits.data(), num_controls, qubits.back(), m.data());
+
+            for (size_type j = 0; j != expected.size(); ++j)
+            {
+                EXPECT_NEAR(expected.amplitudes()[j].real(),
+                            actual.amplitudes()[j].real(),
+                            1e-12);
+                EXPECT_NEAR(expected.amplitudes()[j].imag(),
+                            actual.amplitudes()[j].imag(),
+                            1e-12);
+            }
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorTest, exp_pauli)
+{
+    constexpr size_type num_qubits = 6;
+    struct Case
+    {
+        std::vector<size_type> controls;
+        std::string paulis;
+        std::vector<size_type> qubits;
+    };
+    std::vector<Case> const cases{
+        {{}, "X", {3}},
+        {{}, "XZ", {2, 0}},
+        {{}, "YYZ", {1, 3, 4}},
+        {{}, "ZZ", {0, 5}},
+        {{}, "IXY", {5, 0, 2}},
+        {{4}, "Y", {1}},
+        {{1, 3}, "ZX", {0, 5}},
+        {{0, 2}, "ZZI", {1, 4, 5}},
+    };
+
+    for (auto const& c : cases)
+    {
+        size_type x_mask = 0;
+        size_type z_mask = 0;
+        size_type ctl_mask = 0;
+        std::vector<size_type> qubits = c.controls;
+        for (size_type j = 0; j != c.paulis.size(); ++j)
+        {
+            size_type const bit = size_type(1) << c.qubits[j];
+            x_mask |= (c.paulis[j] == 'X' || c.paulis[j] == 'Y') ? bit : 0;
+            z_mask |= (c.paulis[j] == 'Z' || c.paulis[j] == 'Y') ? bit : 0;
+            qubits.push_back(c.qubits[j]);
+        }
+        for (size_type q : c.controls)
+        {
+            ctl_mask |= size_type(1) << q;
+        }
+
+        StateVector expected(num_qubits);
+        StateVector actual(num_qubits);
+        randomize(&expected);
+        randomize(&actual);
+
+        double const theta = 0.7;
+        auto dense = dense_exp(c.controls.size(), c.paulis, theta);
+        expected.apply(qubits.data(), qubits.size(), dense.data());
+        actual.exp_pauli(x_mask, z_mask, theta, ctl_mask);
+
+        for (size_type j = 0; j != expected.size(); ++j)
+        {
+            EXPECT_NEAR(expected.amplitudes()[j].real(),
+                        actual.amplitudes()[j].real(),
+                        1e-12)
+                << c.paulis;
+            EXPECT_NEAR(expected.amplitudes()[j].imag(),
+                        actual.amplitudes()[j].imag(),
+                        1e-12)
+                << c.paulis;
+        }
+    }
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorTest, expectation_pauli)
+{
+    constexpr size_type num_qubits = 5;
+    struct Case
+    {
+        std::string paulis;
+        std::vector<size_type> qubits;
+    };
+    std::vector<Case> const cases{
+        {"Z", {3}},
+        {"X", {0}},
+        {"XZ", {2, 0}},
+        {"YYZ", {1, 3, 4}},
+        {"ZZ", {0, 4}},
+        {"IXY", {4, 0, 2}},
+    };
+
+    StateVector state(num_qubits);
+    randomize(&state);
+    for (auto const& c : cases)
+    {
+        size_type x_mask = 0;
+        size_type z_mask = 0;
+        for (size_type j = 0; j != c.paulis.size(); ++j)
+        {
+            size_type const bit = size_type(1) << c.qubits[j];
+            x_mask |= (c.paulis[j] == 'X' || c.paulis[j] == 'Y') ? bit : 0;
+            z_mask |= (c.paulis[j] == 'Z' || c.paulis[j] == 'Y') ? bit : 0;
+        }
+
+        // <psi|P|psi> = -i <psi|exp(i pi/2 P)|psi>
+        StateVector applied = state;
+        auto dense = dense_exp(0, c.paulis, pi / 2);
+        applied.apply(c.qubits.data(), c.qubits.size(), dense.data());
+        value_type overlap{0};
+        for (size_type j = 0; j != state.size(); ++j)
+        {
+            overlap += std::conj(state.amplitudes()[j])
+                       * applied.amplitudes()[j];
+        }
+        EXPECT_NEAR(overlap.imag(),
+                    state.expectation_pauli(x_mask, z_mask),
+                    1e-12)
+            << c.paulis;
+    }
+
+    // Eigenstates
+    StateVector zero(2);
+    EXPECT_DOUBLE_EQ(1, zero.expectation_pauli(0, 0b11));
+    EXPECT_DOUBLE_EQ(0, zero.expectation_pauli(0b01, 0));
+    zero.apply({0}, dense_exp(0, "Y", pi / 4).data());
+    EXPECT_NEAR(-1, zero.expectation_pauli(0b01, 0), 1e-15);
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorTest, expectation_threads)
+{
+    // Several reduction chunks
+    StateVector state(18);
+    randomize(&state);
+    double const serial = state.expectation_pauli(0b101001, 0b1100, 1);
+    EXPECT_EQ(serial, state.expectation_pauli(0b101001, 0b1100, 3));
+    EXPECT_EQ(serial, state.expectation_pauli(0b101001, 0b1100, 0));
+}
+
+//---------------------------------------------------------------------------//
+TEST_F(StateVectorTest, toffoli)
+{
+    // |000> -> |011> without controls, then |111> with two controls
+    StateVector state(3);
+    value_type const x[] = {0, 1, 1, 0};
+    size_type const ctls[] = {0, 1};
+    state.apply_controlled(nullptr, 0, 0, x);
+    state.apply_controlled(nullptr, 0, 1, x);
+    state.apply_controlled(ctls, 2, 2, x);
+    EXPECT_EQ(value_type{1}, state.amplitudes()[0b111]);
+    EXPECT_EQ(value_type{0}, state.amplitudes()[0b011]);
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree
@@ -7,7 +7,9 @@
 //---------------------------------------------------------------------------//
 #include "qirxacc/XaccQuantum.hh"
 
+#include <cstdint>
 #include <regex>
+#include <sstream>
 
 #include "qiree/Types.hh"
 #include "qiree_test.hh"
@@ -31,6 +33,36 @@ class XaccQuantumTest : public ::qiree::test::Test
         result = std::regex_replace(result, subs_ptr, "0x0");
         return result;
     }
+
+    //! Measure three qubits in superposition with shots split across workers
+    static std::string run_workers(std::uint64_t seed)
+    {
+        std::ostringstream os;
+        XaccQuantum::Options opts;
+        opts.shots = 1000;
+        opts.num_workers = 4;
+        opts.seed = seed;
+        opts.output_format = ResultFormat::jsonl;
+        XaccQuantum xacc_sim{os, "qpp", opts};
+        EXPECT_EQ(4, xacc_sim.num_workers());
+
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = 3;
+        attrs.required_num_results = 3;
+        xacc_sim.set_up(attrs);
+        for (size_type i = 0; i != 3; ++i)
+        {
+            xacc_sim.h(Qubit{i});
+            xacc_sim.mz(Qubit{i}, Result{i});
+        }
+        xacc_sim.array_record_output(3, nullptr);
+        for (size_type i = 0; i != 3; ++i)
+        {
+            xacc_sim.result_record_output(Result{i}, nullptr);
+        }
+        xacc_sim.tear_down();
+        return os.str();
+    }
 };
 
 // Use "death test" to list compilers and accelerators since xacc calls
@@ -98,6 +130,195 @@ qubit 0 experiment tag: {0: 0, 1: 0}
         << result;
 }
 
+TEST_F(XaccQuantumTest, several_arrays)
+{
+    // Count occurrences of a substring
+    auto count = [](std::string const& s, std::string const& sub) {
+        size_type result = 0;
+        for (auto pos = s.find(sub); pos != std::string::npos;
+             pos = s.find(sub, pos + 1))
+        {
+            ++result;
+        }
+        return result;
+    };
+
+    for (size_type batch_size : {1, 2})
+    {
+        std::ostringstream os;
+        XaccQuantum::Options opts;
+        opts.shots = 10;
+        opts.batch_size = batch_size;
+        opts.output_format = ResultFormat::jsonl;
+        XaccQuantum xacc_sim{os, "qpp", opts};
+
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = 2;
+        attrs.required_num_results = 2;
+        for (int i = 0; i != 2; ++i)
+        {
+            // Each execution records its results in two arrays
+            xacc_sim.set_up(attrs);
+            xacc_sim.x(Qubit{1});
+            xacc_sim.mz(Qubit{0}, Result{0});
+            xacc_sim.mz(Qubit{1}, Result{1});
+            xacc_sim.array_record_output(1, nullptr);
+            xacc_sim.result_record_output(Result{0}, nullptr);
+            xacc_sim.array_record_output(1, nullptr);
+            xacc_sim.result_record_output(Result{1}, nullptr);
+            xacc_sim.tear_down();
+        }
+        xacc_sim.flush();
+
+        std::string const result = os.str();
+        EXPECT_EQ(2, count(result, R"("type":"begin")")) << result;
+        EXPECT_EQ(4, count(result, R"("type":"result")")) << result;
+        EXPECT_EQ(2, count(result, R"("type":"end")")) << result;
+    }
+}
+
+TEST_F(XaccQuantumTest, flush_on_destruction)
+{
+    std::ostringstream os;
+    {
+        XaccQuantum::Options opts;
+        opts.shots = 10;
+        opts.batch_size = 4;
+        opts.output_format = ResultFormat::jsonl;
+        XaccQuantum xacc_sim{os, "qpp", opts};
+
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = 1;
+        attrs.required_num_results = 1;
+        xacc_sim.set_up(attrs);
+        xacc_sim.x(Qubit{0});
+        xacc_sim.mz(Qubit{0}, Result{0});
+        xacc_sim.array_record_output(1, nullptr);
+        xacc_sim.result_record_output(Result{0}, nullptr);
+        xacc_sim.tear_down();
+
+        // The execution is still queued
+        EXPECT_EQ("", os.str());
+    }
+    EXPECT_NE(std::string::npos, os.str().find(R"("type":"result")"))
+        << os.str();
+}
+
+TEST_F(XaccQuantumTest, workers)
+{
+    // Worker accelerators are independent instances (checked on
+    // construction) whose merged counts include every shot
+    std::string const first = run_workers(12345);
+    std::regex const counts_re(R"re("counts":\[(\d+),(\d+)\])re");
+    size_type num_records = 0;
+    for (std::sregex_iterator iter(first.begin(), first.end(), counts_re), end;
+         iter != end;
+         ++iter)
+    {
+        auto const& m = *iter;
+        EXPECT_EQ(1000, std::stoi(m[1]) + std::stoi(m[2])) << first;
+        EXPECT_LT(0, std::stoi(m[1])) << first;
+        EXPECT_LT(0, std::stoi(m[2])) << first;
+        ++num_records;
+    }
+    EXPECT_EQ(3, num_records) << first;
+
+    // Each worker's seed is honored even though the workers execute
+    // concurrently, so a seed reproduces the counts
+    EXPECT_EQ(first, run_workers(12345));
+    EXPECT_NE(first, run_workers(54321));
+}
+
+TEST_F(XaccQuantumTest, worker_cache)
+{
+    // Each worker gets its own copy of a circuit, and the copies are cached
+    // together so that a repeated batch builds nothing
+    std::ostringstream os;
+    XaccQuantum::Options opts;
+    opts.shots = 100;
+    opts.num_workers = 2;
+    opts.batch_size = 2;
+    opts.output_format = ResultFormat::jsonl;
+    XaccQuantum xacc_sim{os, "qpp", opts};
+
+    EntryPointAttrs attrs;
+    attrs.required_num_qubits = 1;
+    attrs.required_num_results = 1;
+    for (int i = 0; i != 4; ++i)
+    {
+        xacc_sim.set_up(attrs);
+        xacc_sim.h(Qubit{0});
+        xacc_sim.mz(Qubit{0}, Result{0});
+        xacc_sim.array_record_output(1, nullptr);
+        xacc_sim.result_record_output(Result{0}, nullptr);
+        xacc_sim.tear_down();
+    }
+    xacc_sim.flush();
+
+    EXPECT_EQ(1, xacc_sim.cache_counters().misses);
+    EXPECT_EQ(3, xacc_sim.cache_counters().hits);
+
+    std::string const result = os.str();
+    std::regex const counts_re(R"re("counts":\[(\d+),(\d+)\])re");
+    size_type num_records = 0;
+    std::sregex_iterator iter(result.begin(), result.end(), counts_re);
+    for (; iter != std::sregex_iterator{}; ++iter)
+    {
+        auto const& m = *iter;
+        EXPECT_EQ(100, std::stoi(m[1]) + std::stoi(m[2])) << result;
+        ++num_records;
+    }
+    EXPECT_EQ(4, num_records) << result;
+}
+
+TEST_F(XaccQuantumTest, wide_register)
+{
+    // Outcomes wider than a histogram key are tallied bit by bit; the
+    // Clifford circuit lets a stabilizer method simulate all the qubits
+    constexpr size_type num_qubits = 70;
+    for (size_type num_workers : {1, 2})
+    {
+        std::ostringstream os;
+        XaccQuantum::Options opts;
+        opts.shots = 100;
+        opts.num_workers = num_workers;
+        opts.per_shot = true;
+        opts.output_format = ResultFormat::jsonl;
+        XaccQuantum xacc_sim{os, "aer", opts};
+
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = num_qubits;
+        attrs.required_num_results = num_qubits;
+        xacc_sim.set_up(attrs);
+        for (size_type i = 0; i != num_qubits; ++i)
+        {
+            xacc_sim.h(Qubit{i});
+            xacc_sim.mz(Qubit{i}, Result{i});
+        }
+        xacc_sim.array_record_output(num_qubits, nullptr);
+        for (size_type i = 0; i != num_qubits; ++i)
+        {
+            xacc_sim.result_record_output(Result{i}, nullptr);
+        }
+        xacc_sim.tear_down();
+
+        std::string const result = os.str();
+        std::regex const counts_re(R"re("counts":\[(\d+),(\d+)\])re");
+        size_type num_records = 0;
+        std::sregex_iterator iter(result.begin(), result.end(), counts_re);
+        for (; iter != std::sregex_iterator{}; ++iter)
+        {
+            auto const& m = *iter;
+            EXPECT_EQ(100, std::stoi(m[1]) + std::stoi(m[2])) << result;
+            ++num_records;
+        }
+        EXPECT_EQ(num_qubits, num_records) << result;
+        EXPECT_NE(std::string::npos,
+                  result.find(R"("num_shots":100,"num_bits":70)"))
+            << result;
+    }
+}
+
 //---------------------------------------------------------------------------//
 }  // namespace test
 }  // namespace qiree
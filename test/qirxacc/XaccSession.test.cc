@@ -0,0 +1,138 @@
+//----------------------------------*-C++-*----------------------------------//
+// Copyright 2024 UT-Battelle, LLC, and other QIR-EE developers.
+// See the top-level COPYRIGHT file for details.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//---------------------------------------------------------------------------//
+//! \file qirxacc/XaccSession.test.cc
+//---------------------------------------------------------------------------//
+#include "qirxacc/XaccSession.hh"
+
+#include <cstdlib>
+#include <sstream>
+
+#include "qiree/Assert.hh"
+#include "qirxacc/XaccQuantum.hh"
+#include "qiree_test.hh"
+
+namespace qiree
+{
+namespace test
+{
+//---------------------------------------------------------------------------//
+
+class XaccSessionTest : public ::qiree::test::Test
+{
+  protected:
+    void SetUp() override {}
+
+    static EntryPointAttrs make_attrs(size_type num_qubits)
+    {
+        EntryPointAttrs attrs;
+        attrs.required_num_qubits = num_qubits;
+        attrs.required_num_results = num_qubits;
+        return attrs;
+    }
+};
+
+TEST_F(XaccSessionTest, buffers)
+{
+    auto& session = XaccSession::instance();
+    auto const initial = session.counters();
+
+    auto first = session.acquire_buffer(2);
+    auto* const first_ptr = first.get();
+    auto other = session.acquire_buffer(3);
+    session.release_buffer(std::move(first));
+    EXPECT_FALSE(first);
+
+    // Same width reuses the released buffer
+    auto second = session.acquire_buffer(2);
+    EXPECT_EQ(first_ptr, second.get());
+
+    // Releasing twice pools the buffer only once
+    auto copy = second;
+    session.release_buffer(std::move(second));
+    session.release_buffer(copy);
+    auto third = session.acquire_buffer(2);
+    EXPECT_EQ(first_ptr, third.get());
+    EXPECT_NE(third.get(), session.acquire_buffer(2).get());
+
+    auto const counters = session.counters();
+    EXPECT_EQ(3u, counters.buffers_created - initial.buffers_created);
+    EXPECT_EQ(2u, counters.buffers_reused - initial.buffers_reused);
+}
+
+TEST_F(XaccSessionTest, accelerators)
+{
+    auto& session = XaccSession::instance();
+    auto provider = session.ir_provider("quantum");
+    EXPECT_TRUE(provider);
+    EXPECT_EQ(provider, session.ir_provider("quantum"));
+
+    auto accel = session.acquire_accelerator("qsim");
+    ASSERT_TRUE(accel);
+    auto* const accel_ptr = accel.get();
+    session.release_accelerator("qsim", accel);
+    session.release_accelerator("qsim", std::move(accel));
+    EXPECT_EQ(accel_ptr, session.acquire_accelerator("qsim").get());
+    EXPECT_ANY_THROW(session.acquire_accelerator("not-an-accelerator"));
+    EXPECT_THROW(XaccQuantum::xacc_init({}), RuntimeError);
+}
+
+TEST_F(XaccSessionTest, repeated_instances)
+{
+    // Constructing and running several simulators reuses the accelerator
+    // and buffer instead of reinitializing XACC
+    auto const initial = XaccSession::instance().counters();
+    for (int i = 0; i != 3; ++i)
+    {
+        std::ostringstream os;
+        XaccQuantum xacc_sim{os};
+        xacc_sim.set_up(make_attrs(1));
+        xacc_sim.h(Qubit{0});
+        xacc_sim.mz(Qubit{0}, Result{0});
+        xacc_sim.array_record_output(1, nullptr);
+        xacc_sim.result_record_output(Result{0}, nullptr);
+        xacc_sim.tear_down();
+        EXPECT_NE(std::string::npos, os.str().find("qubit 0 experiment"));
+    }
+    auto const counters = XaccSession::instance().counters();
+    EXPECT_LE(counters.accelerators_created - initial.accelerators_created,
+              1u);
+    EXPECT_GE(counters.accelerators_reused - initial.accelerators_reused,
+              2u);
+    EXPECT_GE(counters.buffers_reused - initial.buffers_reused, 2u);
+}
+
+// Plugins are chosen when XACC starts, so run in a freshly started process
+using XaccSessionDeathTest = XaccSessionTest;
+
+TEST_F(XaccSessionDeathTest, restricted_plugins)
+{
+    ::testing::GTEST_FLAG(death_test_style) = "threadsafe";
+    EXPECT_EXIT(
+        {
+            auto& session = XaccSession::instance();
+            session.start({}, {{"qsim"}, {"quantum"}});
+            session.wait();
+            // The named accelerator was created during startup
+            session.acquire_accelerator("qsim");
+            if (session.counters().accelerators_reused != 1)
+                std::exit(1);
+            try
+            {
+                session.acquire_accelerator("qpp");
+            }
+            catch (RuntimeError const&)
+            {
+                std::exit(0);
+            }
+            std::exit(2);
+        },
+        testing::ExitedWithCode(0),
+        "");
+}
+
+//---------------------------------------------------------------------------//
+}  // namespace test
+}  // namespace qiree